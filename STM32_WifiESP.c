@@ -9,6 +9,8 @@
  * Ce fichier source contient l’implémentation des fonctions bas niveau pour le module ESP01 :
  *   - Initialisation et configuration UART (DMA, IT)
  *   - Gestion des commandes AT (envoi, réception, parsing)
+ *   - Pipeline d'émission AT+CIPSEND ("SEND OK" apparié de façon asynchrone)
+ *   - Écriture JSON en flux (réponses HTTP chunked, messages MQTT)
  *   - Gestion du terminal série (console AT interactive)
  *   - Fonctions utilitaires : reset, restore, logs, gestion du mode sommeil, puissance RF, etc.
  *   - Statistiques d’utilisation et gestion des erreurs
@@ -36,6 +38,41 @@ uint8_t *g_dma_rx_buf = NULL;            // Buffer DMA pour réception UART
 uint16_t g_dma_buf_size = 0;             // Taille du buffer DMA RX
 volatile uint16_t g_rx_last_pos = 0;     // Dernière position lue dans le buffer DMA RX
 uint16_t g_server_port = 80;             // Port par défaut du serveur HTTP
+esp01_send_stats_t g_send_stats = {0};   // Statistiques du pipeline d'émission
+esp01_uart_stats_t g_uart_stats = {0};   // Octets échangés sur la liaison série
+
+// === Pipeline d'émission (AT+CIPSEND) ===
+#define ESP01_SEND_EVT_PROMPT 0x01 // ">" reçu
+#define ESP01_SEND_EVT_BUSY 0x02   // "busy p..." reçu
+#define ESP01_SEND_EVT_ERROR 0x04  // "ERROR" reçu
+#define ESP01_SEND_EVT_DONE 0x08   // "SEND OK"/"SEND FAIL" reçu
+
+/**
+ * @brief Envoi transmis à l'ESP01, en attente de "SEND OK"/"SEND FAIL".
+ */
+typedef struct
+{
+    int8_t link;    // Lien (-1 : mono-connexion)
+    uint16_t seg;   // Numéro de segment AT+CIPSENDBUF (0 : AT+CIPSEND, confirmé dans l'ordre)
+    uint16_t len;   // Octets envoyés
+    uint32_t start; // Timestamp de transmission
+} esp01_send_slot_t;
+
+static esp01_send_slot_t g_send_slots[ESP01_SEND_MAX_INFLIGHT]; // Envois en vol, du plus ancien au plus récent
+static uint8_t g_send_count = 0;                                // Envois en vol
+static volatile uint8_t g_send_events = 0;                      // Évènements reçus (ESP01_SEND_EVT_*)
+static bool g_send_wait_prompt = false;                         // AT+CIPSEND en attente de ">"
+static bool g_send_buffered = false;                            // Commande en cours : AT+CIPSENDBUF
+static uint16_t g_send_seg = 0;                                 // Numéro de segment annoncé avant ">"
+static esp01_rx_pump_t g_send_pump = NULL;                      // Lecture RX du module émetteur
+static esp01_link_count_t g_rx_owner_links = NULL;              // Liens ouverts du module propriétaire du flux RX
+static esp01_rx_pump_t g_rx_owner_pump = NULL;                  // Lecture RX de ce module
+static char *g_raw_capture = NULL;                              // Réponse d'une commande brute lue par g_rx_owner_pump
+static size_t g_raw_capture_size = 0;                           // Taille de ce buffer
+static size_t g_raw_capture_len = 0;                            // Octets déjà reçus
+
+static bool _esp01_rx_owned(void);                        // Liens ouverts : flux RX lu par leur module
+static void _esp01_flush_rx_if_idle(uint32_t timeout_ms); // Vidage RX avant une commande brute, sauf liens ouverts
 
 // === Variables terminal AT ===
 volatile uint8_t esp_console_rx_flag = 0;                   // Indicateur de réception d'un caractère dans le terminal AT
@@ -113,9 +150,9 @@ ESP01_Status_t esp01_test_at(void)
  */
 ESP01_Status_t esp01_reset(void)
 {
-    esp01_flush_rx_buffer(10); // Vide le buffer RX avant d'envoyer la commande
+    _esp01_flush_rx_if_idle(10); // Vide le buffer RX avant d'envoyer la commande
 
-    HAL_UART_Transmit(g_esp_uart, (uint8_t *)"AT+RST\r\n", 8, HAL_MAX_DELAY); // Envoie la commande AT+RST pour reset
+    esp01_uart_write("AT+RST\r\n", 8); // Envoie la commande AT+RST pour reset
 
     uint32_t start = HAL_GetTick();      // Timestamp de départ pour le timeout
     char resp[ESP01_MAX_RESP_BUF] = {0}; // Buffer pour la réponse complète
@@ -166,9 +203,9 @@ ESP01_Status_t esp01_reset(void)
  */
 ESP01_Status_t esp01_restore(void)
 {
-    esp01_flush_rx_buffer(10); // Vide le buffer RX avant d'envoyer la commande
+    _esp01_flush_rx_if_idle(10); // Vide le buffer RX avant d'envoyer la commande
 
-    HAL_UART_Transmit(g_esp_uart, (uint8_t *)"AT+RESTORE\r\n", 12, HAL_MAX_DELAY); // Envoie la commande AT+RESTORE
+    esp01_uart_write("AT+RESTORE\r\n", 12); // Envoie la commande AT+RESTORE
 
     uint32_t start = HAL_GetTick();      // Timestamp de départ pour le timeout
     char resp[ESP01_MAX_RESP_BUF] = {0}; // Buffer pour la réponse complète
@@ -729,8 +766,8 @@ ESP01_Status_t esp01_get_cmd_list(char *out, size_t out_size)
     char line[ESP01_MAX_RESP_BUF];  // Tampon pour une ligne de réponse
     size_t line_len = 0;            // Longueur de la ligne courante
 
-    esp01_flush_rx_buffer(100);                                                // Vide le buffer RX avant d'envoyer la commande
-    HAL_UART_Transmit(g_esp_uart, (uint8_t *)"AT+CMD?\r\n", 9, HAL_MAX_DELAY); // Envoie la commande AT+CMD?
+    _esp01_flush_rx_if_idle(100);                                              // Vide le buffer RX avant d'envoyer la commande
+    esp01_uart_write("AT+CMD?\r\n", 9); // Envoie la commande AT+CMD?
 
     // Lecture de la réponse ligne par ligne jusqu'à "OK" ou timeout
     while ((HAL_GetTick() - start) < 30000 && total_len < out_size - 1) // début while : lecture de la réponse
@@ -839,6 +876,42 @@ ESP01_Status_t esp01_flush_rx_buffer(uint32_t timeout_ms)
     return ESP01_OK;          // Retourne OK si le buffer a été vidé
 }
 
+/**
+ * @brief  Indique si le flux RX appartient au module qui sert des liens ouverts.
+ * @retval true si des liens sont ouverts (trames +IPD possibles dans le flux).
+ */
+static bool _esp01_rx_owned(void)
+{
+    return g_rx_owner_links && g_rx_owner_pump && g_rx_owner_links() > 0;
+}
+
+/**
+ * @brief  Vide le flux RX avant une commande AT brute, sauf si des liens sont ouverts.
+ * @param  timeout_ms Durée de silence attendue (ms).
+ * @note   Avec des liens ouverts, le flux peut contenir des trames +IPD d'autres
+ *         clients : elles restent dans le buffer DMA pour le module qui les sert.
+ */
+static void _esp01_flush_rx_if_idle(uint32_t timeout_ms)
+{
+    if (_esp01_rx_owned())
+    {
+        ESP01_LOG_DEBUG("RX", "Liens ouverts : flux RX conservé");
+        return;
+    }
+    esp01_flush_rx_buffer(timeout_ms);
+}
+
+/**
+ * @brief  Déclare le module qui lit le flux RX tant que des liens sont ouverts.
+ * @param  links Nombre de liens ouverts (NULL : aucun propriétaire).
+ * @param  pump  Lecture du flux RX du module.
+ */
+void esp01_set_rx_owner(esp01_link_count_t links, esp01_rx_pump_t pump)
+{
+    g_rx_owner_links = links;
+    g_rx_owner_pump = pump;
+}
+
 int esp01_get_new_data(uint8_t *buf, uint16_t bufsize)
 {
     VALIDATE_PARAM(buf && bufsize > 0 && g_dma_rx_buf && g_dma_buf_size > 0, -1); // Vérifie la validité des paramètres et du contexte DMA
@@ -860,13 +933,36 @@ int esp01_get_new_data(uint8_t *buf, uint16_t bufsize)
         for (int i = 0; i < len; i++) // Copie les nouveaux octets dans le buffer utilisateur
             buf[i] = g_dma_rx_buf[(g_rx_last_pos + i) % g_dma_buf_size];
 
-        g_rx_last_pos = pos; // Met à jour la dernière position lue
+        g_rx_last_pos = (g_rx_last_pos + len) % g_dma_buf_size; // Avance jusqu'au dernier octet copié (le reste sera lu au prochain appel)
+        g_uart_stats.rx_bytes += (uint32_t)len;
 
         return len; // Retourne le nombre d'octets copiés
     }
     return 0; // Aucun nouvel octet à lire
 }
 
+/**
+ * @brief Écrit des octets vers l'ESP01 et les compte dans g_uart_stats.
+ */
+ESP01_Status_t esp01_uart_write(const void *data, size_t len)
+{
+    VALIDATE_PARAM(g_esp_uart && (data || len == 0) && len <= UINT16_MAX, ESP01_INVALID_PARAM); // HAL : taille sur 16 bits
+    if (len == 0)
+    {
+        return ESP01_OK;
+    }
+    g_uart_stats.tx_bytes += (uint32_t)len;
+    return HAL_UART_Transmit(g_esp_uart, (uint8_t *)data, (uint16_t)len, HAL_MAX_DELAY) == HAL_OK ? ESP01_OK : ESP01_FAIL;
+}
+
+/**
+ * @brief Débit maximal de la liaison série, d'après la configuration de l'UART.
+ */
+uint32_t esp01_uart_capacity(void)
+{
+    return g_esp_uart ? g_esp_uart->Init.BaudRate / 10U : 0; // 1 bit de start + 8 bits + 1 bit de stop
+}
+
 // ========================= OUTILS DE PARSING =========================
 
 /**
@@ -1190,7 +1286,16 @@ ESP01_Status_t esp01_send_raw_command_dma(const char *cmd, char *response_buffer
 {
     VALIDATE_PARAM(cmd && response_buffer && response_buf_size > 0, ESP01_INVALID_PARAM); // Vérifie les paramètres
 
-    esp01_flush_rx_buffer(10); // Vide le buffer RX avant d'envoyer
+    if (esp01_send_pending() > 0)             // Un AT+CIPSEND attend encore "SEND OK"
+    {
+        esp01_send_wait_idle(ESP01_TIMEOUT_LONG); // Sinon la commande serait refusée ("busy")
+    }
+
+    bool owned = _esp01_rx_owned(); // Liens ouverts : réponse lue par le module propriétaire du flux RX
+    if (!owned)
+    {
+        esp01_flush_rx_buffer(10); // Vide le buffer RX avant d'envoyer
+    }
 
     ESP01_LOG_DEBUG("RAWCMD", "Commande envoyée : %s", cmd); // Log la commande envoyée
 
@@ -1200,14 +1305,31 @@ ESP01_Status_t esp01_send_raw_command_dma(const char *cmd, char *response_buffer
         return ESP01_NOT_INITIALIZED;                                                                          // Retourne erreur
     }
 
-    HAL_UART_Transmit(g_esp_uart, (uint8_t *)cmd, strlen(cmd), HAL_MAX_DELAY); // Envoie la commande AT
-    HAL_UART_Transmit(g_esp_uart, (uint8_t *)"\r\n", 2, HAL_MAX_DELAY);        // Envoie CRLF
+    esp01_uart_write(cmd, strlen(cmd)); // Envoie la commande AT
+    esp01_uart_write("\r\n", 2);        // Envoie CRLF
 
     uint32_t start = HAL_GetTick(); // Timestamp de départ
     size_t resp_len = 0;            // Longueur de la réponse reçue
     response_buffer[0] = '\0';      // Initialise le buffer de réponse
 
-    while ((HAL_GetTick() - start) < timeout_ms && resp_len < response_buf_size - 1) // Boucle jusqu'à timeout ou buffer plein
+    if (owned) // Trames +IPD laissées aux liens, lignes AT recopiées par esp01_send_on_line()
+    {
+        g_raw_capture = response_buffer;
+        g_raw_capture_size = response_buf_size;
+        g_raw_capture_len = 0;
+        while ((HAL_GetTick() - start) < timeout_ms && g_raw_capture_len < response_buf_size - 1 &&
+               !(expected && strstr(response_buffer, expected)))
+        {
+            size_t before = g_raw_capture_len;
+            g_rx_owner_pump();
+            if (g_raw_capture_len == before)
+            {
+                HAL_Delay(1); // Petite pause CPU
+            }
+        }
+        g_raw_capture = NULL;
+    }
+    while (!owned && (HAL_GetTick() - start) < timeout_ms && resp_len < response_buf_size - 1) // Boucle jusqu'à timeout ou buffer plein
     {
         uint8_t buf[ESP01_SMALL_BUF_SIZE];              // Buffer temporaire pour lecture
         int len = esp01_get_new_data(buf, sizeof(buf)); // Récupère les nouveaux octets reçus
@@ -1260,6 +1382,811 @@ void esp01_trim_string(char *str) // Fonction pour supprimer les espaces en déb
         str[--len] = '\0';                                  // Remplace l'espace par un caractère de fin de chaîne
 }
 
+// ========================= PIPELINE D'ÉMISSION (AT+CIPSEND) =========================
+
+/**
+ * @brief  Retire un envoi du pipeline (les suivants gardent leur ordre).
+ * @param  index Position de l'envoi (0 : le plus ancien).
+ * @retval Envoi retiré.
+ */
+static esp01_send_slot_t _esp01_send_remove(uint8_t index)
+{
+    esp01_send_slot_t slot = g_send_slots[index];
+    g_send_count--;
+    memmove(&g_send_slots[index], &g_send_slots[index + 1], (g_send_count - index) * sizeof(g_send_slots[0]));
+    return slot;
+}
+
+/**
+ * @brief  Cherche l'envoi confirmé par une ligne "SEND OK"/"SEND FAIL".
+ * @param  prefix     Préfixe de la ligne : "" (AT+CIPSEND), "<segment>," ou "<lien>,<segment>," (AT+CIPSENDBUF).
+ * @param  prefix_len Longueur du préfixe.
+ * @retval Position de l'envoi, -1 si aucun envoi n'est en vol.
+ * @note   Un numéro de segment inconnu confirme le plus ancien envoi du lien.
+ */
+static int _esp01_send_find(const char *prefix, size_t prefix_len)
+{
+    if (g_send_count == 0) // Confirmation d'un envoi hors pipeline
+    {
+        return -1;
+    }
+    if (prefix_len == 0) // AT+CIPSEND : confirmations dans l'ordre
+    {
+        for (uint8_t i = 0; i < g_send_count; i++)
+        {
+            if (g_send_slots[i].seg == 0)
+            {
+                return i;
+            }
+        }
+        return 0;
+    }
+    char *end = NULL;
+    long first = strtol(prefix, &end, 10);
+    int link = -1;
+    long seg = first;
+    if (*end == ',' && end + 1 < prefix + prefix_len) // "<lien>,<segment>,"
+    {
+        link = (int)first;
+        seg = strtol(end + 1, NULL, 10);
+    }
+    int oldest = -1; // Plus ancien envoi du lien
+    for (uint8_t i = 0; i < g_send_count; i++)
+    {
+        if (g_send_slots[i].link != link)
+        {
+            continue;
+        }
+        if (g_send_slots[i].seg == (uint16_t)seg)
+        {
+            return i;
+        }
+        if (oldest < 0)
+        {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+/**
+ * @brief  Abandonne les envois restés sans confirmation trop longtemps.
+ * @retval Aucun
+ */
+static void _esp01_send_expire(void)
+{
+    while (g_send_count > 0 && (HAL_GetTick() - g_send_slots[0].start) >= ESP01_TIMEOUT_LONG)
+    {
+        esp01_send_slot_t slot = _esp01_send_remove(0);
+        g_send_stats.timeouts++;
+        ESP01_LOG_WARN("SEND", "Pas de confirmation pour %u octets sur le lien %d", slot.len, slot.link); // Log l'expiration
+    }
+}
+
+/**
+ * @brief  Attend que le nombre d'envois en vol passe sous un seuil.
+ * @param  max        Seuil (strict).
+ * @param  timeout_ms Timeout en ms.
+ * @retval ESP01_OK ou ESP01_TIMEOUT.
+ */
+static ESP01_Status_t _esp01_send_wait_below(uint8_t max, uint32_t timeout_ms)
+{
+    uint32_t start = HAL_GetTick(); // Timestamp de départ
+    for (;;)
+    {
+        _esp01_send_expire();
+        if (g_send_count < max)
+        {
+            return ESP01_OK;
+        }
+        if ((HAL_GetTick() - start) >= timeout_ms)
+        {
+            return ESP01_TIMEOUT;
+        }
+        g_send_pump(); // Lit le flux RX ("SEND OK" attendu)
+        HAL_Delay(1);  // Petite pause CPU
+    }
+}
+
+/**
+ * @brief  Attend un évènement de la commande AT+CIPSEND en cours.
+ * @param  mask       Évènements attendus (ESP01_SEND_EVT_*).
+ * @param  timeout_ms Timeout en ms.
+ * @retval ESP01_OK si un évènement du masque est arrivé, ESP01_TIMEOUT sinon.
+ */
+static ESP01_Status_t _esp01_send_wait_event(uint8_t mask, uint32_t timeout_ms)
+{
+    uint32_t start = HAL_GetTick(); // Timestamp de départ
+    while ((HAL_GetTick() - start) < timeout_ms)
+    {
+        g_send_pump(); // Lit le flux RX
+        if (g_send_events & mask)
+        {
+            return ESP01_OK;
+        }
+        HAL_Delay(1); // Petite pause CPU
+    }
+    return ESP01_TIMEOUT;
+}
+
+/**
+ * @brief  Émet des segments dans un AT+CIPSEND (ou AT+CIPSENDBUF) sans attendre "SEND OK".
+ * @param  link        Lien (0..4), ou -1 en mode mono-connexion.
+ * @param  remote_host Destination d'un datagramme (NULL : celle du lien).
+ * @param  remote_port Port de destination.
+ * @param  parts       Segments à émettre dans l'ordre.
+ * @param  count       Nombre de segments.
+ * @param  pump        Lecture du flux RX utilisée pendant les attentes.
+ * @param  stream      Lien TCP : AT+CIPSENDBUF possible (ESP01_SEND_USE_CIPSENDBUF).
+ * @retval ESP01_Status_t Code de statut.
+ * @note   esp-at répond "busy p..." à toute commande reçue avant le "SEND OK"
+ *         précédent : la commande est alors relancée après la confirmation.
+ *         AT+CIPSENDBUF répond "<segment>,<dernier segment envoyé>" avant ">" ;
+ *         tampon d'émission plein ("ERROR"), la commande est relancée de même.
+ */
+static ESP01_Status_t _esp01_send_submit(int link, const char *remote_host, uint16_t remote_port, const esp01_tx_part_t *parts, int count,
+                                         esp01_rx_pump_t pump, bool stream)
+{
+    VALIDATE_PARAM(parts && count > 0 && pump && link >= -1 && link < ESP01_MAX_CONNECTIONS, ESP01_INVALID_PARAM); // Vérifie les paramètres
+    VALIDATE_PARAM(!remote_host || link >= 0, ESP01_INVALID_PARAM);                // Destination : lien UDP en multi-connexion
+    VALIDATE_PARAM(g_esp_uart, ESP01_NOT_INITIALIZED);                            // Vérifie l'UART
+
+    size_t total_len = 0;           // Taille totale à annoncer
+    for (int i = 0; i < count; i++) // Pour chaque segment
+    {
+        total_len += parts[i].len;  // Cumule la taille
+    }
+    if (total_len == 0)             // Rien à envoyer
+    {
+        return ESP01_OK;
+    }
+    if (total_len > ESP01_MAX_SEND_LEN) // AT+CIPSEND est limité à 2048 octets
+    {
+        ESP01_LOG_ERROR("SEND", "Envoi trop grand (%u octets, max=%d)", (unsigned)total_len, ESP01_MAX_SEND_LEN); // Log l'erreur
+        return ESP01_BUFFER_OVERFLOW;
+    }
+
+    bool buffered = stream && ESP01_SEND_USE_CIPSENDBUF;                              // Segment TCP numéroté
+    g_send_pump = pump;                                                               // Lecture RX pour les attentes suivantes
+    ESP01_Status_t st = _esp01_send_wait_below(buffered ? ESP01_SEND_MAX_INFLIGHT : 1, ESP01_TIMEOUT_LONG); // Place dans le pipeline
+    if (st != ESP01_OK)
+    {
+        ESP01_LOG_ERROR("SEND", "Pipeline bloqué : pas de SEND OK"); // Log le blocage
+        return st;
+    }
+
+    char cmd[2 * ESP01_SMALL_BUF_SIZE]; // Commande AT+CIPSEND (adresse de destination comprise)
+    int cmd_len;
+    if (remote_host)
+    {
+        cmd_len = snprintf(cmd, sizeof(cmd), "AT+CIPSEND=%d,%u,\"%s\",%u\r\n", link, (unsigned)total_len, remote_host, remote_port);
+    }
+    else if (buffered)
+    {
+        cmd_len = (link >= 0) ? snprintf(cmd, sizeof(cmd), "AT+CIPSENDBUF=%d,%u\r\n", link, (unsigned)total_len)
+                              : snprintf(cmd, sizeof(cmd), "AT+CIPSENDBUF=%u\r\n", (unsigned)total_len);
+    }
+    else
+    {
+        cmd_len = (link >= 0) ? snprintf(cmd, sizeof(cmd), "AT+CIPSEND=%d,%u\r\n", link, (unsigned)total_len)
+                              : snprintf(cmd, sizeof(cmd), "AT+CIPSEND=%u\r\n", (unsigned)total_len);
+    }
+    if (cmd_len < 0 || cmd_len >= (int)sizeof(cmd)) // Adresse trop longue
+    {
+        return ESP01_BUFFER_OVERFLOW;
+    }
+
+    for (uint8_t attempt = 0;; attempt++)
+    {
+        g_send_events = 0;
+        g_send_seg = 0;
+        g_send_buffered = buffered;
+        g_send_wait_prompt = true;
+        st = esp01_uart_write(cmd, cmd_len); // Envoie la commande (sans vidage RX)
+        if (st != ESP01_OK)
+        {
+            g_send_wait_prompt = false;
+            ESP01_RETURN_ERROR("SEND", st);
+        }
+        st = _esp01_send_wait_event(ESP01_SEND_EVT_PROMPT | ESP01_SEND_EVT_BUSY | ESP01_SEND_EVT_ERROR, ESP01_TIMEOUT_SHORT);
+        g_send_wait_prompt = false;
+        if (g_send_events & ESP01_SEND_EVT_PROMPT) // ">" : l'ESP01 attend les données
+        {
+            break;
+        }
+        bool full = buffered && (g_send_events & ESP01_SEND_EVT_ERROR) && g_send_count > 0; // Tampon d'émission plein
+        if (((g_send_events & ESP01_SEND_EVT_BUSY) || full) && attempt < ESP01_SEND_MAX_RETRY) // Envoi précédent pas terminé
+        {
+            g_send_stats.busy_retries++;
+            _esp01_send_wait_event(ESP01_SEND_EVT_DONE, ESP01_TIMEOUT_SHORT); // Attend sa confirmation (suivi ou non)
+            continue;
+        }
+        ESP01_LOG_ERROR("SEND", "AT+CIPSEND échoué pour le lien %d", link); // Log l'échec
+        return st != ESP01_OK ? st : ESP01_FAIL;
+    }
+
+    for (int i = 0; i < count; i++)                                                             // Pour chaque segment
+    {
+        if (parts[i].len > 0)                                                                   // Ignore les segments vides
+        {
+            st = esp01_uart_write(parts[i].data, parts[i].len); // Envoie le segment sur l'UART
+            if (st != ESP01_OK)                                 // UART en erreur : l'envoi n'est pas suivi
+            {
+                ESP01_RETURN_ERROR("SEND", st);
+            }
+        }
+    }
+
+    esp01_send_slot_t *slot = &g_send_slots[g_send_count]; // Nouvel envoi en vol
+    slot->link = (int8_t)link;
+    slot->seg = buffered ? g_send_seg : 0;
+    slot->len = (uint16_t)total_len;
+    slot->start = HAL_GetTick();
+    g_send_count++;
+    g_send_stats.sends++;
+    g_send_stats.bytes += (uint32_t)total_len;
+    return ESP01_OK;
+}
+
+/**
+ * @brief  Émet des segments sur un lien TCP sans attendre "SEND OK".
+ * @param  link  Lien (0..4), ou -1 en mode mono-connexion.
+ * @param  parts Segments à émettre dans l'ordre.
+ * @param  count Nombre de segments.
+ * @param  pump  Lecture du flux RX utilisée pendant les attentes.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_send_submit(int link, const esp01_tx_part_t *parts, int count, esp01_rx_pump_t pump)
+{
+    return _esp01_send_submit(link, NULL, 0, parts, count, pump, true); // Destination du lien
+}
+
+/**
+ * @brief  Émet un datagramme vers une destination donnée (AT+CIPSEND=<lien>,<taille>,"ip",port).
+ * @param  link        Lien UDP (0..4).
+ * @param  remote_host Destination (NULL : celle du lien).
+ * @param  remote_port Port de destination.
+ * @param  parts       Segments à émettre dans l'ordre.
+ * @param  count       Nombre de segments.
+ * @param  pump        Lecture du flux RX utilisée pendant les attentes.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_send_submit_to(int link, const char *remote_host, uint16_t remote_port, const esp01_tx_part_t *parts, int count,
+                                    esp01_rx_pump_t pump)
+{
+    return _esp01_send_submit(link, remote_host, remote_port, parts, count, pump, false); // Datagramme : jamais AT+CIPSENDBUF
+}
+
+/**
+ * @brief  Traite une ligne AT concernant le pipeline d'émission.
+ * @param  line Ligne reçue.
+ * @param  len  Longueur (fin de ligne éventuelle comprise).
+ * @retval true si la ligne a été consommée.
+ * @note   "ERROR" n'est pas consommé : il peut aussi concerner une autre commande.
+ */
+bool esp01_send_on_line(const char *line, size_t len)
+{
+    VALIDATE_PARAM(line, false);
+    while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == '\n' || line[len - 1] == ' ')) // Retire la fin de ligne
+    {
+        len--;
+    }
+
+    if (g_raw_capture && len > 0) // Commande brute en cours : ligne recopiée dans sa réponse
+    {
+        size_t room = g_raw_capture_size - 1 - g_raw_capture_len;                                       // Place restante ('\0' exclu)
+        int n = snprintf(g_raw_capture + g_raw_capture_len, room + 1, "%.*s\r\n", (int)len, line); // Tronquée si besoin
+        g_raw_capture_len += (n < 0) ? 0 : ((size_t)n > room ? room : (size_t)n);
+    }
+
+    if (len == 1 && line[0] == '>') // Invite : l'ESP01 attend les données
+    {
+        if (g_send_wait_prompt)
+        {
+            g_send_events |= ESP01_SEND_EVT_PROMPT;
+        }
+        return true;
+    }
+    size_t pre = 0; // Préfixe "<lien>,<segment>," ou "<segment>," (AT+CIPSENDBUF)
+    while (pre < len && (isdigit((unsigned char)line[pre]) || line[pre] == ','))
+    {
+        pre++;
+    }
+    if (g_send_wait_prompt && g_send_buffered && pre == len && memchr(line, ',', len)) // "<segment>,<dernier segment envoyé>" avant ">"
+    {
+        g_send_seg = (uint16_t)strtol(line, NULL, 10);
+        return true;
+    }
+    bool ok = (len - pre == 7 && strncmp(line + pre, "SEND OK", 7) == 0);
+    bool fail = (len - pre >= 9 && strncmp(line + pre, "SEND FAIL", 9) == 0);
+    if (ok || fail) // Envoi confirmé : le plus ancien (AT+CIPSEND) ou celui du segment (AT+CIPSENDBUF)
+    {
+        g_send_events |= ESP01_SEND_EVT_DONE;
+        int index = _esp01_send_find(line, pre);
+        if (index < 0)
+        {
+            return true;
+        }
+        esp01_send_slot_t slot = _esp01_send_remove((uint8_t)index);
+        if (ok)
+        {
+            g_send_stats.send_ok++;
+        }
+        else
+        {
+            g_send_stats.send_fail++;
+            ESP01_LOG_WARN("SEND", "Envoi de %u octets échoué sur le lien %d", slot.len, slot.link); // Log l'échec
+        }
+        return true;
+    }
+    if (len >= 5 && strncmp(line, "busy ", 5) == 0) // "busy p..." / "busy s..."
+    {
+        if (g_send_wait_prompt)
+        {
+            g_send_events |= ESP01_SEND_EVT_BUSY;
+        }
+        return true;
+    }
+    if (len >= 5 && strncmp(line, "Recv ", 5) == 0) // "Recv N bytes" : données reçues par l'ESP01
+    {
+        return true;
+    }
+    if (len >= 5 && strncmp(line, "ERROR", 5) == 0 && g_send_wait_prompt) // Lien invalide ou fermé
+    {
+        g_send_events |= ESP01_SEND_EVT_ERROR;
+    }
+    return false;
+}
+
+/**
+ * @brief  Attend que tous les envois soient confirmés.
+ * @param  timeout_ms Timeout en ms.
+ * @retval ESP01_Status_t ESP01_OK ou ESP01_TIMEOUT.
+ */
+ESP01_Status_t esp01_send_wait_idle(uint32_t timeout_ms)
+{
+    if (g_send_count == 0)
+    {
+        return ESP01_OK;
+    }
+    return _esp01_send_wait_below(1, timeout_ms);
+}
+
+/**
+ * @brief  Nombre d'envois en attente de confirmation sur un lien.
+ * @param  link Lien (-1 en mode mono-connexion).
+ * @retval uint8_t Envois en attente.
+ */
+uint8_t esp01_send_outstanding(int link)
+{
+    _esp01_send_expire();
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < g_send_count; i++)
+    {
+        if (g_send_slots[i].link == link)
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief  Nombre total d'envois en attente de confirmation.
+ * @retval uint8_t Envois en attente.
+ */
+uint8_t esp01_send_pending(void)
+{
+    _esp01_send_expire();
+    return g_send_count;
+}
+
+// ========================= ÉCRITURE JSON EN FLUX =========================
+
+/**
+ * @brief  Transmet des octets à la sortie de l'écrivain (ignoré après une erreur).
+ * @param  w    Écrivain.
+ * @param  data Octets.
+ * @param  len  Taille.
+ */
+static void _esp01_json_emit(esp01_json_writer_t *w, const char *data, size_t len)
+{
+    if (w->status != ESP01_OK || len == 0)
+    {
+        return;
+    }
+    w->status = w->write(w->ctx, data, len);
+    if (w->status == ESP01_OK)
+    {
+        w->len += len;
+    }
+}
+
+/**
+ * @brief  Sortie tampon : copie à la suite et termine par '\0'.
+ */
+static ESP01_Status_t _esp01_json_buf_write(void *ctx, const char *data, size_t len)
+{
+    esp01_json_writer_t *w = (esp01_json_writer_t *)ctx;
+    if (w->len + len >= w->size) // Place pour le '\0'
+    {
+        return ESP01_BUFFER_OVERFLOW;
+    }
+    memcpy(w->buf + w->len, data, len);
+    w->buf[w->len + len] = '\0';
+    return ESP01_OK;
+}
+
+/**
+ * @brief  Écrit une chaîne entre guillemets, échappée (segments sans échappement écrits d'un bloc).
+ * @param  w   Écrivain.
+ * @param  str Chaîne terminée par '\0'.
+ */
+static void _esp01_json_quoted(esp01_json_writer_t *w, const char *str)
+{
+    static const char hex[] = "0123456789abcdef";
+    _esp01_json_emit(w, "\"", 1);
+    const char *run = str; // Début des caractères non échappés
+    for (const char *p = str; *p; p++)
+    {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue;
+        }
+        _esp01_json_emit(w, run, (size_t)(p - run));
+        char esc[6] = {'\\', (char)c, 0, 0, 0, 0};
+        size_t n = 2;
+        if (c == '\n')
+        {
+            esc[1] = 'n';
+        }
+        else if (c == '\r')
+        {
+            esc[1] = 'r';
+        }
+        else if (c == '\t')
+        {
+            esc[1] = 't';
+        }
+        else if (c < 0x20) // Autres caractères de contrôle : \u00XX
+        {
+            memcpy(esc + 1, "u00", 3);
+            esc[4] = hex[c >> 4];
+            esc[5] = hex[c & 0x0F];
+            n = 6;
+        }
+        _esp01_json_emit(w, esc, n);
+        run = p + 1;
+    }
+    _esp01_json_emit(w, run, strlen(run));
+    _esp01_json_emit(w, "\"", 1);
+}
+
+/**
+ * @brief  Écrit le séparateur et la clé précédant une valeur.
+ * @param  w   Écrivain.
+ * @param  key Clé (ignorée dans un tableau ou à la racine).
+ */
+static void _esp01_json_prefix(esp01_json_writer_t *w, const char *key)
+{
+    uint32_t bit = 1UL << w->depth;
+    if (w->has_items & bit) // Élément suivant du conteneur
+    {
+        _esp01_json_emit(w, ",", 1);
+    }
+    w->has_items |= bit;
+    if (w->depth > 0 && !(w->is_array & bit)) // Membre d'objet : clé obligatoire
+    {
+        _esp01_json_quoted(w, key ? key : "");
+        _esp01_json_emit(w, ":", 1);
+    }
+}
+
+/**
+ * @brief  Ouvre un conteneur (objet ou tableau).
+ */
+static ESP01_Status_t _esp01_json_open(esp01_json_writer_t *w, const char *key, bool array)
+{
+    VALIDATE_PARAM(w, ESP01_INVALID_PARAM);
+    if (w->depth + 1 >= ESP01_JSON_MAX_DEPTH) // Imbrication trop profonde
+    {
+        if (w->status == ESP01_OK)
+        {
+            w->status = ESP01_BUFFER_OVERFLOW;
+        }
+        return w->status;
+    }
+    _esp01_json_prefix(w, key);
+    _esp01_json_emit(w, array ? "[" : "{", 1);
+    w->depth++;
+    uint32_t bit = 1UL << w->depth;
+    w->has_items &= ~bit; // Nouveau conteneur vide
+    if (array)
+    {
+        w->is_array |= bit;
+    }
+    else
+    {
+        w->is_array &= ~bit;
+    }
+    return w->status;
+}
+
+/**
+ * @brief  Ferme le conteneur courant s'il est du type attendu.
+ */
+static ESP01_Status_t _esp01_json_close(esp01_json_writer_t *w, bool array)
+{
+    VALIDATE_PARAM(w, ESP01_INVALID_PARAM);
+    bool is_array = (w->is_array >> w->depth) & 1U;
+    if (w->depth == 0 || is_array != array) // Fermeture sans ouverture correspondante
+    {
+        if (w->status == ESP01_OK)
+        {
+            w->status = ESP01_FAIL;
+        }
+        return w->status;
+    }
+    w->depth--;
+    _esp01_json_emit(w, array ? "]" : "}", 1);
+    return w->status;
+}
+
+/**
+ * @brief  Écrit une valeur brute (nombre, littéral) précédée de sa clé.
+ */
+static ESP01_Status_t _esp01_json_value(esp01_json_writer_t *w, const char *key, const char *text, size_t len)
+{
+    VALIDATE_PARAM(w, ESP01_INVALID_PARAM);
+    _esp01_json_prefix(w, key);
+    _esp01_json_emit(w, text, len);
+    return w->status;
+}
+
+/**
+ * @brief  Convertit un entier non signé en décimal, de droite à gauche.
+ * @param  value Valeur.
+ * @param  end   Fin du tampon de sortie (non terminée).
+ * @param  min_digits Chiffres minimum (zéros de tête).
+ * @retval Début des chiffres.
+ */
+static char *_esp01_json_utoa(uint32_t value, char *end, uint8_t min_digits)
+{
+    char *p = end;
+    do
+    {
+        *--p = (char)('0' + value % 10);
+        value /= 10;
+        if (min_digits)
+        {
+            min_digits--;
+        }
+    } while (value || min_digits);
+    return p;
+}
+
+/**
+ * @brief  Initialise un écrivain JSON sur une sortie quelconque.
+ * @param  w     Écrivain.
+ * @param  write Sortie des octets.
+ * @param  ctx   Contexte transmis à la sortie.
+ */
+void esp01_json_init(esp01_json_writer_t *w, esp01_json_write_fn_t write, void *ctx)
+{
+    if (!w)
+    {
+        return;
+    }
+    memset(w, 0, sizeof(*w));
+    w->write = write;
+    w->ctx = ctx;
+    w->status = write ? ESP01_OK : ESP01_INVALID_PARAM;
+}
+
+/**
+ * @brief  Initialise un écrivain JSON sur un tampon terminé par '\0'.
+ * @param  w    Écrivain.
+ * @param  buf  Tampon de sortie.
+ * @param  size Taille du tampon.
+ */
+void esp01_json_init_buffer(esp01_json_writer_t *w, char *buf, size_t size)
+{
+    esp01_json_init(w, _esp01_json_buf_write, w);
+    if (!w)
+    {
+        return;
+    }
+    w->buf = buf;
+    w->size = size;
+    if (!buf || size == 0)
+    {
+        w->status = ESP01_INVALID_PARAM;
+    }
+    else
+    {
+        buf[0] = '\0';
+    }
+}
+
+/**
+ * @brief  Ouvre un objet.
+ * @param  w   Écrivain.
+ * @param  key Clé dans l'objet parent (NULL dans un tableau ou à la racine).
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_object_begin(esp01_json_writer_t *w, const char *key)
+{
+    return _esp01_json_open(w, key, false);
+}
+
+/**
+ * @brief  Ferme l'objet courant.
+ * @param  w Écrivain.
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_object_end(esp01_json_writer_t *w)
+{
+    return _esp01_json_close(w, false);
+}
+
+/**
+ * @brief  Ouvre un tableau.
+ * @param  w   Écrivain.
+ * @param  key Clé dans l'objet parent (NULL dans un tableau ou à la racine).
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_array_begin(esp01_json_writer_t *w, const char *key)
+{
+    return _esp01_json_open(w, key, true);
+}
+
+/**
+ * @brief  Ferme le tableau courant.
+ * @param  w Écrivain.
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_array_end(esp01_json_writer_t *w)
+{
+    return _esp01_json_close(w, true);
+}
+
+/**
+ * @brief  Écrit une chaîne échappée (NULL : null).
+ * @param  w     Écrivain.
+ * @param  key   Clé (NULL dans un tableau).
+ * @param  value Chaîne.
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_string(esp01_json_writer_t *w, const char *key, const char *value)
+{
+    VALIDATE_PARAM(w, ESP01_INVALID_PARAM);
+    if (!value)
+    {
+        return esp01_json_null(w, key);
+    }
+    _esp01_json_prefix(w, key);
+    _esp01_json_quoted(w, value);
+    return w->status;
+}
+
+/**
+ * @brief  Écrit un entier signé.
+ * @param  w     Écrivain.
+ * @param  key   Clé (NULL dans un tableau).
+ * @param  value Valeur.
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_int(esp01_json_writer_t *w, const char *key, int32_t value)
+{
+    return esp01_json_fixed(w, key, value, 0);
+}
+
+/**
+ * @brief  Écrit un entier non signé.
+ * @param  w     Écrivain.
+ * @param  key   Clé (NULL dans un tableau).
+ * @param  value Valeur.
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_uint(esp01_json_writer_t *w, const char *key, uint32_t value)
+{
+    char num[10];
+    char *p = _esp01_json_utoa(value, num + sizeof(num), 0);
+    return _esp01_json_value(w, key, p, (size_t)(num + sizeof(num) - p));
+}
+
+/**
+ * @brief  Écrit un nombre en virgule fixe.
+ * @param  w        Écrivain.
+ * @param  key      Clé (NULL dans un tableau).
+ * @param  value    Valeur multipliée par 10^decimals.
+ * @param  decimals Nombre de décimales (0 à 9).
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_fixed(esp01_json_writer_t *w, const char *key, int32_t value, uint8_t decimals)
+{
+    static const uint32_t pow10[10] = {1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL};
+    VALIDATE_PARAM(decimals < 10, ESP01_INVALID_PARAM);
+    char num[22];                                                        // Signe, 10 chiffres, point, 9 décimales
+    uint32_t mag = value < 0 ? 0UL - (uint32_t)value : (uint32_t)value; // Valeur absolue (INT32_MIN compris)
+    char *end = num + sizeof(num);
+    char *p = end;
+    if (decimals)
+    {
+        p = _esp01_json_utoa(mag % pow10[decimals], p, decimals); // Partie décimale avec zéros de tête
+        *--p = '.';
+    }
+    p = _esp01_json_utoa(mag / pow10[decimals], p, 0); // Partie entière
+    if (value < 0)
+    {
+        *--p = '-';
+    }
+    return _esp01_json_value(w, key, p, (size_t)(end - p));
+}
+
+/**
+ * @brief  Écrit un flottant arrondi, via la virgule fixe (pas de "%f" avec newlib-nano).
+ * @param  w        Écrivain.
+ * @param  key      Clé (NULL dans un tableau).
+ * @param  value    Valeur.
+ * @param  decimals Nombre de décimales (0 à 9).
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_float(esp01_json_writer_t *w, const char *key, float value, uint8_t decimals)
+{
+    VALIDATE_PARAM(decimals < 10, ESP01_INVALID_PARAM);
+    float scaled = value;
+    for (uint8_t i = 0; i < decimals; i++)
+    {
+        scaled *= 10.0f;
+    }
+    scaled += (scaled < 0.0f) ? -0.5f : 0.5f;              // Arrondi au plus proche
+    if (!(scaled > -2147483648.0f && scaled < 2147483648.0f)) // NaN, infini ou hors int32
+    {
+        return esp01_json_null(w, key);
+    }
+    return esp01_json_fixed(w, key, (int32_t)scaled, decimals);
+}
+
+/**
+ * @brief  Écrit un booléen.
+ * @param  w     Écrivain.
+ * @param  key   Clé (NULL dans un tableau).
+ * @param  value Valeur.
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_bool(esp01_json_writer_t *w, const char *key, bool value)
+{
+    return value ? _esp01_json_value(w, key, "true", 4) : _esp01_json_value(w, key, "false", 5);
+}
+
+/**
+ * @brief  Écrit null.
+ * @param  w   Écrivain.
+ * @param  key Clé (NULL dans un tableau).
+ * @retval ESP01_Status_t Première erreur de l'écrivain.
+ */
+ESP01_Status_t esp01_json_null(esp01_json_writer_t *w, const char *key)
+{
+    return _esp01_json_value(w, key, "null", 4);
+}
+
+/**
+ * @brief  Termine le document (tous les conteneurs doivent être fermés).
+ * @param  w Écrivain.
+ * @retval ESP01_Status_t ESP01_OK ou première erreur.
+ */
+ESP01_Status_t esp01_json_finish(esp01_json_writer_t *w)
+{
+    VALIDATE_PARAM(w, ESP01_INVALID_PARAM);
+    if (w->status == ESP01_OK && w->depth != 0) // Conteneur non fermé
+    {
+        w->status = ESP01_FAIL;
+    }
+    return w->status;
+}
+
 // ========================= TERMINAL / CONSOLE AT =========================
 
 /**
@@ -1316,7 +2243,7 @@ static ESP01_Status_t esp01_interactive_at_console(char *out_buf, size_t out_buf
 {
     VALIDATE_PARAM(esp01_is_valid_ptr(out_buf) && out_buf_size > 0, ESP01_INVALID_PARAM); // Vérifie la validité des paramètres
 
-    esp01_flush_rx_buffer(10); // Vide le buffer RX avant d'envoyer la commande
+    _esp01_flush_rx_if_idle(10); // Vide le buffer RX avant d'envoyer la commande
 
     if (!esp_console_cmd_ready || esp_console_cmd_idx == 0) // Vérifie qu'une commande est prête
         return ESP01_FAIL;                                  // Retourne une erreur si aucune commande
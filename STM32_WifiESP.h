@@ -10,7 +10,8 @@
  * Ce header regroupe toutes les fonctions de gestion bas niveau du module ESP01,
  * ne nécessitant pas de connexion WiFi : initialisation, configuration UART,
  * gestion du mode sommeil, puissance RF, logs système, reset, restore, version,
- * envoi de commandes AT, gestion du buffer DMA, debug, etc.
+ * envoi de commandes AT, pipeline d'émission AT+CIPSEND, gestion du buffer DMA,
+ * écriture JSON en flux, debug, etc.
  *
  * @note
  * - Compatible STM32CubeIDE.
@@ -49,6 +50,20 @@
 // ----------- TIMEOUT GÉNÉRIQUE -----------
 #define ESP01_AT_COMMAND_TIMEOUT 2000 // Timeout commande AT générique (ms)
 
+// Pipeline d'émission (AT+CIPSEND)
+#define ESP01_MAX_CONNECTIONS 5     // Liens 0..4 en AT+CIPMUX=1 (l'ESP attribue les 5 identifiants)
+#define ESP01_MAX_SEND_LEN 2048     // Taille max d'un AT+CIPSEND (octets)
+#define ESP01_SEND_USE_CIPSENDBUF 0 // 1 : AT+CIPSENDBUF (firmware AT 1.x NonOS), segments TCP confirmés par numéro
+#if ESP01_SEND_USE_CIPSENDBUF
+#define ESP01_SEND_MAX_INFLIGHT 4   // Segments TCP en attente de "SEND OK" (tampon d'émission de l'ESP01)
+#else
+#define ESP01_SEND_MAX_INFLIGHT 1   // Envois en attente de "SEND OK" (esp-at 2.x n'en accepte qu'un)
+#endif
+#define ESP01_SEND_MAX_RETRY 3      // Relances d'un AT+CIPSEND refusé par "busy"
+
+// Écriture JSON en flux
+#define ESP01_JSON_MAX_DEPTH 16     // Objets/tableaux imbriqués max (un bit par niveau)
+
 /* =========================== TYPES & STRUCTURES ============================ */
 /**
  * @brief  Codes de statut pour les fonctions du driver ESP01.
@@ -90,6 +105,72 @@ typedef enum
     ESP01_NTP_SERVER_NOT_REACHABLE  // Serveur NTP injoignable
 } ESP01_Status_t;                   // Enum statut driver ESP01
 
+/**
+ * @brief  Segment de données émis dans un même AT+CIPSEND (sans recopie).
+ */
+typedef struct
+{
+    const void *data; // Début du segment
+    size_t len;       // Taille du segment
+} esp01_tx_part_t;
+
+/**
+ * @brief  Lecture du flux RX par le module propriétaire (HTTP, MQTT...).
+ * @note   Doit transmettre les lignes AT reçues à esp01_send_on_line().
+ */
+typedef void (*esp01_rx_pump_t)(void);
+
+/**
+ * @brief  Nombre de liens ouverts, fourni par le module qui les sert (serveur HTTP).
+ */
+typedef int (*esp01_link_count_t)(void);
+
+/**
+ * @brief  Statistiques du pipeline d'émission.
+ */
+typedef struct
+{
+    uint32_t sends;        // AT+CIPSEND (ou AT+CIPSENDBUF) émis
+    uint32_t send_ok;      // "SEND OK" reçus
+    uint32_t send_fail;    // "SEND FAIL" reçus
+    uint32_t busy_retries; // Commandes relancées après "busy"
+    uint32_t timeouts;     // Envois expirés sans confirmation
+    uint32_t bytes;        // Octets transmis
+} esp01_send_stats_t;
+
+/**
+ * @brief  Octets échangés sur la liaison série avec l'ESP01 (commandes et données).
+ */
+typedef struct
+{
+    uint32_t tx_bytes; // Octets écrits vers l'ESP01
+    uint32_t rx_bytes; // Octets lus depuis le buffer DMA
+} esp01_uart_stats_t;
+
+/**
+ * @brief  Sortie d'un écrivain JSON (flux HTTP, tampon MQTT...).
+ * @retval ESP01_Status_t ESP01_OK si les octets sont acceptés.
+ */
+typedef ESP01_Status_t (*esp01_json_write_fn_t)(void *ctx, const char *data, size_t len);
+
+/**
+ * @brief  Écrivain JSON en flux : les valeurs sont écrites dans la sortie au fil
+ *         des appels, sans document intermédiaire. L'état tient dans la structure
+ *         (pile d'imbrication en bits), la première erreur est conservée.
+ */
+typedef struct
+{
+    esp01_json_write_fn_t write; // Sortie des octets
+    void *ctx;                   // Contexte de la sortie
+    char *buf;                   // Tampon (sortie esp01_json_init_buffer)
+    size_t size;                 // Taille du tampon
+    size_t len;                  // Octets écrits
+    uint32_t has_items;          // Bit i : le conteneur de niveau i a déjà un élément
+    uint32_t is_array;           // Bit i : le conteneur de niveau i est un tableau
+    uint8_t depth;               // Conteneurs ouverts
+    ESP01_Status_t status;       // Première erreur rencontrée
+} esp01_json_writer_t;
+
 /* ========================= VARIABLES GLOBALES EXTERNES ========================= */
 extern UART_HandleTypeDef *g_esp_uart;   // UART principal ESP01
 extern UART_HandleTypeDef *g_debug_uart; // UART debug
@@ -97,6 +178,8 @@ extern uint8_t *g_dma_rx_buf;            // Buffer DMA RX
 extern uint16_t g_dma_buf_size;          // Taille buffer DMA
 extern volatile uint16_t g_rx_last_pos;  // Dernière position RX
 extern uint16_t g_server_port;           // Port serveur
+extern esp01_send_stats_t g_send_stats;  // Statistiques du pipeline d'émission
+extern esp01_uart_stats_t g_uart_stats;  // Octets échangés sur la liaison série
 
 /* ========================= MACROS UTILES & LOGS ============================== */
 void _esp_login(const char *fmt, ...);
@@ -166,6 +249,21 @@ ESP01_Status_t esp01_flush_rx_buffer(uint32_t timeout_ms);
  */
 int esp01_get_new_data(uint8_t *buf, uint16_t bufsize);
 
+/**
+ * @brief Écrit des octets vers l'ESP01 (seul point d'émission UART du driver).
+ * @param data Octets à écrire
+ * @param len  Nombre d'octets
+ * @retval ESP01_Status_t ESP01_OK si l'UART a tout transmis
+ */
+ESP01_Status_t esp01_uart_write(const void *data, size_t len);
+
+/**
+ * @brief Débit maximal de la liaison série avec l'ESP01 (8N1 : 10 bits par octet).
+ * @retval uint32_t Octets par seconde, 0 si l'UART n'est pas initialisée.
+ * @note  Plafond de tout échange (HTTP, MQTT) : à comparer à g_uart_stats.
+ */
+uint32_t esp01_uart_capacity(void);
+
 /* ========================= WRAPPERS AT & HELPERS ASSOCIÉS (par commande AT) ========================= */
 
 /**
@@ -389,6 +487,196 @@ ESP01_Status_t esp01_wait_for_pattern(const char *pattern, uint32_t timeout_ms);
  */
 ESP01_Status_t esp01_send_raw_command_dma(const char *cmd, char *resp, size_t resp_size, const char *wait_pattern, uint32_t timeout_ms);
 
+/* ========================= PIPELINE D'ÉMISSION (AT+CIPSEND) ========================= */
+
+/**
+ * @brief Émet des segments dans un AT+CIPSEND sans attendre "SEND OK".
+ * @param link  Lien (0..4), ou -1 en mode mono-connexion (CIPMUX=0)
+ * @param parts Segments à émettre dans l'ordre
+ * @param count Nombre de segments
+ * @param pump  Lecture du flux RX utilisée pendant les attentes
+ * @retval ESP01_Status_t ESP01_OK dès que les données sont transmises à l'ESP01
+ * @note  Attend seulement qu'un envoi soit confirmé si le pipeline est plein ;
+ *        "SEND OK"/"SEND FAIL" sont appariés plus tard, dans l'ordre. Avec
+ *        ESP01_SEND_USE_CIPSENDBUF, l'envoi passe par AT+CIPSENDBUF : jusqu'à
+ *        ESP01_SEND_MAX_INFLIGHT segments en vol, confirmés par numéro de segment.
+ */
+ESP01_Status_t esp01_send_submit(int link, const esp01_tx_part_t *parts, int count, esp01_rx_pump_t pump);
+
+/**
+ * @brief Émet un datagramme vers une destination donnée (lien UDP), sans attendre "SEND OK".
+ * @param link        Lien UDP (0..4)
+ * @param remote_host Adresse de destination (NULL : destination du lien)
+ * @param remote_port Port de destination
+ * @param parts       Segments à émettre dans l'ordre (un seul datagramme)
+ * @param count       Nombre de segments
+ * @param pump        Lecture du flux RX utilisée pendant les attentes
+ * @retval ESP01_Status_t ESP01_OK dès que les données sont transmises à l'ESP01
+ * @note  Toujours AT+CIPSEND (AT+CIPSENDBUF est réservé au TCP) : attend que les
+ *        envois en vol soient confirmés.
+ */
+ESP01_Status_t esp01_send_submit_to(int link, const char *remote_host, uint16_t remote_port, const esp01_tx_part_t *parts, int count,
+                                    esp01_rx_pump_t pump);
+
+/**
+ * @brief Traite une ligne AT concernant le pipeline (">", "SEND OK", "busy"...).
+ * @param line Ligne reçue
+ * @param len  Longueur (fin de ligne éventuelle comprise)
+ * @retval true si la ligne a été consommée par le pipeline
+ */
+bool esp01_send_on_line(const char *line, size_t len);
+
+/**
+ * @brief Attend que tous les envois soient confirmés.
+ * @param timeout_ms Timeout en ms
+ * @retval ESP01_Status_t ESP01_OK ou ESP01_TIMEOUT
+ */
+ESP01_Status_t esp01_send_wait_idle(uint32_t timeout_ms);
+
+/**
+ * @brief Nombre d'envois en attente de confirmation sur un lien.
+ * @param link Lien (-1 en mode mono-connexion)
+ * @retval uint8_t Envois en attente
+ */
+uint8_t esp01_send_outstanding(int link);
+
+/**
+ * @brief Nombre total d'envois en attente de confirmation.
+ * @retval uint8_t Envois en attente
+ */
+uint8_t esp01_send_pending(void);
+
+/**
+ * @brief Déclare le module qui lit le flux RX tant que des liens sont ouverts.
+ * @param links Nombre de liens ouverts (NULL : aucun propriétaire)
+ * @param pump  Lecture du flux RX du module, qui transmet les lignes à esp01_send_on_line()
+ * @note  Avec des liens ouverts, le flux peut contenir des trames +IPD d'autres clients :
+ *        esp01_send_raw_command_dma() ne vide plus le flux RX et lit sa réponse par
+ *        cette lecture ; les autres commandes brutes (reset, console...) ne le vident plus.
+ */
+void esp01_set_rx_owner(esp01_link_count_t links, esp01_rx_pump_t pump);
+
+/* ========================= ÉCRITURE JSON EN FLUX ========================= */
+
+/**
+ * @brief Initialise un écrivain JSON sur une sortie quelconque.
+ * @param w     Écrivain
+ * @param write Sortie des octets
+ * @param ctx   Contexte transmis à la sortie
+ */
+void esp01_json_init(esp01_json_writer_t *w, esp01_json_write_fn_t write, void *ctx);
+
+/**
+ * @brief Initialise un écrivain JSON sur un tampon (ex: message MQTT).
+ * @param w    Écrivain
+ * @param buf  Tampon de sortie (toujours terminé par '\0')
+ * @param size Taille du tampon
+ * @note  Document trop long : ESP01_BUFFER_OVERFLOW, le tampon contient le début.
+ */
+void esp01_json_init_buffer(esp01_json_writer_t *w, char *buf, size_t size);
+
+/**
+ * @brief Ouvre un objet ("{").
+ * @param w   Écrivain
+ * @param key Clé dans l'objet parent (NULL dans un tableau ou à la racine)
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ */
+ESP01_Status_t esp01_json_object_begin(esp01_json_writer_t *w, const char *key);
+
+/**
+ * @brief Ferme l'objet courant ("}").
+ * @param w Écrivain
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ */
+ESP01_Status_t esp01_json_object_end(esp01_json_writer_t *w);
+
+/**
+ * @brief Ouvre un tableau ("[").
+ * @param w   Écrivain
+ * @param key Clé dans l'objet parent (NULL dans un tableau ou à la racine)
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ */
+ESP01_Status_t esp01_json_array_begin(esp01_json_writer_t *w, const char *key);
+
+/**
+ * @brief Ferme le tableau courant ("]").
+ * @param w Écrivain
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ */
+ESP01_Status_t esp01_json_array_end(esp01_json_writer_t *w);
+
+/**
+ * @brief Écrit une chaîne échappée (NULL : null).
+ * @param w     Écrivain
+ * @param key   Clé (NULL dans un tableau)
+ * @param value Chaîne terminée par '\0'
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ */
+ESP01_Status_t esp01_json_string(esp01_json_writer_t *w, const char *key, const char *value);
+
+/**
+ * @brief Écrit un entier signé.
+ * @param w     Écrivain
+ * @param key   Clé (NULL dans un tableau)
+ * @param value Valeur
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ */
+ESP01_Status_t esp01_json_int(esp01_json_writer_t *w, const char *key, int32_t value);
+
+/**
+ * @brief Écrit un entier non signé.
+ * @param w     Écrivain
+ * @param key   Clé (NULL dans un tableau)
+ * @param value Valeur
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ */
+ESP01_Status_t esp01_json_uint(esp01_json_writer_t *w, const char *key, uint32_t value);
+
+/**
+ * @brief Écrit un nombre en virgule fixe (ex: 2345 avec 2 décimales : 23.45).
+ * @param w        Écrivain
+ * @param key      Clé (NULL dans un tableau)
+ * @param value    Valeur multipliée par 10^decimals
+ * @param decimals Nombre de décimales (0 à 9)
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ */
+ESP01_Status_t esp01_json_fixed(esp01_json_writer_t *w, const char *key, int32_t value, uint8_t decimals);
+
+/**
+ * @brief Écrit un flottant arrondi à un nombre de décimales (sans printf "%f").
+ * @param w        Écrivain
+ * @param key      Clé (NULL dans un tableau)
+ * @param value    Valeur
+ * @param decimals Nombre de décimales (0 à 9)
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ * @note  NaN, infini ou valeur hors de portée d'un int32 mis à l'échelle : null.
+ */
+ESP01_Status_t esp01_json_float(esp01_json_writer_t *w, const char *key, float value, uint8_t decimals);
+
+/**
+ * @brief Écrit un booléen.
+ * @param w     Écrivain
+ * @param key   Clé (NULL dans un tableau)
+ * @param value Valeur
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ */
+ESP01_Status_t esp01_json_bool(esp01_json_writer_t *w, const char *key, bool value);
+
+/**
+ * @brief Écrit null.
+ * @param w   Écrivain
+ * @param key Clé (NULL dans un tableau)
+ * @retval ESP01_Status_t Première erreur de l'écrivain
+ */
+ESP01_Status_t esp01_json_null(esp01_json_writer_t *w, const char *key);
+
+/**
+ * @brief Termine le document : tous les conteneurs doivent être fermés.
+ * @param w Écrivain
+ * @retval ESP01_Status_t ESP01_OK, première erreur, ou ESP01_FAIL si un conteneur reste ouvert
+ */
+ESP01_Status_t esp01_json_finish(esp01_json_writer_t *w);
+
 /**
  * @brief Supprime les espaces et les caractères de contrôle d'une chaîne.
  * @param str Chaîne à nettoyer
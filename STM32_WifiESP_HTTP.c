@@ -9,9 +9,23 @@
  * @details
  * Ce fichier source contient l’implémentation des fonctions HTTP haut niveau pour le module ESP01 :
  * - Gestion du serveur HTTP intégré (démarrage, arrêt, configuration)
- * - Parsing des requêtes HTTP reçues via +IPD
+ * - Parsing des requêtes HTTP reçues via +IPD (incrémental, corps par morceaux)
+ * - Réception passive (AT+CIPRECVDATA) pour les gros corps de requête
+ * - Extraction de champs de formulaire et JSON
  * - Routage des requêtes HTTP vers des handlers personnalisés
- * - Envoi de réponses HTTP (HTML, JSON, 404, etc.)
+ * - Envoi de réponses HTTP (HTML, JSON, 404, etc.), en flux (chunked) ou via templates précompilés
+ * - Cache de réponses par route (TTL court, pool circulaire borné)
+ * - Métriques par route et par lien, exposées au format Prometheus
+ * - Routes WebSocket (RFC 6455) : poignée de main, trames, ping/pong, diffusion
+ * - Routes Server-Sent Events : flux ouvert, évènements numérotés en file sans attente, heartbeats
+ * - Client HTTP/1.1 : connexion persistante, corps en flux, réponse analysée au fil de l'eau
+ * - Limitation de débit par client et globale (seaux à jetons) avant le routage
+ * - Mise à jour OTA en flux : slot A/B, tampons flash ping-pong, CRC-32, validation ou rollback
+ * - Fichiers d'un stockage externe servis par blocs, requêtes Range (206 Partial Content)
+ * - Sockets UDP sur les liens libres : envoi par datagramme avec destination, réception livrée par la boucle
+ * - Cycle de vie des liens : délais d'inactivité et keep-alive, éviction LRU quand les places manquent
+ * - Traitement concurrent des liens : ordonnanceur tourniquet, file d'émission par lien
+ * - Envois non bloquants : la confirmation "SEND OK" est traitée par la lecture RX
  * - Gestion des connexions TCP entrantes (suivi, fermeture, nettoyage)
  * - Statistiques d’utilisation HTTP
  *
@@ -34,6 +48,9 @@
 #include <stdio.h>              // Pour les fonctions d'entrée/sortie (snprintf, sscanf, etc.)
 #include <stdbool.h>            // Pour le type booléen
 #include <stdint.h>				// Pout le type int
+#include <stdlib.h>             // Pour strtol
+#include <stdarg.h>             // Pour va_list (esp01_http_stream_printf)
+#include <ctype.h>              // Pour isdigit (réponses du client HTTP)
 
 // ==================== DEFINES ====================
 #define ESP01_CONN_TIMEOUT_MS 30000 ///< Timeout de connexion TCP (ms)
@@ -42,6 +59,10 @@
 #define ESP01_HTTP_REQUEST_TIMEOUT 5000   // Timeout requête HTTP (ms)
 #define ESP01_HTTP_RESPONSE_TIMEOUT 10000 // Timeout réponse HTTP (ms)
 
+// Évènements AT reconnus dans le flux RX par _http_scan_rx
+#define ESP01_HTTP_EVT_OK 0x01    // "OK"
+#define ESP01_HTTP_EVT_ERROR 0x02 // "ERROR"
+
 // ==================== VARIABLES GLOBALES ====================
 connection_info_t g_connections[ESP01_MAX_CONNECTIONS] = {0}; // Tableau des connexions TCP actives
 int g_connection_count = ESP01_MAX_CONNECTIONS;               // Nombre maximal de connexions
@@ -53,21 +74,110 @@ int g_route_count = 0;                                        // Nombre de route
 esp01_stats_t g_stats = {0};                                  // Statistiques HTTP globales
 extern uint16_t g_server_port;                                // Port du serveur HTTP
 
-// ==================== OUTILS FACTORISÉS ====================
+static bool g_http_passive_recv = false;                 // Mode de réception passif (AT+CIPRECVMODE=1)
+static uint32_t g_http_last_recvlen_poll = 0;            // Dernière resynchronisation AT+CIPRECVLEN?
+static uint8_t g_http_recv_buf[ESP01_HTTP_RECV_CHUNK];   // Données lues par AT+CIPRECVDATA
+static int g_http_rr_next = 0;                           // Premier lien servi au prochain tour (tourniquet)
+static int g_http_dispatch_depth = 0;                    // Handler en cours d'exécution (jamais imbriqué)
+static volatile uint8_t g_http_rx_events = 0;            // Évènements AT reçus (ESP01_HTTP_EVT_*)
+static uint32_t g_http_idle_timeout_ms = ESP01_CONN_TIMEOUT_MS;                // Silence max d'un lien
+static uint32_t g_http_keepalive_timeout_ms = ESP01_HTTP_KEEPALIVE_TIMEOUT_MS; // Attente max de la requête suivante
+static uint8_t g_http_link_reserve = ESP01_HTTP_LINK_RESERVE;                  // Liens gardés libres (éviction LRU)
 
 /**
- * @brief Recherche le prochain paquet +IPD dans le buffer.
- * @param buffer      Buffer à analyser.
- * @param buffer_len  Taille du buffer.
- * @retval Pointeur vers le début du +IPD, ou NULL si non trouvé.
+ * @brief Octets d'une trame +IPD laissés dans l'accumulateur : le lien traite encore sa requête précédente.
  */
-static char *_find_next_ipd(char *buffer, int buffer_len)
+typedef struct
 {
-    for (int i = 0; i < buffer_len - 4; ++i)     // Parcours le buffer jusqu'à buffer_len-4
-        if (memcmp(&buffer[i], "+IPD,", 5) == 0) // Compare les 5 caractères avec "+IPD,"
-            return &buffer[i];                   // Retourne le pointeur si trouvé
-    return NULL;                                 // Retourne NULL si non trouvé
-}
+    uint16_t off;   // Index du premier octet dans g_accumulator
+    uint16_t len;   // Nombre d'octets
+    int8_t conn_id; // Lien destinataire
+} _http_held_t;
+
+static uint16_t g_acc_head = 0;                        // Premier octet occupé de l'accumulateur circulaire
+static uint16_t g_acc_scan = 0;                        // Octets déjà analysés depuis g_acc_head (curseur de reprise)
+static int8_t g_acc_frame_conn = -1;                   // Lien de la trame +IPD en cours (-1 : lien non suivi)
+static uint16_t g_acc_frame_left = 0;                  // Octets de cette trame restant à analyser
+static _http_held_t g_http_held[ESP01_HTTP_MAX_HELD];  // Données en attente, dans l'ordre d'arrivée
+static uint8_t g_http_held_count = 0;                  // Entrées utilisées dans g_http_held
+
+/**
+ * @brief Datagramme reçu en attente de livraison (contenu dans g_udp_rx_pool).
+ */
+typedef struct
+{
+    uint16_t off;              // Index du premier octet dans g_udp_rx_pool
+    uint16_t len;              // Taille du datagramme (trame +IPD)
+    uint16_t got;              // Octets déjà reçus
+    int8_t link;               // Lien UDP
+    uint16_t port;             // Port de l'émetteur
+    char ip[ESP01_MAX_IP_LEN]; // Adresse de l'émetteur ("" sans AT+CIPDINFO=1)
+} _http_udp_dgram_t;
+
+static uint8_t g_udp_rx_pool[ESP01_UDP_RX_POOL_SIZE];        // Contenus des datagrammes, pool circulaire
+static _http_udp_dgram_t g_udp_rx[ESP01_UDP_RX_MAX_QUEUED]; // Datagrammes, du plus ancien au plus récent
+static uint8_t g_udp_rx_first = 0;                           // Datagramme le plus ancien
+static uint8_t g_udp_rx_count = 0;                           // Datagrammes en file
+static int8_t g_udp_rx_cur = -1;                             // Datagramme de la trame en cours (-1 : trame ignorée)
+
+/**
+ * @brief Réponse rendue conservée dans le pool du cache.
+ */
+typedef struct
+{
+    char key[ESP01_HTTP_CACHE_KEY_LEN]; // Chemin + "?" + query string
+    uint16_t off;                       // Index du premier octet dans g_http_cache_pool
+    uint16_t len;                       // Taille de la réponse complète (en-tête compris)
+    uint32_t expires;                   // HAL_GetTick() de fin de validité
+    bool valid;                         // false : en cours de capture ou invalidée
+} _http_cache_entry_t;
+
+static uint8_t g_http_cache_pool[ESP01_HTTP_CACHE_POOL_SIZE];         // Octets des réponses, pool circulaire
+static _http_cache_entry_t g_http_cache[ESP01_HTTP_CACHE_MAX_ENTRIES]; // Entrées, de la plus ancienne à la plus récente
+static uint8_t g_http_cache_first = 0;                                // Entrée la plus ancienne
+static uint8_t g_http_cache_count = 0;                                // Entrées utilisées
+static uint16_t g_http_cache_head = 0;                                // Premier octet occupé du pool
+static uint16_t g_http_cache_used = 0;                                // Octets occupés du pool
+static int8_t g_http_cache_conn = -1;                                 // Lien dont la réponse est capturée (-1 : aucun)
+static bool g_http_cache_failed = false;                              // Capture abandonnée (pool trop petit, envoi échoué)
+static uint8_t g_http_cache_replaying = 0;                            // Réponses en cours d'envoi depuis le pool
+static esp01_route_stats_t g_http_unrouted_stats = {0};               // Métriques des requêtes sans route (400, 404, favicon)
+
+/**
+ * @brief Seau à jetons de la limitation de débit (jetons en millièmes de requête).
+ */
+typedef struct
+{
+    char ip[ESP01_MAX_IP_LEN]; // Adresse IP du client (vide : seau libre ou global)
+    uint32_t tokens;           // Jetons disponibles (1000 par requête)
+    uint32_t refill_at;        // Timestamp du dernier remplissage
+} _http_rl_bucket_t;
+
+/**
+ * @brief Configuration et état de la limitation de débit.
+ */
+typedef struct
+{
+    uint16_t client_rate;                          // Requêtes/s par client (0 : désactivé)
+    uint16_t client_burst;                         // Capacité du seau d'un client
+    uint16_t global_rate;                          // Requêtes/s tous clients (0 : désactivé)
+    uint16_t global_burst;                         // Capacité du seau global
+    esp01_http_rl_action_t action;                 // Réponse ou fermeture
+    _http_rl_bucket_t clients[ESP01_HTTP_RL_CLIENTS]; // Seaux par adresse IP
+    _http_rl_bucket_t global;                      // Seau global
+} _http_rl_t;
+
+static _http_rl_t g_http_rl = {0}; // Limitation de débit (désactivée par défaut)
+
+static void _http_scan_rx(void);         // Lecture du flux RX (trames +IPD et lignes AT)
+static void _http_schedule_round(void);  // Un tour de l'ordonnanceur entre liens
+static void _http_txq_round(void);       // Un segment par file d'émission, sans appel de handler
+static ESP01_Status_t _http_link_write(int conn_id, const esp01_tx_part_t *parts, int count); // Écriture dans la file d'un lien
+static bool _http_link_held(int conn_id); // Trames du lien en attente dans l'accumulateur
+static bool _http_acc_fill(void);         // Lecture du DMA dans l'accumulateur, sans analyse
+static void _http_drop_held(int conn_id); // Abandon des trames en attente d'un lien
+
+// ==================== OUTILS FACTORISÉS ====================
 
 /**
  * @brief Parse l'en-tête +IPD pour extraire les infos de la requête.
@@ -80,32 +190,73 @@ static http_request_t parse_ipd_header(const char *data)
     if (!data || strncmp(data, "+IPD,", 5) != 0) // Vérifie que la chaîne commence bien par "+IPD,"
         return req;                              // Retourne une structure vide si ce n'est pas le cas
 
-    int conn_id = -1, content_length = 0, client_port = 0; // Variables pour stocker les valeurs extraites
-    char client_ip[ESP01_MAX_IP_LEN] = {0};                // Buffer pour l'adresse IP du client
+    int conn_id = -1, content_length = 0, client_port = 0, end = 0; // Variables pour stocker les valeurs extraites
 
-    int n = sscanf(data, "+IPD,%d,%d,\"%[^\"]\",%d:", &conn_id, &content_length, client_ip, &client_port); // Tente de parser la version longue avec IP et port
-    if (n == 4)                                                                                            // Si les 4 champs sont trouvés
+    // "+IPD,id,len[,"ip",port]:data" en mode actif, "+IPD,id,len[,"ip",port]\r\n" en mode passif
+    if (sscanf(data, "+IPD,%d,%d%n", &conn_id, &content_length, &end) != 2) // Identifiant et longueur
+    {
+        return req;
+    }
+    if (data[end] == ',' && data[end + 1] == '"') // Version longue avec IP et port
     {
-        req.conn_id = conn_id;                                              // Stocke l'identifiant de connexion
-        req.content_length = content_length;                                // Stocke la longueur du contenu
-        req.has_ip = true;                                                  // Indique que l'IP est présente
-        esp01_safe_strcpy(req.client_ip, sizeof(req.client_ip), client_ip); // Copie l'adresse IP
-        esp01_trim_string(req.client_ip);                                   // Supprime les espaces superflus
-        req.client_port = client_port;                                      // Stocke le port du client
-        req.is_valid = true;                                                // Indique que la structure est valide
+        const char *ip = data + end + 2;   // Début de l'adresse
+        const char *quote = strchr(ip, '"'); // Fin de l'adresse : une adresse IPv6 contient des ':'
+        int port_end = 0;
+        if (!quote || sscanf(quote + 1, ",%d%n", &client_port, &port_end) != 1)
+        {
+            return req;
+        }
+        size_t ip_len = (size_t)(quote - ip);
+        if (ip_len >= sizeof(req.client_ip)) // Adresse tronquée plutôt que débordement
+        {
+            ip_len = sizeof(req.client_ip) - 1;
+        }
+        memcpy(req.client_ip, ip, ip_len); // Copie l'adresse
+        req.client_ip[ip_len] = '\0';
+        esp01_trim_string(req.client_ip); // Supprime les espaces superflus
+        req.has_ip = true;                // Indique que l'IP est présente
+        end = (int)(quote + 1 + port_end - data);
     }
-    else if (sscanf(data, "+IPD,%d,%d:", &conn_id, &content_length) == 2) // Sinon, tente la version courte sans IP
+    if (data[end] != ':' && data[end] != '\r') // Fin d'en-tête attendue
     {
-        req.conn_id = conn_id;               // Stocke l'identifiant de connexion
-        req.content_length = content_length; // Stocke la longueur du contenu
-        req.has_ip = false;                  // Indique que l'IP n'est pas présente
-        req.client_ip[0] = '\0';             // Chaîne IP vide
-        req.client_port = 0;                 // Port à zéro
-        req.is_valid = true;                 // Indique que la structure est valide
+        return (http_request_t){0};
     }
+
+    req.conn_id = conn_id;                // Stocke l'identifiant de connexion
+    req.content_length = content_length;  // Stocke la longueur du contenu
+    req.client_port = client_port;        // Port du client (0 : version courte)
+    req.is_passive = (data[end] == '\r'); // Notification sans données (mode passif)
+    req.is_valid = true;                  // Indique que la structure est valide
     return req; // Retourne la structure remplie
 }
 
+/**
+ * @brief Ajoute du texte formaté à la suite d'un buffer, sans jamais déborder.
+ * @param buf  Buffer de destination.
+ * @param size Taille du buffer.
+ * @param len  Longueur déjà écrite (mise à jour si l'ajout tient).
+ * @param fmt  Format printf.
+ * @retval true si le texte tient entièrement, false sinon (buffer inchangé au-delà de *len).
+ */
+static bool _http_fmt_append(char *buf, size_t size, size_t *len, const char *fmt, ...)
+{
+    if (*len >= size) // Buffer déjà plein
+    {
+        return false;
+    }
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + *len, size - *len, fmt, args); // Borné par la place restante
+    va_end(args);
+    if (n < 0 || (size_t)n >= size - *len) // Erreur ou texte tronqué
+    {
+        buf[*len] = '\0';
+        return false;
+    }
+    *len += (size_t)n;
+    return true;
+}
+
 // ==================== ROUTES ====================
 
 /**
@@ -116,6 +267,7 @@ void esp01_clear_routes(void)
     ESP01_LOG_DEBUG("HTTP", "Effacement de toutes les routes HTTP"); // Log l'effacement des routes
     memset(g_routes, 0, sizeof(g_routes));                           // Réinitialise le tableau des routes à zéro
     g_route_count = 0;                                               // Réinitialise le compteur de routes
+    esp01_http_cache_invalidate(NULL);                               // Les réponses en cache n'ont plus de route
 }
 
 /**
@@ -125,6 +277,18 @@ void esp01_clear_routes(void)
  * @retval ESP01_Status_t Code de statut.
  */
 ESP01_Status_t esp01_add_route(const char *path, esp01_route_handler_t handler)
+{
+    return esp01_add_route_stream(path, handler, NULL); // Route sans réception du corps par morceaux
+}
+
+/**
+ * @brief Ajoute une route HTTP recevant le corps de la requête par morceaux.
+ * @param path     Chemin de la route (ex: "/upload").
+ * @param handler  Handler appelé une fois le corps entièrement reçu.
+ * @param on_body  Callback appelé pour chaque morceau du corps (NULL : corps conservé s'il tient dans le parseur).
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_add_route_stream(const char *path, esp01_route_handler_t handler, esp01_http_body_cb_t on_body)
 {
     ESP01_LOG_DEBUG("HTTP", "Ajout de la route : %s", path);                        // Log l'ajout de la route
     VALIDATE_PARAM(path && handler, ESP01_INVALID_PARAM);                           // Vérifie les paramètres
@@ -132,6 +296,7 @@ ESP01_Status_t esp01_add_route(const char *path, esp01_route_handler_t handler)
         ESP01_RETURN_ERROR("ADD_ROUTE", ESP01_FAIL);                                // Retourne une erreur si trop de routes
     esp01_safe_strcpy(g_routes[g_route_count].path, ESP01_MAX_HTTP_PATH_LEN, path); // Copie le chemin de la route
     g_routes[g_route_count].handler = handler;                                      // Associe le handler
+    g_routes[g_route_count].on_body = on_body;                                      // Associe le callback corps (optionnel)
     g_route_count++;                                                                // Incrémente le compteur de routes
     ESP01_LOG_DEBUG("HTTP", "Route ajoutée : %s (total=%d)", path, g_route_count);  // Log la réussite
     return ESP01_OK;                                                                // Retourne OK
@@ -178,6 +343,63 @@ esp01_route_handler_t esp01_find_route_handler(const char *path)
     return NULL;                                                              // Retourne NULL si aucun handler trouvé
 }
 
+/**
+ * @brief Recherche une route HTTP par son chemin.
+ * @param path  Chemin de la route recherchée.
+ * @retval Pointeur vers la route, ou NULL si non trouvée.
+ */
+static esp01_route_t *_http_find_route(const char *path)
+{
+    for (int i = 0; i < g_route_count; ++i)                                // Parcours toutes les routes enregistrées
+    {
+        if (strncmp(path, g_routes[i].path, ESP01_MAX_HTTP_PATH_LEN) == 0) // Compare le chemin
+        {
+            return &g_routes[i];                                           // Retourne la route
+        }
+    }
+    for (int i = 0; i < g_route_count; ++i) // Sinon : préfixe d'une route de fichiers ("/files" sert "/files/...")
+    {
+        size_t len = strlen(g_routes[i].path);
+        if (g_routes[i].storage && strncmp(path, g_routes[i].path, len) == 0 && path[len] == '/')
+        {
+            return &g_routes[i];
+        }
+    }
+    return NULL; // Route inconnue
+}
+
+/**
+ * @brief Recherche le callback corps associé à une route HTTP.
+ * @param path  Chemin de la route recherchée.
+ * @retval Pointeur vers le callback, ou NULL (route inconnue ou sans callback).
+ */
+static esp01_http_body_cb_t _http_find_body_cb(const char *path)
+{
+    const esp01_route_t *route = _http_find_route(path); // Même résolution que le dispatch (préfixes de fichiers inclus)
+    return route ? route->on_body : NULL;                 // Route inconnue : pas de callback
+}
+
+/**
+ * @brief Active (ou désactive) le cache des réponses d'une route.
+ * @param path    Chemin de la route.
+ * @param ttl_ms  Durée de vie d'une réponse en cache (0 : pas de cache).
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_route_set_cache(const char *path, uint32_t ttl_ms)
+{
+    VALIDATE_PARAM(path, ESP01_INVALID_PARAM); // Vérifie le paramètre
+    esp01_route_t *route = _http_find_route(path);
+    if (!route)
+    {
+        ESP01_LOG_WARN("HTTP", "Cache : route inconnue : %s", path);
+        return ESP01_FAIL;
+    }
+    route->cache_ttl_ms = ttl_ms;          // Nouvelle durée de vie
+    esp01_http_cache_invalidate(path);     // Les réponses déjà en cache suivaient l'ancienne durée
+    ESP01_LOG_DEBUG("HTTP", "Cache de la route %s : %lu ms", path, (unsigned long)ttl_ms);
+    return ESP01_OK;
+}
+
 // ==================== INIT & SERVEUR ====================
 
 /**
@@ -189,9 +411,25 @@ ESP01_Status_t esp01_http_init(void)
     ESP01_LOG_DEBUG("HTTP", "Initialisation du module HTTP"); // Log l'initialisation
     memset(g_connections, 0, sizeof(g_connections));          // Réinitialise les connexions
     g_connection_count = ESP01_MAX_CONNECTIONS;               // Réinitialise le compteur de connexions
+    esp01_set_rx_owner(esp01_get_active_connection_count, _http_scan_rx); // Commandes AT brutes : trames +IPD des liens conservées
     g_acc_len = 0;                                            // Réinitialise la longueur de l'accumulateur
+    g_acc_head = 0;                                           // Accumulateur circulaire vide
+    g_acc_scan = 0;                                           // Curseur d'analyse au début
+    g_acc_frame_left = 0;                                     // Aucune trame en cours
+    g_http_held_count = 0;                                    // Aucune donnée en attente
+    g_udp_rx_first = 0;                                       // Aucun datagramme UDP en file
+    g_udp_rx_count = 0;
+    g_udp_rx_cur = -1;
     memset(g_accumulator, 0, sizeof(g_accumulator));          // Vide l'accumulateur
     g_processing_request = 0;                                 // Réinitialise l'indicateur de traitement
+    g_http_passive_recv = false;                              // Mode de réception actif par défaut
+    g_http_cache_first = 0;                                   // Cache de réponses vide
+    g_http_cache_count = 0;
+    g_http_cache_head = 0;
+    g_http_cache_used = 0;
+    g_http_cache_conn = -1;                                   // Aucune capture en cours
+    g_http_cache_replaying = 0;
+    memset(&g_http_unrouted_stats, 0, sizeof(g_http_unrouted_stats)); // Métriques hors routes remises à zéro
     esp01_clear_routes();                                     // Efface toutes les routes HTTP
     return ESP01_OK;                                          // Retourne OK
 }
@@ -260,13 +498,105 @@ ESP01_Status_t esp01_start_server_config(bool multi_conn, uint16_t port, bool ip
     return esp01_http_start_server(port); // Démarre le serveur HTTP sur le port spécifié
 }
 
+/**
+ * @brief Active ou désactive le mode de réception passif (AT+CIPRECVMODE).
+ * @param enable  true pour le mode passif (lecture par AT+CIPRECVDATA), false pour le mode +IPD.
+ * @retval ESP01_Status_t Code de statut.
+ * @note   En mode passif, l'ESP conserve les données reçues et ne les transmet qu'à la
+ *         demande : tant que le STM32 ne les lit pas, la fenêtre TCP se referme et le
+ *         client ralentit. Les gros corps de requête ne peuvent donc plus déborder.
+ */
+ESP01_Status_t esp01_http_set_passive_recv(bool enable)
+{
+    ESP01_LOG_DEBUG("HTTP", "Mode de réception %s", enable ? "passif" : "actif");                       // Log le mode demandé
+    char cmd[ESP01_MAX_CMD_BUF];                                                                        // Buffer pour la commande AT
+    snprintf(cmd, sizeof(cmd), "AT+CIPRECVMODE=%d", enable ? 1 : 0);                                    // Prépare la commande AT
+    char resp[ESP01_MAX_RESP_BUF];                                                                      // Buffer pour la réponse AT
+    ESP01_Status_t st = esp01_send_raw_command_dma(cmd, resp, sizeof(resp), "OK", ESP01_TIMEOUT_SHORT); // Envoie la commande AT
+    if (st != ESP01_OK)                                                                                 // Vérifie le statut de la commande
+    {
+        ESP01_RETURN_ERROR("CIPRECVMODE", st);                                                          // Retourne une erreur si échec
+    }
+    g_http_passive_recv = enable;                                                                       // Mémorise le mode
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i)                                                     // Oublie les octets en attente
+    {
+        g_connections[i].rx_pending = 0;
+    }
+    return ESP01_OK; // Retourne OK
+}
+
 // ==================== PARSING REQUÊTES HTTP ====================
 
+/**
+ * @brief Parse la ligne de requête HTTP (méthode, chemin, query string).
+ * @param line      Début de la ligne de requête.
+ * @param line_len  Longueur de la ligne (sans CRLF).
+ * @param parsed    Structure de sortie (method, path, query_string).
+ * @retval ESP01_Status_t Code de statut.
+ */
+static ESP01_Status_t _http_parse_request_line(const char *line, size_t line_len, http_parsed_request_t *parsed)
+{
+    const char *p = line;                   // Curseur de lecture
+    const char *line_end = line + line_len; // Fin de la ligne
+
+    const char *method_start = p;     // Début de la méthode
+    while (p < line_end && *p != ' ') // Avance jusqu'à l'espace après la méthode
+    {
+        p++;
+    }
+    size_t method_len = p - method_start;                                   // Longueur de la méthode
+    if (method_len == 0 || method_len >= ESP01_MAX_HTTP_METHOD_LEN || p >= line_end) // Vérifie la taille de la méthode
+    {
+        return ESP01_FAIL;                                                  // Retourne une erreur si vide ou trop long
+    }
+    memcpy(parsed->method, method_start, method_len);                       // Copie la méthode
+    parsed->method[method_len] = '\0';                                      // Termine la chaîne
+
+    p++;                                                  // Passe l'espace
+    const char *path_start = p;                           // Début du chemin
+    while (p < line_end && *p != ' ' && *p != '?')        // Avance jusqu'à l'espace ou '?'
+    {
+        p++;
+    }
+    size_t path_len = p - path_start;                     // Longueur du chemin
+    if (path_len == 0 || path_len >= ESP01_MAX_HTTP_PATH_LEN) // Vérifie la taille du chemin
+    {
+        return ESP01_FAIL;                                // Retourne une erreur si vide ou trop long
+    }
+    memcpy(parsed->path, path_start, path_len);           // Copie le chemin
+    parsed->path[path_len] = '\0';                        // Termine la chaîne
+
+    parsed->query_string = "";     // Pas de query string par défaut
+    parsed->query_len = 0;         // Longueur nulle
+    if (p < line_end && *p == '?') // Si une query string est présente
+    {
+        p++;                              // Passe le '?'
+        const char *query_start = p;      // Début de la query string
+        while (p < line_end && *p != ' ') // Avance jusqu'à l'espace
+        {
+            p++;
+        }
+        size_t qlen = p - query_start;   // Calcule la longueur
+        if (qlen > UINT16_MAX)           // Vérifie la taille
+        {
+            return ESP01_FAIL;           // Retourne une erreur si trop long
+        }
+        parsed->query_string = query_start; // Vue sur la query string (sans copie)
+        parsed->query_len = (uint16_t)qlen; // Longueur de la vue
+    }
+
+    parsed->is_valid = true; // Indique que le parsing est valide
+    return ESP01_OK;         // Retourne OK
+}
+
 /**
  * @brief Parse une requête HTTP brute en structure http_parsed_request_t.
  * @param raw_request  Chaîne brute de la requête HTTP.
  * @param parsed       Pointeur vers la structure de sortie.
  * @retval ESP01_Status_t Code de statut.
+ * @note   Seule la ligne de requête est analysée (headers = NULL) ; pour les
+ *         en-têtes et le corps, utiliser le parseur incrémental. query_string
+ *         est une vue dans raw_request (non terminée par '\0', voir query_len).
  */
 ESP01_Status_t esp01_parse_http_request(const char *raw_request, http_parsed_request_t *parsed)
 {
@@ -276,373 +606,5214 @@ ESP01_Status_t esp01_parse_http_request(const char *raw_request, http_parsed_req
 
     memset(parsed, 0, sizeof(http_parsed_request_t));
 
-    const char *p = raw_request;
-    const char *method_start = p, *method_end = NULL;
-    const char *path_start = NULL, *path_end = NULL;
-    const char *query_start = NULL, *query_end = NULL;
-    const char *line_end = strstr(p, "\r\n");
+    while (*raw_request == '\r' || *raw_request == '\n') // Ignore les lignes vides de tête
+    {
+        raw_request++;
+    }
+    const char *line_end = strstr(raw_request, "\r\n"); // Fin de la ligne de requête
     if (!line_end)
     {
         ESP01_RETURN_ERROR("HTTP_PARSE", ESP01_PARSE_ERROR);
     }
 
-    while (p < line_end && *p != ' ') // Avance jusqu'à l'espace après la méthode
-        p++;
-    method_end = p;                                                  // Marque la fin de la méthode
-    if (method_end - method_start >= ESP01_MAX_HTTP_METHOD_LEN)      // Vérifie la taille de la méthode
-        return ESP01_FAIL;                                           // Retourne une erreur si trop long
-    memcpy(parsed->method, method_start, method_end - method_start); // Copie la méthode
-    parsed->method[method_end - method_start] = '\0';                // Termine la chaîne
-    esp01_trim_string(parsed->method);                               // Supprime les espaces superflus
-
-    p++;                                           // Passe l'espace
-    path_start = p;                                // Début du chemin
-    while (p < line_end && *p != ' ' && *p != '?') // Avance jusqu'à l'espace ou '?'
-        p++;
-    path_end = p;                                            // Fin du chemin
-    if (path_end - path_start >= ESP01_MAX_HTTP_PATH_LEN)    // Vérifie la taille du chemin
-        return ESP01_FAIL;                                   // Retourne une erreur si trop long
-    memcpy(parsed->path, path_start, path_end - path_start); // Copie le chemin
-    parsed->path[path_end - path_start] = '\0';              // Termine la chaîne
-    esp01_trim_string(parsed->path);                         // Supprime les espaces superflus
-
-    if (*p == '?') // Si une query string est présente
-    {
-        p++;                              // Passe le '?'
-        query_start = p;                  // Début de la query string
-        while (p < line_end && *p != ' ') // Avance jusqu'à l'espace
-            p++;
-        query_end = p;                                   // Fin de la query string
-        size_t qlen = query_end - query_start;           // Calcule la longueur
-        if (qlen >= ESP01_MAX_HTTP_QUERY_LEN)            // Vérifie la taille
-            qlen = ESP01_MAX_HTTP_QUERY_LEN - 1;         // Tronque si nécessaire
-        memcpy(parsed->query_string, query_start, qlen); // Copie la query string
-        parsed->query_string[qlen] = '\0';               // Termine la chaîne
-        esp01_trim_string(parsed->query_string);         // Supprime les espaces superflus
-    }
-    else
+    if (_http_parse_request_line(raw_request, line_end - raw_request, parsed) != ESP01_OK) // Analyse la ligne de requête
     {
-        parsed->query_string[0] = '\0'; // Pas de query string
+        return ESP01_FAIL;                                                               // Retourne une erreur si invalide
     }
 
-    parsed->is_valid = true;                                                                                      // Indique que le parsing est valide
-    ESP01_LOG_DEBUG("HTTP", "Méthode=%s, Path=%s, Query=%s", parsed->method, parsed->path, parsed->query_string); // Log le résultat du parsing
+    ESP01_LOG_DEBUG("HTTP", "Méthode=%s, Path=%s, Query=%.*s", parsed->method, parsed->path, (int)parsed->query_len, parsed->query_string); // Log le résultat du parsing
     return ESP01_OK;                                                                                              // Retourne OK
 }
 
-// ==================== ENVOI DE RÉPONSES ====================
+// ==================== PARSEUR HTTP INCRÉMENTAL ====================
 
 /**
- * @brief Envoie une réponse JSON sur la connexion spécifiée.
- * @param conn_id  Identifiant de connexion.
- * @param json     Chaîne JSON à envoyer.
- * @retval ESP01_Status_t Code de statut.
+ * @brief Compare deux chaînes sans tenir compte de la casse (ASCII).
+ * @param a   Première chaîne.
+ * @param b   Seconde chaîne.
+ * @param len Nombre de caractères à comparer.
+ * @retval true si identiques, false sinon.
  */
-ESP01_Status_t esp01_send_json_response(int conn_id, const char *json)
+static bool _http_equals_nocase(const char *a, const char *b, size_t len)
 {
-    ESP01_LOG_DEBUG("HTTP", "Envoi d'une réponse JSON sur connexion %d", conn_id);                        // Log l'envoi JSON
-    return esp01_send_http_response(conn_id, ESP01_HTTP_OK_CODE, "application/json", json, strlen(json)); // Envoie la réponse HTTP avec le JSON
+    for (size_t i = 0; i < len; ++i) // Parcourt les caractères
+    {
+        char ca = a[i], cb = b[i];    // Caractères courants
+        if (ca >= 'A' && ca <= 'Z')   // Passe en minuscule
+        {
+            ca = (char)(ca - 'A' + 'a');
+        }
+        if (cb >= 'A' && cb <= 'Z')   // Passe en minuscule
+        {
+            cb = (char)(cb - 'A' + 'a');
+        }
+        if (ca != cb)                 // Différence trouvée
+        {
+            return false;
+        }
+    }
+    return true; // Chaînes identiques
 }
 
 /**
- * @brief Envoie une réponse 404 Not Found sur la connexion spécifiée.
- * @param conn_id  Identifiant de connexion.
+ * @brief Termine l'analyse des en-têtes (vue sur le bloc, Content-Length).
+ * @param parser Parseur.
  * @retval ESP01_Status_t Code de statut.
  */
-ESP01_Status_t esp01_send_404_response(int conn_id)
+static ESP01_Status_t _http_parser_finish_headers(esp01_http_parser_t *parser)
 {
-    ESP01_LOG_DEBUG("HTTP", "404 Not Found envoyé sur connexion %d", conn_id);                            // Log l'envoi 404
-    const char *body = "<html><body><h1>404 Not Found</h1></body></html>";                                // Corps HTML pour la 404
-    return esp01_send_http_response(conn_id, ESP01_HTTP_NOT_FOUND_CODE, "text/html", body, strlen(body)); // Envoie la réponse HTTP 404
+    http_parsed_request_t *req = &parser->request;                   // Requête en cours
+    req->headers = parser->buf + parser->headers_start;              // Vue sur le bloc d'en-têtes
+    req->headers_len = parser->line_start - parser->headers_start;   // Taille du bloc (sans la ligne vide)
+    req->content_length = 0;                                         // Pas de corps par défaut
+
+    size_t value_len = 0;                                                           // Longueur de la valeur
+    const char *value = esp01_http_get_header(req, "Content-Length", &value_len); // Seul en-tête lu immédiatement (cadrage du corps)
+    if (value)
+    {
+        uint32_t cl = 0;                      // Valeur décodée
+        for (size_t i = 0; i < value_len; ++i) // Décode les chiffres
+        {
+            if (value[i] < '0' || value[i] > '9' || cl > (UINT32_MAX - 9) / 10) // Caractère invalide ou débordement
+            {
+                return ESP01_HTTP_PARSE_ERROR;
+            }
+            cl = cl * 10 + (uint32_t)(value[i] - '0'); // Accumule le chiffre
+        }
+        req->content_length = cl; // Stocke la longueur du corps
+    }
+    return ESP01_OK; // Retourne OK
 }
 
 /**
- * @brief Envoie une réponse HTTP complète (header + body).
- * @param conn_id      Identifiant de connexion.
- * @param status_code  Code HTTP (ex: 200, 404).
- * @param content_type Type MIME (ex: "text/html").
- * @param body         Corps de la réponse.
- * @param body_len     Taille du corps.
- * @retval ESP01_Status_t Code de statut.
+ * @brief Traite une ligne complète (ligne de requête ou en-tête) présente dans buf.
+ * @param parser Parseur.
  */
-ESP01_Status_t esp01_send_http_response(int conn_id, int status_code, const char *content_type,
-                                        const char *body, size_t body_len)
+static void _http_parser_on_line(esp01_http_parser_t *parser)
 {
-    ESP01_LOG_DEBUG("HTTP", "Préparation de la réponse HTTP (conn_id=%d, code=%d, type=%s, taille=%d)", conn_id, status_code, content_type ? content_type : "NULL", (int)body_len); // Log la préparation de la réponse
-    VALIDATE_PARAM(conn_id >= 0, ESP01_FAIL);                                                                                                                                       // Vérifie l'identifiant de connexion
-    VALIDATE_PARAM(status_code >= 100 && status_code < 600, ESP01_FAIL);                                                                                                            // Vérifie le code HTTP
-    VALIDATE_PARAM(body || body_len == 0, ESP01_FAIL);                                                                                                                              // Vérifie le corps de la réponse
-
-    uint32_t start = HAL_GetTick();                             // Timestamp de début pour les stats
-    g_stats.total_requests++;                                   // Incrémente le nombre total de requêtes
-    g_stats.response_count++;                                   // Incrémente le nombre de réponses envoyées
-    if (status_code >= ESP01_HTTP_OK_CODE && status_code < 300) // Si code 2xx
-        g_stats.successful_responses++;                         // Incrémente les réponses réussies
-    else if (status_code >= 400)                                // Si code 4xx ou 5xx
-        g_stats.failed_responses++;                             // Incrémente les réponses échouées
-
-    char header[ESP01_MAX_HEADER_LINE]; // Buffer pour l'en-tête HTTP
-    const char *status_text = "OK";     // Texte du statut HTTP
-    switch (status_code)                // Sélectionne le texte selon le code
+    const char *line = parser->buf + parser->line_start;  // Début de la ligne
+    size_t line_len = parser->buf_len - parser->line_start; // Longueur avec le '\n'
+    line_len--;                                           // Retire le '\n'
+    if (line_len > 0 && line[line_len - 1] == '\r')       // Retire le '\r' éventuel
     {
-    case ESP01_HTTP_OK_CODE:
-        status_text = "OK"; // 200
-        break;
-    case ESP01_HTTP_NOT_FOUND_CODE:
-        status_text = "Not Found"; // 404
-        break;
-    case ESP01_HTTP_INTERNAL_ERR_CODE:
-        status_text = "Internal Server Error"; // 500
-        break;
-    case 204:
-        status_text = "No Content"; // 204
-        break;
-    default:
-        status_text = "Unknown"; // Autre
-        break;
+        line_len--;
     }
 
-    int header_len = snprintf(header, sizeof(header),
-                              "HTTP/1.1 %d %s\r\n"
-                              "Content-Type: %s\r\n"
-                              "Content-Length: %d\r\n"
-                              "Connection: close\r\n"
-                              "\r\n",
-                              status_code, status_text, content_type ? content_type : "text/html", (int)body_len); // Prépare l'en-tête HTTP
-
-    char response[ESP01_MAX_TOTAL_HTTP];             // Buffer pour la réponse complète
-    if ((header_len + body_len) >= sizeof(response)) // Vérifie la taille totale
+    if (parser->state == HTTP_PARSER_REQUEST_LINE) // Ligne de requête attendue
     {
-        ESP01_LOG_ERROR("HTTP", "Réponse HTTP trop grande (header=%d, body=%d, max=%d)", header_len, (int)body_len, (int)sizeof(response)); // Log l'erreur
-        return ESP01_FAIL;                                                                                                                  // Retourne une erreur
+        if (line_len == 0) // Ligne vide avant la requête (tolérée)
+        {
+            parser->buf_len = parser->line_start; // Oublie la ligne vide
+            return;
+        }
+        if (_http_parse_request_line(line, line_len, &parser->request) != ESP01_OK) // Analyse méthode/chemin/query
+        {
+            parser->state = HTTP_PARSER_ERROR; // Requête invalide
+            return;
+        }
+        if (parser->request.query_len > 0) // Termine la vue sur place (la ligne de requête n'est plus relue)
+        {
+            parser->buf[(parser->request.query_string - parser->buf) + parser->request.query_len] = '\0';
+        }
+        parser->state = HTTP_PARSER_HEADERS;         // Passe aux en-têtes
+        parser->headers_start = parser->buf_len;     // Les en-têtes commencent après cette ligne
+        parser->line_start = parser->buf_len;        // Nouvelle ligne
+        return;
     }
 
-    memcpy(response, header, header_len);              // Copie l'en-tête dans le buffer
-    if (body && body_len > 0)                          // Si un corps est présent
-        memcpy(response + header_len, body, body_len); // Copie le corps dans le buffer
-
-    int total_len = header_len + (int)body_len; // Calcule la taille totale
-
-    char cipsend_cmd[ESP01_MAX_CIPSEND_BUF];                                            // Buffer pour la commande AT+CIPSEND
-    snprintf(cipsend_cmd, sizeof(cipsend_cmd), "AT+CIPSEND=%d,%d", conn_id, total_len); // Prépare la commande AT+CIPSEND
-
-    char resp[ESP01_MAX_RESP_BUF];                                                                            // Buffer pour la réponse AT
-    ESP01_Status_t st = esp01_send_raw_command_dma(cipsend_cmd, resp, sizeof(resp), ">", ESP01_TIMEOUT_LONG); // Envoie la commande AT+CIPSEND
-    if (st != ESP01_OK)                                                                                       // Vérifie le statut
+    if (line_len > 0) // En-tête : conservé tel quel, lu à la demande
     {
-        ESP01_LOG_ERROR("HTTP", "AT+CIPSEND échoué pour la connexion %d", conn_id); // Log l'échec
-        return st;                                                                  // Retourne l'erreur
+        parser->line_start = parser->buf_len; // Nouvelle ligne
+        return;
     }
 
-    HAL_UART_Transmit(g_esp_uart, (uint8_t *)response, total_len, HAL_MAX_DELAY); // Envoie la réponse HTTP sur l'UART
-
-    st = esp01_wait_for_pattern("SEND OK", ESP01_TIMEOUT_LONG);                                                                   // Attend la confirmation d'envoi
-    ESP01_LOG_DEBUG("HTTP", "Réponse HTTP envoyée sur connexion %d, taille de la page HTML : %d octets", conn_id, (int)body_len); // Log la réussite
-
-    uint32_t elapsed = HAL_GetTick() - start;                                                                              // Calcule le temps de réponse
-    g_stats.total_response_time_ms += elapsed;                                                                             // Ajoute au temps total
-    g_stats.avg_response_time_ms = g_stats.response_count ? (g_stats.total_response_time_ms / g_stats.response_count) : 0; // Met à jour la moyenne
-
-    return st; // Retourne le statut
+    if (_http_parser_finish_headers(parser) != ESP01_OK) // Ligne vide : fin des en-têtes
+    {
+        parser->state = HTTP_PARSER_ERROR; // Content-Length invalide
+        return;
+    }
+    parser->body_start = parser->buf_len;                                                     // Le corps conservé suit les en-têtes
+    parser->state = parser->request.content_length ? HTTP_PARSER_BODY : HTTP_PARSER_COMPLETE; // Corps attendu ou requête terminée
 }
 
-// ==================== GESTION DES CONNEXIONS ====================
-
 /**
- * @brief Retourne le nombre de connexions TCP actives.
- * @retval Nombre de connexions actives.
+ * @brief Initialise (ou réinitialise) un parseur HTTP incrémental.
+ * @param parser  Parseur à initialiser.
+ * @param conn_id Identifiant de connexion associé.
+ * @param on_body Callback de réception du corps (NULL pour ignorer le corps).
  */
-int esp01_get_active_connection_count(void)
+void esp01_http_parser_init(esp01_http_parser_t *parser, int conn_id, esp01_http_body_cb_t on_body)
 {
-    int count = 0;                                                       // Initialise le compteur
-    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i)                      // Parcours toutes les connexions
-        if (g_connections[i].is_active)                                  // Si la connexion est active
-            count++;                                                     // Incrémente le compteur
-    ESP01_LOG_DEBUG("HTTP", "Nombre de connexions actives : %d", count); // Log le résultat
-    return count;                                                        // Retourne le nombre de connexions actives
+    VALIDATE_PARAM_VOID(parser);     // Vérifie le paramètre
+    parser->conn_id = conn_id;       // Associe la connexion
+    parser->on_body = on_body;       // Enregistre le callback corps
+    esp01_http_parser_reset(parser); // Remet l'état à zéro
 }
 
 /**
- * @brief Vérifie si une connexion TCP est active.
- * @param conn_id  Identifiant de connexion.
- * @retval true si active, false sinon.
+ * @brief Prépare le parseur pour la requête suivante (conserve conn_id et on_body).
+ * @param parser Parseur à réarmer.
  */
-bool esp01_is_connection_active(int conn_id)
+void esp01_http_parser_reset(esp01_http_parser_t *parser)
 {
-    bool active = (conn_id >= 0 && conn_id < ESP01_MAX_CONNECTIONS && g_connections[conn_id].is_active); // Vérifie les bornes et l'état
-    ESP01_LOG_DEBUG("HTTP", "Connexion %d active ? %s", conn_id, active ? "OUI" : "NON");                // Log le résultat
-    return active;                                                                                       // Retourne l'état
+    VALIDATE_PARAM_VOID(parser);                          // Vérifie le paramètre
+    parser->state = HTTP_PARSER_REQUEST_LINE;             // Attend une nouvelle ligne de requête
+    parser->buf_len = 0;                                  // Vide le buffer
+    parser->line_start = 0;                               // Première ligne en début de buffer
+    parser->headers_start = 0;                            // Pas encore d'en-têtes
+    parser->body_start = 0;                               // Pas encore de corps
+    parser->body_received = 0;                            // Aucun octet de corps reçu
+    memset(&parser->request, 0, sizeof(parser->request)); // Efface la requête précédente
 }
 
 /**
- * @brief Nettoie les connexions inactives (timeout).
+ * @brief Alimente le parseur avec de nouveaux octets.
+ * @param parser Parseur.
+ * @param data   Octets reçus (payload +IPD).
+ * @param len    Nombre d'octets.
+ * @retval Nombre d'octets consommés (s'arrête à la fin des en-têtes et à la fin de la requête).
  */
-void esp01_cleanup_inactive_connections(void)
+size_t esp01_http_parser_feed(esp01_http_parser_t *parser, const uint8_t *data, size_t len)
 {
-    uint32_t now = HAL_GetTick();                   // Récupère le temps courant
-    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i) // Parcours toutes les connexions
+    VALIDATE_PARAM(parser && (data || len == 0), 0); // Vérifie les paramètres
+
+    http_parser_state_t entry_state = parser->state; // État à l'entrée
+    size_t i = 0;                                    // Octets consommés
+    while (i < len && (parser->state == HTTP_PARSER_REQUEST_LINE || parser->state == HTTP_PARSER_HEADERS))
     {
-        if (g_connections[i].is_active &&
-            (now - g_connections[i].last_activity > ESP01_CONN_TIMEOUT_MS)) // Si la connexion est inactive depuis trop longtemps
+        if (parser->buf_len >= ESP01_HTTP_PARSER_BUF_SIZE) // En-têtes trop longs pour le buffer
         {
-            ESP01_LOG_DEBUG("HTTP", "Connexion %d inactive depuis %lu ms, fermeture...", i, (unsigned long)(now - g_connections[i].last_activity)); // Log la fermeture
-            esp01_http_close_connection(i);                                                                                                         // Ferme la connexion
-            memset(&g_connections[i], 0, sizeof(connection_info_t));                                                                                // Réinitialise la structure
+            ESP01_LOG_WARN("HTTP", "En-têtes trop longs (conn %d, max=%d)", parser->conn_id, ESP01_HTTP_PARSER_BUF_SIZE);
+            parser->state = HTTP_PARSER_ERROR; // Requête rejetée
+            return i;
         }
-        else if (!g_connections[i].is_active) // Si la connexion n'est pas active
+        char c = (char)data[i++];            // Octet courant
+        parser->buf[parser->buf_len++] = c; // Conserve l'octet (ligne de requête / en-têtes)
+        if (c == '\n')                      // Fin de ligne
         {
-            memset(&g_connections[i], 0, sizeof(connection_info_t)); // Réinitialise la structure
+            _http_parser_on_line(parser);    // Traite la ligne
         }
     }
-}
 
-/**
- * @brief Ferme une connexion TCP HTTP.
- * @param conn_id  Identifiant de connexion.
- * @retval ESP01_Status_t Code de statut.
- */
-ESP01_Status_t esp01_http_close_connection(int conn_id)
-{
-    ESP01_LOG_DEBUG("HTTP", "Fermeture de la connexion %d", conn_id);                                   // Log la fermeture
-    VALIDATE_PARAM(conn_id >= 0 && conn_id < ESP01_MAX_CONNECTIONS, ESP01_INVALID_PARAM);               // Vérifie l'identifiant
-    char cmd[ESP01_MAX_CMD_BUF];                                                                        // Buffer pour la commande AT
-    snprintf(cmd, sizeof(cmd), "AT+CIPCLOSE=%d", conn_id);                                              // Prépare la commande AT+CIPCLOSE
-    char resp[ESP01_MAX_RESP_BUF];                                                                      // Buffer pour la réponse AT
-    ESP01_Status_t st = esp01_send_raw_command_dma(cmd, resp, sizeof(resp), "OK", ESP01_TIMEOUT_SHORT); // Envoie la commande AT
-    if (st != ESP01_OK)
+    if (parser->state == HTTP_PARSER_BODY && entry_state != HTTP_PARSER_BODY) // Fin des en-têtes : rend la main
     {
-        ESP01_LOG_WARN("HTTP_CLOSE", "Fermeture connexion %d : échec ou timeout (code=%d)", conn_id, st);
-        return st;
+        return i;                                                             // (choix du callback corps par l'appelant)
     }
-    g_connections[conn_id].is_active = 0;                    // Marque la connexion comme inactive
-    ESP01_LOG_DEBUG("HTTP", "Connexion %d fermée", conn_id); // Log la réussite
-    return ESP01_OK;                                         // Retourne OK
+
+    if (parser->state == HTTP_PARSER_BODY && i < len) // Corps : transmis sans copie
+    {
+        uint32_t remaining = parser->request.content_length - parser->body_received; // Octets de corps attendus
+        size_t chunk = (len - i < remaining) ? (len - i) : remaining;                // Taille du morceau disponible
+        if (parser->on_body)                                                         // Callback défini
+        {
+            parser->on_body(parser->conn_id, &parser->request, data + i, chunk); // Livre le morceau
+        }
+        else if ((uint32_t)(parser->buf_len - parser->body_start) == parser->body_received &&
+                 parser->buf_len + chunk <= ESP01_HTTP_PARSER_BUF_SIZE) // Sans callback : conserve le corps s'il tient
+        {
+            memcpy(parser->buf + parser->buf_len, data + i, chunk); // Copie à la suite des en-têtes
+            parser->buf_len += (uint16_t)chunk;                     // Met à jour l'occupation
+        }
+        parser->body_received += chunk;                              // Met à jour le compteur
+        i += chunk;                                                  // Octets consommés
+        if (parser->body_received >= parser->request.content_length) // Corps complet
+        {
+            parser->state = HTTP_PARSER_COMPLETE;
+            if (!parser->on_body && (uint32_t)(parser->buf_len - parser->body_start) == parser->body_received) // Corps entièrement conservé
+            {
+                parser->request.body = parser->buf + parser->body_start;  // Vue sur le corps
+                parser->request.body_len = (uint16_t)parser->body_received; // Taille du corps
+            }
+            else if (!parser->on_body) // Corps trop long pour le parseur
+            {
+                ESP01_LOG_WARN("HTTP", "Corps de %lu octets ignoré (conn %d) : utiliser esp01_add_route_stream", (unsigned long)parser->body_received, parser->conn_id);
+            }
+        }
+    }
+    return i; // Retourne le nombre d'octets consommés
 }
 
 /**
- * @brief Retourne l'adresse IP du client pour une connexion.
- * @param conn_id  Identifiant de connexion.
- * @retval Pointeur vers la chaîne IP, ou "N/A".
+ * @brief Recherche un en-tête dans une requête parsée (lecture à la demande).
+ * @param req       Requête parsée.
+ * @param name      Nom de l'en-tête (insensible à la casse).
+ * @param value_len Longueur de la valeur trouvée (optionnel).
+ * @retval Pointeur vers la valeur (non terminée par '\0'), ou NULL si absent.
  */
-const char *esp01_http_get_client_ip(int conn_id)
+const char *esp01_http_get_header(const http_parsed_request_t *req, const char *name, size_t *value_len)
 {
-    if (conn_id < 0 || conn_id >= ESP01_MAX_CONNECTIONS)                                                    // Vérifie les bornes
-        return "N/A";                                                                                       // Retourne "N/A" si hors bornes
-    if (!g_connections[conn_id].is_active || !g_connections[conn_id].client_ip[0])                          // Vérifie l'état et la présence d'une IP
-        return "N/A";                                                                                       // Retourne "N/A" si pas d'IP
-    ESP01_LOG_DEBUG("HTTP", "IP client pour connexion %d : %s", conn_id, g_connections[conn_id].client_ip); // Log l'IP
-    return g_connections[conn_id].client_ip;                                                                // Retourne l'IP
+    VALIDATE_PARAM(req && name, NULL); // Vérifie les paramètres
+    if (!req->headers)                 // Pas de bloc d'en-têtes (parsing simple)
+    {
+        return NULL;
+    }
+
+    size_t name_len = strlen(name);                         // Longueur du nom recherché
+    const char *p = req->headers;                           // Début du bloc
+    const char *end = req->headers + req->headers_len;      // Fin du bloc
+    while (p < end)                                         // Parcourt les lignes
+    {
+        const char *eol = memchr(p, '\n', end - p);         // Fin de la ligne courante
+        const char *line_end = eol ? eol : end;             // Borne de la ligne
+        if ((size_t)(line_end - p) > name_len && p[name_len] == ':' && _http_equals_nocase(p, name, name_len)) // Nom trouvé
+        {
+            const char *v = p + name_len + 1;               // Début de la valeur
+            while (v < line_end && (*v == ' ' || *v == '\t')) // Ignore les espaces de tête
+            {
+                v++;
+            }
+            const char *v_end = line_end;                   // Fin de la valeur
+            while (v_end > v && (v_end[-1] == '\r' || v_end[-1] == ' ' || v_end[-1] == '\t')) // Ignore CR et espaces de fin
+            {
+                v_end--;
+            }
+            if (value_len)
+            {
+                *value_len = v_end - v; // Longueur de la valeur
+            }
+            return v;                   // Retourne la vue sur la valeur
+        }
+        p = line_end + 1; // Ligne suivante
+    }
+    return NULL; // En-tête absent
 }
 
 /**
- * @brief Affiche l'état des connexions actives (log debug).
+ * @brief Copie la valeur d'un en-tête dans un buffer terminé par '\0'.
+ * @param req      Requête parsée.
+ * @param name     Nom de l'en-tête.
+ * @param out      Buffer de sortie.
+ * @param out_size Taille du buffer.
+ * @retval ESP01_Status_t Code de statut.
  */
-void esp01_print_connection_status(void)
+ESP01_Status_t esp01_http_copy_header(const http_parsed_request_t *req, const char *name, char *out, size_t out_size)
 {
-    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i) // Parcours toutes les connexions
+    VALIDATE_PARAM(req && name && out && out_size > 0, ESP01_INVALID_PARAM); // Vérifie les paramètres
+    size_t len = 0;                                                         // Longueur de la valeur
+    const char *value = esp01_http_get_header(req, name, &len);            // Recherche l'en-tête
+    out[0] = '\0';                                                          // Sortie vide par défaut
+    if (!value)                                                             // En-tête absent
     {
-        if (g_connections[i].is_active)                                                             // Si la connexion est active
-            ESP01_LOG_DEBUG("HTTP", "Connexion %d active, IP : %s", i, g_connections[i].client_ip); // Log l'état de la connexion
+        return ESP01_FAIL;
     }
+    if (esp01_check_buffer_size(len, out_size - 1) != ESP01_OK) // Vérifie la place disponible
+    {
+        return ESP01_BUFFER_OVERFLOW;
+    }
+    memcpy(out, value, len); // Copie la valeur
+    out[len] = '\0';         // Termine la chaîne
+    return ESP01_OK;         // Retourne OK
 }
 
-// ==================== TRAITEMENT AUTOMATIQUE DES REQUÊTES ====================
+// ==================== EXTRACTION DE CHAMPS (FORMULAIRE / JSON) ====================
 
 /**
- * @brief Traite automatiquement les requêtes HTTP reçues (DMA accumulateur).
+ * @brief Retourne la valeur d'un chiffre hexadécimal.
+ * @param c Caractère.
+ * @retval Valeur 0..15, ou -1 si invalide.
  */
-void esp01_process_requests(void)
+static int _http_hex_value(char c)
 {
-    if (g_processing_request) // Si un traitement est déjà en cours
-        return;               // Sort sans rien faire
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
 
-    g_processing_request = 1; // Marque le début du traitement
+/**
+ * @brief Initialise un itérateur clé/valeur sur des données urlencodées.
+ * @param it    Itérateur.
+ * @param data  Données (clé=valeur&...), non modifiées.
+ * @param len   Taille des données.
+ */
+void esp01_http_kv_iter_init(esp01_http_kv_iter_t *it, const char *data, size_t len)
+{
+    VALIDATE_PARAM_VOID(it);        // Vérifie le paramètre
+    it->pos = data;                 // Début des données
+    it->end = data ? data + len : NULL; // Fin des données
+}
+
+/**
+ * @brief Indique si une portion urlencodée contient des séquences à décoder.
+ */
+static bool _http_kv_is_encoded(const char *p, size_t len)
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        if (p[i] == '%' || p[i] == '+') // Séquence %XX ou espace encodé
+        {
+            return true;
+        }
+    }
+    return false;
+}
 
-    // --- Lecture UART automatique (DMA accumulateur) ---
-    uint8_t buffer[ESP01_DMA_RX_BUF_SIZE];                     // Buffer temporaire pour la lecture UART
-    uint16_t len = esp01_get_new_data(buffer, sizeof(buffer)); // Récupère les nouveaux octets reçus
-    if (len > 0)                                               // Si des données ont été reçues
+/**
+ * @brief Avance l'itérateur sur la paire clé/valeur suivante.
+ * @param it  Itérateur.
+ * @param kv  Paire de sortie (vues dans les données d'origine).
+ * @retval true si une paire a été trouvée, false en fin de données.
+ */
+bool esp01_http_kv_next(esp01_http_kv_iter_t *it, esp01_http_kv_t *kv)
+{
+    VALIDATE_PARAM(it && kv, false); // Vérifie les paramètres
+    while (it->pos && it->pos < it->end)
     {
-        if ((g_acc_len + len) < (int)sizeof(g_accumulator) - 1) // Vérifie qu'il reste de la place dans l'accumulateur
+        const char *p = it->pos;                          // Début de la paire
+        const char *amp = memchr(p, '&', it->end - p);    // Fin de la paire
+        const char *pair_end = amp ? amp : it->end;       // Borne de la paire
+        it->pos = amp ? amp + 1 : it->end;                // Paire suivante
+        if (pair_end == p)                                // Paire vide ("&&")
         {
-            memcpy(g_accumulator + g_acc_len, buffer, len);                                               // Ajoute les données à l'accumulateur
-            g_acc_len += len;                                                                             // Met à jour la longueur totale
-            g_accumulator[g_acc_len] = '\0';                                                              // Termine la chaîne
-            ESP01_LOG_DEBUG("HTTP", "Ajout de %d octets dans l'accumulateur (total=%d)", len, g_acc_len); // Log l'ajout
+            continue;
         }
-        else
+        const char *eq = memchr(p, '=', pair_end - p);    // Séparateur clé/valeur
+        kv->key = p;                                      // Vue sur la clé
+        kv->key_len = (uint16_t)((eq ? eq : pair_end) - p); // Longueur de la clé
+        kv->value = eq ? eq + 1 : pair_end;               // Vue sur la valeur (vide si pas de '=')
+        kv->value_len = (uint16_t)(pair_end - kv->value); // Longueur de la valeur
+        kv->encoded = _http_kv_is_encoded(kv->key, kv->key_len) || _http_kv_is_encoded(kv->value, kv->value_len); // Décodage nécessaire ?
+        return true;
+    }
+    return false; // Fin des données
+}
+
+/**
+ * @brief Décode une portion urlencodée (%XX et '+') dans un buffer terminé par '\0'.
+ * @param src      Portion encodée (clé ou valeur).
+ * @param len      Taille de la portion.
+ * @param out      Buffer de sortie.
+ * @param out_size Taille du buffer.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_kv_decode(const char *src, size_t len, char *out, size_t out_size)
+{
+    VALIDATE_PARAM((src || len == 0) && out && out_size > 0, ESP01_INVALID_PARAM); // Vérifie les paramètres
+    size_t o = 0;                                                                  // Position d'écriture
+    for (size_t i = 0; i < len; ++i)                                               // Parcourt la portion encodée
+    {
+        char c = src[i]; // Caractère courant
+        if (c == '+')    // Espace encodé
+        {
+            c = ' ';
+        }
+        else if (c == '%' && i + 2 < len && _http_hex_value(src[i + 1]) >= 0 && _http_hex_value(src[i + 2]) >= 0) // Séquence %XX
+        {
+            c = (char)((_http_hex_value(src[i + 1]) << 4) | _http_hex_value(src[i + 2])); // Octet décodé
+            i += 2;                                                                     // Passe les deux chiffres
+        }
+        if (o + 1 >= out_size) // Plus de place pour le caractère et le '\0'
         {
-            ESP01_LOG_ERROR("HTTP", "Dépassement du buffer accumulateur HTTP (g_acc_len=%d, len=%d)", g_acc_len, len); // Log le dépassement
-            g_acc_len = 0;                                                                                             // Réinitialise la longueur
-            g_accumulator[0] = '\0';                                                                                   // Vide le buffer
+            out[o] = '\0';
+            return ESP01_BUFFER_OVERFLOW;
         }
+        out[o++] = c; // Écrit le caractère décodé
     }
+    out[o] = '\0';   // Termine la chaîne
+    return ESP01_OK; // Retourne OK
+}
 
-    // --- Traitement des paquets +IPD ---
-    char *ipd_ptr = _find_next_ipd(g_accumulator, g_acc_len); // Recherche le prochain +IPD dans l'accumulateur
-    while (ipd_ptr)                                           // Tant qu'un +IPD est trouvé
+/**
+ * @brief Compare une portion urlencodée à une chaîne en clair, sans la copier.
+ * @param src   Portion encodée.
+ * @param len   Taille de la portion.
+ * @param plain Chaîne en clair.
+ * @retval true si la portion décodée est égale à plain.
+ */
+bool esp01_http_kv_equals(const char *src, size_t len, const char *plain)
+{
+    VALIDATE_PARAM((src || len == 0) && plain, false); // Vérifie les paramètres
+    for (size_t i = 0; i < len; ++i, ++plain)         // Décode au fil de la comparaison
     {
-        http_request_t ipd = parse_ipd_header(ipd_ptr); // Parse l'en-tête +IPD
-        if (ipd.is_valid)                               // Si le parsing est valide
+        char c = src[i];
+        if (c == '+')
         {
-            // --- MISE À JOUR DE LA CONNEXION ---
-            connection_info_t *conn = &g_connections[ipd.conn_id];                          // Récupère la structure de connexion
-            conn->conn_id = ipd.conn_id;                                                    // Met à jour l'identifiant
-            conn->is_active = true;                                                         // Marque la connexion comme active
-            conn->last_activity = HAL_GetTick();                                            // Met à jour le timestamp d'activité
-            if (ipd.has_ip)                                                                 // Si l'IP est présente
-                esp01_safe_strcpy(conn->client_ip, sizeof(conn->client_ip), ipd.client_ip); // Copie l'IP
-            else
-                conn->client_ip[0] = 0;          // Vide la chaîne IP
-            conn->client_port = ipd.client_port; // Met à jour le port client
-            // --- FIN MISE À JOUR ---
+            c = ' ';
+        }
+        else if (c == '%' && i + 2 < len && _http_hex_value(src[i + 1]) >= 0 && _http_hex_value(src[i + 2]) >= 0)
+        {
+            c = (char)((_http_hex_value(src[i + 1]) << 4) | _http_hex_value(src[i + 2]));
+            i += 2;
+        }
+        if (*plain != c) // Différence (ou plain plus courte)
+        {
+            return false;
+        }
+    }
+    return *plain == '\0'; // Même longueur
+}
+
+/**
+ * @brief Recherche une clé dans des données urlencodées.
+ * @param data Données (clé=valeur&...).
+ * @param len  Taille des données.
+ * @param key  Clé recherchée (en clair).
+ * @param kv   Paire trouvée (optionnel).
+ * @retval true si la clé est présente.
+ */
+bool esp01_http_kv_find(const char *data, size_t len, const char *key, esp01_http_kv_t *kv)
+{
+    VALIDATE_PARAM(key, false); // Vérifie le paramètre
+    esp01_http_kv_iter_t it;    // Itérateur
+    esp01_http_kv_t cur;        // Paire courante
+    esp01_http_kv_iter_init(&it, data, len);
+    while (esp01_http_kv_next(&it, &cur)) // Parcourt les paires
+    {
+        if (esp01_http_kv_equals(cur.key, cur.key_len, key)) // Clé trouvée
+        {
+            if (kv)
+            {
+                *kv = cur;
+            }
+            return true;
+        }
+    }
+    return false; // Clé absente
+}
+
+/**
+ * @brief Extrait un champ d'un corps application/x-www-form-urlencoded.
+ * @param data     Données (clé=valeur&...).
+ * @param len      Taille des données.
+ * @param key      Clé recherchée.
+ * @param out      Buffer de sortie (valeur décodée).
+ * @param out_size Taille du buffer.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_form_get(const char *data, size_t len, const char *key, char *out, size_t out_size)
+{
+    VALIDATE_PARAM((data || len == 0) && key && out && out_size > 0, ESP01_INVALID_PARAM); // Vérifie les paramètres
+    out[0] = '\0';                                                                         // Sortie vide par défaut
+
+    esp01_http_kv_t kv;                           // Paire trouvée
+    if (!esp01_http_kv_find(data, len, key, &kv)) // Recherche la clé
+    {
+        return ESP01_FAIL;                        // Clé absente
+    }
+    return esp01_http_kv_decode(kv.value, kv.value_len, out, out_size); // Décode la valeur
+}
+
+/**
+ * @brief Saute les espaces JSON.
+ */
+static const char *_http_json_skip_ws(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+    {
+        p++;
+    }
+    return p;
+}
 
-            char *data_start = strchr(ipd_ptr, ':');                                                // Recherche le début des données HTTP
-            if (data_start && (g_acc_len - (data_start - g_accumulator) - 1) >= ipd.content_length) // Vérifie que toutes les données sont présentes
+/**
+ * @brief Saute une chaîne JSON (p pointe sur le '"' ouvrant).
+ * @retval Pointeur après le '"' fermant, ou NULL si chaîne non terminée.
+ */
+static const char *_http_json_skip_string(const char *p, const char *end)
+{
+    for (p++; p < end; ++p) // Parcourt la chaîne
+    {
+        if (*p == '\\') // Caractère échappé
+        {
+            p++;
+        }
+        else if (*p == '"') // Fin de chaîne
+        {
+            return p + 1;
+        }
+    }
+    return NULL; // Chaîne non terminée
+}
+
+/**
+ * @brief Saute une valeur JSON (chaîne, objet, tableau ou scalaire).
+ * @retval Pointeur après la valeur, ou NULL si JSON invalide.
+ */
+static const char *_http_json_skip_value(const char *p, const char *end)
+{
+    if (p >= end)
+    {
+        return NULL;
+    }
+    if (*p == '"') // Chaîne
+    {
+        return _http_json_skip_string(p, end);
+    }
+    if (*p == '{' || *p == '[') // Objet ou tableau : suit la profondeur
+    {
+        int depth = 0;
+        while (p < end)
+        {
+            if (*p == '"') // Chaîne imbriquée
+            {
+                p = _http_json_skip_string(p, end);
+                if (!p)
+                {
+                    return NULL;
+                }
+                continue;
+            }
+            if (*p == '{' || *p == '[')
+            {
+                depth++;
+            }
+            else if (*p == '}' || *p == ']')
             {
-                data_start++;                                     // Passe le ':'
-                char http_buf[ESP01_MAX_TOTAL_HTTP] = {0};        // Buffer pour la requête HTTP brute
-                memcpy(http_buf, data_start, ipd.content_length); // Copie la requête HTTP
-                http_buf[ipd.content_length] = 0;                 // Termine la chaîne
-                esp01_trim_string(http_buf);                      // Supprime les espaces superflus
+                if (--depth == 0) // Fin de la valeur composée
+                {
+                    return p + 1;
+                }
+            }
+            p++;
+        }
+        return NULL; // Valeur non terminée
+    }
+    const char *start = p;                                                                          // Scalaire (nombre, true, false, null)
+    while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\r' && *p != '\n' && *p != '\t')
+    {
+        p++;
+    }
+    return (p > start) ? p : NULL;
+}
+
+/**
+ * @brief Extrait un champ de premier niveau d'un objet JSON.
+ * @param json     Texte JSON.
+ * @param len      Taille du texte.
+ * @param key      Clé recherchée.
+ * @param out      Buffer de sortie.
+ * @param out_size Taille du buffer.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_json_get(const char *json, size_t len, const char *key, char *out, size_t out_size)
+{
+    VALIDATE_PARAM((json || len == 0) && key && out && out_size > 0, ESP01_INVALID_PARAM); // Vérifie les paramètres
+    out[0] = '\0';                                                                         // Sortie vide par défaut
+
+    size_t key_len = strlen(key);              // Longueur de la clé
+    const char *end = json + len;              // Fin du texte
+    const char *p = _http_json_skip_ws(json, end); // Début de l'objet
+    if (p >= end || *p != '{')                 // Objet attendu
+    {
+        return ESP01_PARSE_ERROR;
+    }
+    p++;
 
-                ESP01_LOG_DEBUG("HTTP", "IPD reçu (brut) :\n%s", http_buf); // Log la requête brute
+    while (1) // Parcourt les membres de l'objet
+    {
+        p = _http_json_skip_ws(p, end);
+        if (p < end && *p == '}') // Fin de l'objet
+        {
+            return ESP01_FAIL;
+        }
+        if (p >= end || *p != '"') // Clé attendue
+        {
+            return ESP01_PARSE_ERROR;
+        }
+        const char *k = p + 1;                   // Début de la clé
+        p = _http_json_skip_string(p, end);      // Fin de la clé
+        if (!p)
+        {
+            return ESP01_PARSE_ERROR;
+        }
+        size_t k_len = (size_t)(p - 1 - k);      // Longueur de la clé
+        p = _http_json_skip_ws(p, end);
+        if (p >= end || *p != ':') // Séparateur attendu
+        {
+            return ESP01_PARSE_ERROR;
+        }
+        p = _http_json_skip_ws(p + 1, end);
+        const char *v = p;                    // Début de la valeur
+        p = _http_json_skip_value(p, end);    // Fin de la valeur
+        if (!p)
+        {
+            return ESP01_PARSE_ERROR;
+        }
 
-                http_parsed_request_t req; // Structure pour la requête parsée
-                if (esp01_parse_http_request(http_buf, &req) == ESP01_OK && req.is_valid)
+        if (k_len == key_len && memcmp(k, key, key_len) == 0) // Clé trouvée
+        {
+            if (*v != '"') // Nombre, booléen, null, objet ou tableau : texte brut
+            {
+                if (esp01_check_buffer_size((size_t)(p - v), out_size - 1) != ESP01_OK)
+                {
+                    return ESP01_BUFFER_OVERFLOW;
+                }
+                memcpy(out, v, p - v);
+                out[p - v] = '\0';
+                return ESP01_OK;
+            }
+            size_t o = 0;                                  // Chaîne : désescape
+            for (const char *c = v + 1; c < p - 1; ++c)
+            {
+                char ch = *c;
+                if (ch == '\\') // Séquence d'échappement
                 {
-                    if (strcmp(req.path, "/favicon.ico") == 0)
+                    ch = *++c;
+                    if (ch == 'n')
+                    {
+                        ch = '\n';
+                    }
+                    else if (ch == 't')
                     {
-                        ESP01_LOG_DEBUG("HTTP", "favicon.ico demandé, réponse 204 No Content");
-                        esp01_send_http_response(ipd.conn_id, 204, "image/x-icon", NULL, 0);
-                        goto cleanup;
+                        ch = '\t';
                     }
-                    else
+                    else if (ch == 'r')
                     {
-                        ESP01_LOG_DEBUG("HTTP", "Appel du handler pour la route : %s", req.path);
-                        esp01_route_handler_t handler = esp01_find_route_handler(req.path);
-                        if (handler)
-                            handler(ipd.conn_id, &req);
-                        else
-                            esp01_send_404_response(ipd.conn_id);
+                        ch = '\r';
+                    }
+                    else if (ch == 'b')
+                    {
+                        ch = '\b';
+                    }
+                    else if (ch == 'f')
+                    {
+                        ch = '\f';
+                    }
+                    else if (ch == 'u') // \uXXXX : ASCII conservé, '?' sinon
+                    {
+                        int cp = 0;
+                        for (int h = 1; h <= 4 && c + h < p - 1; ++h)
+                        {
+                            cp = (cp << 4) | (_http_hex_value(c[h]) & 0xF);
+                        }
+                        c += 4;
+                        ch = (cp > 0 && cp < 0x80) ? (char)cp : '?';
                     }
                 }
-                else
+                if (o + 1 >= out_size) // Plus de place
                 {
-                    ESP01_LOG_DEBUG("HTTP", "Parsing HTTP échoué, envoi d'une 404");
-                    esp01_send_404_response(ipd.conn_id);
+                    out[o] = '\0';
+                    return ESP01_BUFFER_OVERFLOW;
                 }
-
-            cleanup:
-                int to_remove = (data_start - g_accumulator) + ipd.content_length;        // Calcule le nombre d'octets à retirer de l'accumulateur
-                memmove(g_accumulator, g_accumulator + to_remove, g_acc_len - to_remove); // Décale le buffer pour supprimer la requête traitée
-                g_acc_len -= to_remove;                                                   // Met à jour la longueur de l'accumulateur
-                ipd_ptr = _find_next_ipd(g_accumulator, g_acc_len);                       // Recherche le prochain +IPD
-                continue;                                                                 // Passe à la prochaine itération
+                out[o++] = ch;
             }
+            out[o] = '\0';
+            return ESP01_OK;
+        }
+
+        p = _http_json_skip_ws(p, end);
+        if (p < end && *p == ',') // Membre suivant
+        {
+            p++;
+            continue;
+        }
+        if (p < end && *p == '}') // Fin de l'objet
+        {
+            return ESP01_FAIL;
         }
-        break; // Sort de la boucle si pas de +IPD complet
+        return ESP01_PARSE_ERROR;
+    }
+}
+
+// ==================== ENVOI DE RÉPONSES ====================
+
+/**
+ * @brief Envoie une réponse JSON sur la connexion spécifiée.
+ * @param conn_id  Identifiant de connexion.
+ * @param json     Chaîne JSON à envoyer.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_send_json_response(int conn_id, const char *json)
+{
+    ESP01_LOG_DEBUG("HTTP", "Envoi d'une réponse JSON sur connexion %d", conn_id);                        // Log l'envoi JSON
+    return esp01_send_http_response(conn_id, ESP01_HTTP_OK_CODE, "application/json", json, strlen(json)); // Envoie la réponse HTTP avec le JSON
+}
+
+/**
+ * @brief Envoie une réponse 404 Not Found sur la connexion spécifiée.
+ * @param conn_id  Identifiant de connexion.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_send_404_response(int conn_id)
+{
+    ESP01_LOG_DEBUG("HTTP", "404 Not Found envoyé sur connexion %d", conn_id);                            // Log l'envoi 404
+    const char *body = "<html><body><h1>404 Not Found</h1></body></html>";                                // Corps HTML pour la 404
+    return esp01_send_http_response(conn_id, ESP01_HTTP_NOT_FOUND_CODE, "text/html", body, strlen(body)); // Envoie la réponse HTTP 404
+}
+
+/**
+ * @brief Retourne le texte associé à un code HTTP.
+ * @param status_code Code HTTP.
+ * @retval const char* Texte du statut.
+ */
+static const char *_http_status_text(int status_code)
+{
+    switch (status_code) // Sélectionne le texte selon le code
+    {
+    case ESP01_HTTP_OK_CODE:
+        return "OK"; // 200
+    case ESP01_HTTP_NO_CONTENT_CODE:
+        return "No Content"; // 204
+    case ESP01_HTTP_PARTIAL_CONTENT_CODE:
+        return "Partial Content"; // 206
+    case ESP01_HTTP_BAD_REQUEST_CODE:
+        return "Bad Request"; // 400
+    case ESP01_HTTP_NOT_FOUND_CODE:
+        return "Not Found"; // 404
+    case ESP01_HTTP_METHOD_NOT_ALLOWED_CODE:
+        return "Method Not Allowed"; // 405
+    case ESP01_HTTP_CONFLICT_CODE:
+        return "Conflict"; // 409
+    case ESP01_HTTP_LENGTH_REQUIRED_CODE:
+        return "Length Required"; // 411
+    case ESP01_HTTP_PAYLOAD_TOO_LARGE_CODE:
+        return "Payload Too Large"; // 413
+    case ESP01_HTTP_RANGE_NOT_SATISFIABLE_CODE:
+        return "Range Not Satisfiable"; // 416
+    case ESP01_HTTP_TOO_MANY_REQUESTS_CODE:
+        return "Too Many Requests"; // 429
+    case ESP01_HTTP_INTERNAL_ERR_CODE:
+        return "Internal Server Error"; // 500
+    case ESP01_HTTP_UNAVAILABLE_CODE:
+        return "Service Unavailable"; // 503
+    default:
+        return "Unknown"; // Autre
+    }
+}
+
+/**
+ * @brief Indique si le lien reste ouvert après la réponse à la requête en cours.
+ * @param conn_id Identifiant de connexion.
+ * @retval false si le client a demandé "Connection: close" ou si la requête est invalide.
+ * @note  HTTP/1.1 : keep-alive par défaut. Les délais d'inactivité et l'éviction LRU
+ *        (esp01_http_set_link_policy) ferment ensuite les liens au repos.
+ */
+static bool _http_keep_alive(int conn_id)
+{
+    const connection_info_t *conn = &g_connections[conn_id];
+    if (!conn->in_handler) // Réponse hors requête (push, flux) : lien conservé
+    {
+        return true;
+    }
+    if (conn->parser.state == HTTP_PARSER_ERROR) // Requête invalide : flux désynchronisé
+    {
+        return false;
     }
+    size_t len = 0;
+    const char *value = esp01_http_get_header(&conn->parser.request, "Connection", &len);
+    return !(value && len == strlen("close") && _http_equals_nocase(value, "close", len));
+}
+
+/**
+ * @brief En-tête Connection des réponses du serveur (politique unique).
+ * @param conn_id Identifiant de connexion.
+ * @retval Ligne d'en-tête, fin de ligne comprise.
+ */
+static const char *_http_connection_header(int conn_id)
+{
+    return _http_keep_alive(conn_id) ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+}
+
+/**
+ * @brief Met à jour les statistiques HTTP après l'envoi d'une réponse.
+ * @param status_code Code HTTP envoyé.
+ * @param start       Timestamp de début de la réponse.
+ */
+static void _http_record_stats(int status_code, uint32_t start)
+{
+    g_stats.total_requests++;                                   // Incrémente le nombre total de requêtes
+    g_stats.response_count++;                                   // Incrémente le nombre de réponses envoyées
+    if (status_code >= ESP01_HTTP_OK_CODE && status_code < 300) // Si code 2xx
+    {
+        g_stats.successful_responses++;                         // Incrémente les réponses réussies
+    }
+    else if (status_code >= 400)                                // Si code 4xx ou 5xx
+    {
+        g_stats.failed_responses++;                             // Incrémente les réponses échouées
+    }
+
+    uint32_t elapsed = HAL_GetTick() - start;                                                                              // Calcule le temps de réponse
+    g_stats.total_response_time_ms += elapsed;                                                                             // Ajoute au temps total
+    g_stats.avg_response_time_ms = g_stats.response_count ? (g_stats.total_response_time_ms / g_stats.response_count) : 0; // Met à jour la moyenne
+}
+
+/**
+ * @brief Attend un évènement AT en continuant à lire le flux RX.
+ * @param mask       Évènements attendus (ESP01_HTTP_EVT_*).
+ * @param timeout_ms Timeout (ms).
+ * @retval ESP01_Status_t ESP01_OK si un évènement du masque est arrivé, ESP01_TIMEOUT sinon.
+ * @note  Contrairement à esp01_wait_for_pattern, les trames +IPD reçues pendant
+ *        l'attente sont conservées et transmises aux parseurs des liens.
+ */
+static ESP01_Status_t _http_wait_event(uint8_t mask, uint32_t timeout_ms)
+{
+    uint32_t start = HAL_GetTick(); // Timestamp de départ
+    while ((HAL_GetTick() - start) < timeout_ms)
+    {
+        _http_scan_rx();              // Traite les octets reçus
+        if (g_http_rx_events & mask) // Évènement attendu
+        {
+            return ESP01_OK;
+        }
+        HAL_Delay(1); // Petite pause CPU
+    }
+    return ESP01_TIMEOUT;
+}
+
+// ==================== CACHE DE RÉPONSES ====================
+
+/**
+ * @brief Construit la clé de cache d'une requête (chemin + "?" + query string).
+ * @param req Requête parsée.
+ * @param key Buffer de sortie (ESP01_HTTP_CACHE_KEY_LEN).
+ * @retval true si la clé tient dans le buffer.
+ */
+static bool _http_cache_key(const http_parsed_request_t *req, char *key)
+{
+    size_t path_len = strlen(req->path);
+    if (path_len + 1 + req->query_len >= ESP01_HTTP_CACHE_KEY_LEN) // Query trop longue : pas de cache
+    {
+        return false;
+    }
+    memcpy(key, req->path, path_len);
+    key[path_len] = '?';
+    memcpy(key + path_len + 1, req->query_string, req->query_len); // Vue dans le parseur, non terminée
+    key[path_len + 1 + req->query_len] = '\0';
+    return true;
+}
+
+/**
+ * @brief Libère l'entrée la plus ancienne du cache (et ses octets du pool).
+ */
+static void _http_cache_evict_first(void)
+{
+    _http_cache_entry_t *e = &g_http_cache[g_http_cache_first];
+    g_http_cache_head = (uint16_t)((g_http_cache_head + e->len) % ESP01_HTTP_CACHE_POOL_SIZE); // Les entrées se suivent dans le pool
+    g_http_cache_used -= e->len;
+    e->valid = false;
+    g_http_cache_first = (uint8_t)((g_http_cache_first + 1) % ESP01_HTTP_CACHE_MAX_ENTRIES);
+    g_http_cache_count--;
+}
+
+/**
+ * @brief Retourne l'entrée en cours de capture (la plus récente).
+ */
+static _http_cache_entry_t *_http_cache_last(void)
+{
+    return &g_http_cache[(g_http_cache_first + g_http_cache_count - 1) % ESP01_HTTP_CACHE_MAX_ENTRIES];
+}
+
+/**
+ * @brief Recherche une réponse valide et non expirée.
+ * @param key Clé de la requête.
+ * @retval Entrée trouvée, ou NULL.
+ */
+static _http_cache_entry_t *_http_cache_lookup(const char *key)
+{
+    for (uint8_t i = 0; i < g_http_cache_count; i++)
+    {
+        _http_cache_entry_t *e = &g_http_cache[(g_http_cache_first + i) % ESP01_HTTP_CACHE_MAX_ENTRIES];
+        if (!e->valid || strcmp(e->key, key) != 0)
+        {
+            continue;
+        }
+        if ((int32_t)(HAL_GetTick() - e->expires) >= 0) // TTL écoulé
+        {
+            e->valid = false; // Octets libérés à la prochaine éviction
+            return NULL;
+        }
+        return e;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Démarre la capture de la réponse d'un lien dans une nouvelle entrée.
+ * @param conn_id Lien dont la réponse est capturée.
+ * @param key     Clé de la requête.
+ * @retval true si la capture est démarrée.
+ * @note  Une seule capture à la fois, jamais pendant l'envoi d'une réponse du
+ *        pool (l'éviction écraserait des octets en cours d'émission).
+ */
+static bool _http_cache_begin(int conn_id, const char *key)
+{
+    if (g_http_cache_conn >= 0 || g_http_cache_replaying) // Handler imbriqué : pas de capture
+    {
+        return false;
+    }
+    if (g_http_cache_count == ESP01_HTTP_CACHE_MAX_ENTRIES) // Plus d'entrée libre
+    {
+        _http_cache_evict_first();
+    }
+    _http_cache_entry_t *e = &g_http_cache[(g_http_cache_first + g_http_cache_count) % ESP01_HTTP_CACHE_MAX_ENTRIES];
+    esp01_safe_strcpy(e->key, sizeof(e->key), key);
+    e->off = (uint16_t)((g_http_cache_head + g_http_cache_used) % ESP01_HTTP_CACHE_POOL_SIZE); // Suite du pool
+    e->len = 0;
+    e->valid = false; // Invisible tant que la réponse n'est pas complète
+    g_http_cache_count++;
+    g_http_cache_conn = (int8_t)conn_id;
+    g_http_cache_failed = false;
+    return true;
+}
+
+/**
+ * @brief Copie dans l'entrée en capture des octets écrits sur le lien capturé.
+ * @param data Octets.
+ * @param len  Taille.
+ */
+static void _http_cache_capture(const char *data, size_t len)
+{
+    if (g_http_cache_failed)
+    {
+        return;
+    }
+    while ((size_t)(ESP01_HTTP_CACHE_POOL_SIZE - g_http_cache_used) < len) // Libère les réponses les plus anciennes
+    {
+        if (g_http_cache_count <= 1) // Seule reste l'entrée capturée : réponse trop grande
+        {
+            g_http_cache_failed = true;
+            return;
+        }
+        _http_cache_evict_first();
+    }
+    size_t tail = (g_http_cache_head + g_http_cache_used) % ESP01_HTTP_CACHE_POOL_SIZE;
+    size_t first = ESP01_HTTP_CACHE_POOL_SIZE - tail; // Place avant le rebouclage
+    if (first > len)
+    {
+        first = len;
+    }
+    memcpy(g_http_cache_pool + tail, data, first);
+    memcpy(g_http_cache_pool, data + first, len - first);
+    g_http_cache_used += (uint16_t)len;
+    _http_cache_last()->len += (uint16_t)len;
+}
+
+/**
+ * @brief Termine la capture : l'entrée devient valide si la réponse est un 200 complet.
+ * @param ttl_ms Durée de vie de la réponse.
+ */
+static void _http_cache_end(uint32_t ttl_ms)
+{
+    static const char ok_status[] = "HTTP/1.1 200 "; // Seules les réponses 200 sont rejouées
+    _http_cache_entry_t *e = _http_cache_last();
+    bool ok = !g_http_cache_failed && e->len >= sizeof(ok_status) - 1;
+    for (size_t i = 0; ok && i < sizeof(ok_status) - 1; i++) // Début de la réponse (peut reboucler)
+    {
+        ok = (g_http_cache_pool[(e->off + i) % ESP01_HTTP_CACHE_POOL_SIZE] == (uint8_t)ok_status[i]);
+    }
+    g_http_cache_conn = -1;
+    if (!ok) // Entrée abandonnée : ses octets sont les derniers du pool
+    {
+        g_http_cache_used -= e->len;
+        g_http_cache_count--;
+        return;
+    }
+    for (uint8_t i = 0; i + 1 < g_http_cache_count; i++) // Remplace une réponse plus ancienne de même clé
+    {
+        _http_cache_entry_t *old = &g_http_cache[(g_http_cache_first + i) % ESP01_HTTP_CACHE_MAX_ENTRIES];
+        if (old->valid && strcmp(old->key, e->key) == 0)
+        {
+            old->valid = false;
+        }
+    }
+    e->expires = HAL_GetTick() + ttl_ms;
+    e->valid = true;
+    ESP01_LOG_DEBUG("HTTP", "Cache : %s conservé (%u octets, %lu ms)", e->key, e->len, (unsigned long)ttl_ms);
+}
+
+/**
+ * @brief Envoie une réponse du cache sur un lien.
+ * @param conn_id Identifiant de connexion.
+ * @param e       Entrée valide.
+ * @retval ESP01_Status_t Code de statut.
+ */
+static ESP01_Status_t _http_cache_send(int conn_id, const _http_cache_entry_t *e)
+{
+    size_t first = ESP01_HTTP_CACHE_POOL_SIZE - e->off; // Octets avant le rebouclage
+    if (first > e->len)
+    {
+        first = e->len;
+    }
+    esp01_tx_part_t parts[2] = {{(const char *)g_http_cache_pool + e->off, first}, {(const char *)g_http_cache_pool, e->len - first}};
+    g_http_cache_replaying++; // Aucune éviction tant que les octets sont lus
+    ESP01_Status_t st = _http_link_write(conn_id, parts, 2);
+    g_http_cache_replaying--;
+    return st;
+}
+
+/**
+ * @brief Invalide les réponses en cache d'une route (toutes query strings).
+ * @param path Chemin de la route, ou NULL pour vider tout le cache.
+ */
+void esp01_http_cache_invalidate(const char *path)
+{
+    size_t path_len = path ? strlen(path) : 0;
+    for (uint8_t i = 0; i < g_http_cache_count; i++)
+    {
+        _http_cache_entry_t *e = &g_http_cache[(g_http_cache_first + i) % ESP01_HTTP_CACHE_MAX_ENTRIES];
+        if (!path || (strncmp(e->key, path, path_len) == 0 && e->key[path_len] == '?')) // Même chemin, toute query
+        {
+            e->valid = false;
+        }
+    }
+}
+
+// ==================== FILES D'ÉMISSION PAR LIEN ====================
+
+/**
+ * @brief Ajoute des octets à la file d'émission d'un lien.
+ * @param conn Connexion.
+ * @param data Données.
+ * @param len  Taille.
+ * @retval Nombre d'octets ajoutés (limité par la place libre).
+ */
+static size_t _http_txq_push(connection_info_t *conn, const char *data, size_t len)
+{
+    size_t space = ESP01_HTTP_TXQ_SIZE - conn->tx_len; // Place libre
+    size_t n = len < space ? len : space;              // Octets ajoutés
+    size_t tail = (conn->tx_head + conn->tx_len) % ESP01_HTTP_TXQ_SIZE;
+    size_t first = ESP01_HTTP_TXQ_SIZE - tail; // Place avant le rebouclage
+    if (first > n)
+    {
+        first = n;
+    }
+    memcpy(conn->tx_buf + tail, data, first);           // Jusqu'à la fin du tampon
+    memcpy(conn->tx_buf, data + first, n - first);      // Suite en début de tampon
+    conn->tx_len += (uint16_t)n;
+    return n;
+}
+
+/**
+ * @brief Envoie le contenu de la file d'émission d'un lien (un AT+CIPSEND).
+ * @param conn_id Identifiant de connexion.
+ * @retval ESP01_Status_t Code de statut.
+ */
+static ESP01_Status_t _http_txq_send(int conn_id)
+{
+    connection_info_t *conn = &g_connections[conn_id];
+    size_t n = conn->tx_len;                         // Toute la file (ESP01_HTTP_TXQ_SIZE <= ESP01_HTTP_TX_SEGMENT)
+    size_t first = ESP01_HTTP_TXQ_SIZE - conn->tx_head; // Octets avant le rebouclage
+    if (first > n)
+    {
+        first = n;
+    }
+    esp01_tx_part_t parts[2] = {{(const char *)conn->tx_buf + conn->tx_head, first}, {(const char *)conn->tx_buf, n - first}};
+
+    ESP01_Status_t st = esp01_send_submit(conn_id, parts, 2, _http_scan_rx); // Rend la main dès la transmission
+    if (st == ESP01_OK && conn->tx_len >= n) // File non vidée entre-temps (n,CLOSED)
+    {
+        conn->tx_head = (uint16_t)((conn->tx_head + n) % ESP01_HTTP_TXQ_SIZE);
+        conn->tx_len -= (uint16_t)n;
+    }
+    else if (st != ESP01_OK)
+    {
+        ESP01_LOG_WARN("HTTP", "Envoi de %d octets échoué sur connexion %d, file abandonnée", (int)n, conn_id);
+        conn->tx_head = 0;
+        conn->tx_len = 0;
+    }
+    return st;
+}
+
+/**
+ * @brief Écrit des segments dans la file d'émission d'un lien.
+ * @param conn_id Identifiant de connexion.
+ * @param parts   Segments à écrire dans l'ordre.
+ * @param count   Nombre de segments.
+ * @retval ESP01_Status_t Code de statut.
+ * @note  Aucun handler n'est appelé ici (pas de réentrance) : file pleine, chaque
+ *        lien envoie un segment de sa file (_http_txq_round) avant de continuer.
+ *        Un segment d'au moins ESP01_HTTP_TXQ_SIZE octets part directement depuis
+ *        sa source, à son tour, sans passer par la file.
+ */
+static ESP01_Status_t _http_link_write(int conn_id, const esp01_tx_part_t *parts, int count)
+{
+    connection_info_t *conn = &g_connections[conn_id]; // Connexion concernée
+    bool capture = (conn_id == g_http_cache_conn);      // Réponse mise en cache
+    for (int i = 0; i < count; i++)
+    {
+        const char *data = parts[i].data;
+        size_t len = parts[i].len;
+        conn->tx_bytes += (uint32_t)len; // Métriques de la route servie
+        if (capture && len > 0)
+        {
+            _http_cache_capture(data, len); // Copie avant envoi (les gros segments partent sans copie)
+        }
+        while (len > 0)
+        {
+            if (!conn->is_active) // Lien fermé par le client
+            {
+                if (capture)
+                {
+                    g_http_cache_failed = true; // Réponse incomplète
+                }
+                return ESP01_NOT_CONNECTED;
+            }
+            if (conn->tx_len == 0 && len >= ESP01_HTTP_TXQ_SIZE) // Gros segment : envoi direct
+            {
+                _http_txq_round();                                                        // Les autres liens envoient d'abord
+                size_t seg = len < ESP01_HTTP_TX_SEGMENT ? len : ESP01_HTTP_TX_SEGMENT; // Un AT+CIPSEND au plus
+                esp01_tx_part_t direct = {data, seg};                                     // Segment envoyé sans copie
+                ESP01_Status_t st = esp01_send_submit(conn_id, &direct, 1, _http_scan_rx);
+                if (st != ESP01_OK)
+                {
+                    if (capture)
+                    {
+                        g_http_cache_failed = true; // Réponse incomplète
+                    }
+                    return st;
+                }
+                data += seg;
+                len -= seg;
+                continue;
+            }
+            size_t n = _http_txq_push(conn, data, len); // Copie ce qui tient dans la file
+            data += n;
+            len -= n;
+            if (len > 0)            // File pleine
+            {
+                _http_txq_round(); // Chaque lien envoie un segment de sa file
+            }
+        }
+    }
+    return ESP01_OK;
+}
+
+/**
+ * @brief Attend que la file d'émission d'un lien soit entièrement envoyée.
+ * @param conn_id Identifiant de connexion.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_flush(int conn_id)
+{
+    VALIDATE_PARAM(conn_id >= 0 && conn_id < ESP01_MAX_CONNECTIONS, ESP01_INVALID_PARAM); // Vérifie l'identifiant
+
+    uint32_t start = HAL_GetTick(); // Timestamp de départ
+    while (g_connections[conn_id].tx_len > 0)
+    {
+        if (!g_connections[conn_id].is_active) // Lien fermé
+        {
+            return ESP01_NOT_CONNECTED;
+        }
+        if ((HAL_GetTick() - start) >= ESP01_HTTP_RESPONSE_TIMEOUT) // Timeout
+        {
+            return ESP01_TIMEOUT;
+        }
+        _http_txq_round(); // Chaque lien envoie un segment
+    }
+    while (esp01_send_outstanding(conn_id) > 0) // Dernier envoi du lien pas encore confirmé
+    {
+        if ((HAL_GetTick() - start) >= ESP01_HTTP_RESPONSE_TIMEOUT) // Timeout
+        {
+            return ESP01_TIMEOUT;
+        }
+        _http_scan_rx(); // Attend "SEND OK"
+        HAL_Delay(1);    // Petite pause CPU
+    }
+    return ESP01_OK;
+}
+
+/**
+ * @brief Envoie une réponse HTTP complète (header + body).
+ * @param conn_id      Identifiant de connexion.
+ * @param status_code  Code HTTP (ex: 200, 404).
+ * @param content_type Type MIME (ex: "text/html").
+ * @param body         Corps de la réponse.
+ * @param body_len     Taille du corps.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_send_http_response(int conn_id, int status_code, const char *content_type,
+                                        const char *body, size_t body_len)
+{
+    ESP01_LOG_DEBUG("HTTP", "Préparation de la réponse HTTP (conn_id=%d, code=%d, type=%s, taille=%d)", conn_id, status_code, content_type ? content_type : "NULL", (int)body_len); // Log la préparation de la réponse
+    VALIDATE_PARAM(conn_id >= 0 && conn_id < ESP01_MAX_CONNECTIONS, ESP01_FAIL);                                                                                                   // Vérifie l'identifiant de connexion
+    VALIDATE_PARAM(status_code >= 100 && status_code < 600, ESP01_FAIL);                                                                                                            // Vérifie le code HTTP
+    VALIDATE_PARAM(body || body_len == 0, ESP01_FAIL);                                                                                                                              // Vérifie le corps de la réponse
+
+    uint32_t start = HAL_GetTick(); // Timestamp de début pour les stats
+
+    char header[ESP01_MAX_HEADER_LINE]; // Buffer pour l'en-tête HTTP
+    int header_len = snprintf(header, sizeof(header),
+                              "HTTP/1.1 %d %s\r\n"
+                              "Content-Type: %s\r\n"
+                              "Content-Length: %d\r\n"
+                              "%s"
+                              "\r\n",
+                              status_code, _http_status_text(status_code), content_type ? content_type : "text/html", (int)body_len,
+                              _http_connection_header(conn_id)); // Prépare l'en-tête HTTP
+    if (header_len < 0 || header_len >= (int)sizeof(header))                                                                          // Vérifie la taille de l'en-tête
+    {
+        ESP01_LOG_ERROR("HTTP", "En-tête HTTP trop long"); // Log l'erreur
+        return ESP01_BUFFER_OVERFLOW;                      // Retourne une erreur
+    }
+
+    g_connections[conn_id].resp_status = (uint16_t)status_code;                 // Code retenu pour les métriques
+    esp01_tx_part_t parts[2] = {{header, (size_t)header_len}, {body, body_len}}; // En-tête et corps
+    ESP01_Status_t st = _http_link_write(conn_id, parts, 2);                  // Place la réponse dans la file du lien
+    ESP01_LOG_DEBUG("HTTP", "Réponse HTTP en file sur connexion %d, taille de la page HTML : %d octets", conn_id, (int)body_len); // Log la réussite
+
+    _http_record_stats(status_code, start); // Met à jour les statistiques
+    return st;                              // Retourne le statut
+}
+
+// ==================== RÉPONSES EN FLUX ====================
+
+/**
+ * @brief Écrit l'en-tête en attente, les octets tamponnés et un segment externe
+ *        sous forme d'un chunk HTTP dans la file d'émission du lien.
+ * @param stream Flux.
+ * @param extra  Segment externe à ajouter au chunk (NULL si aucun).
+ * @param extra_len Taille du segment externe.
+ * @param last   true pour ajouter le chunk final "0\r\n\r\n".
+ * @retval ESP01_Status_t Code de statut.
+ */
+static ESP01_Status_t _http_stream_flush(esp01_http_stream_t *stream, const char *extra, size_t extra_len, bool last)
+{
+    if (stream->status != ESP01_OK) // Erreur déjà rencontrée
+    {
+        return stream->status;
+    }
+
+    size_t chunk_len = (stream->len - stream->header_len) + extra_len; // Taille du chunk de corps
+    char size_line[12];                                                // Ligne de taille du chunk (hexadécimal)
+    esp01_tx_part_t parts[6];                                             // En-tête, taille, tampon, externe, CRLF, fin
+    int count = 0;
+
+    if (stream->header_len > 0) // En-tête pas encore envoyé
+    {
+        parts[count++] = (esp01_tx_part_t){stream->buf, stream->header_len};
+    }
+    if (chunk_len > 0) // Chunk non vide
+    {
+        int n = snprintf(size_line, sizeof(size_line), "%X\r\n", (unsigned)chunk_len);       // Taille du chunk
+        parts[count++] = (esp01_tx_part_t){size_line, (size_t)n};                              // Ligne de taille
+        parts[count++] = (esp01_tx_part_t){stream->buf + stream->header_len, stream->len - stream->header_len}; // Octets tamponnés
+        parts[count++] = (esp01_tx_part_t){extra, extra_len};                                  // Segment externe
+        parts[count++] = (esp01_tx_part_t){"\r\n", 2};                                         // Fin du chunk
+    }
+    if (last)                                            // Fin de la réponse
+    {
+        parts[count++] = (esp01_tx_part_t){"0\r\n\r\n", 5}; // Chunk final
+    }
+
+    stream->status = _http_link_write(stream->conn_id, parts, count); // Place le tout dans la file du lien
+    stream->total += chunk_len;                                   // Compte les octets de corps
+    stream->len = 0;                                              // Vide le tampon
+    stream->header_len = 0;                                       // En-tête envoyé
+    return stream->status;
+}
+
+/**
+ * @brief Démarre une réponse en flux (Transfer-Encoding: chunked).
+ * @param stream       Flux à initialiser.
+ * @param conn_id      Identifiant de connexion.
+ * @param status_code  Code HTTP.
+ * @param content_type Type MIME.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_stream_begin(esp01_http_stream_t *stream, int conn_id, int status_code, const char *content_type)
+{
+    VALIDATE_PARAM(stream, ESP01_INVALID_PARAM);                                    // Vérifie le flux
+    VALIDATE_PARAM(conn_id >= 0 && conn_id < ESP01_MAX_CONNECTIONS, ESP01_INVALID_PARAM); // Vérifie l'identifiant de connexion
+    VALIDATE_PARAM(status_code >= 100 && status_code < 600, ESP01_INVALID_PARAM); // Vérifie le code HTTP
+
+    memset(stream, 0, sizeof(*stream)); // Réinitialise le flux
+    stream->conn_id = conn_id;
+    stream->status_code = status_code;
+    stream->start = HAL_GetTick(); // Timestamp de début pour les stats
+    stream->status = ESP01_OK;
+
+    int n = snprintf(stream->buf, sizeof(stream->buf),
+                     "HTTP/1.1 %d %s\r\n"
+                     "Content-Type: %s\r\n"
+                     "Transfer-Encoding: chunked\r\n"
+                     "%s"
+                     "\r\n",
+                     status_code, _http_status_text(status_code), content_type ? content_type : "text/html",
+                     _http_connection_header(conn_id)); // En-tête conservé jusqu'au premier envoi
+    if (n < 0 || n >= (int)sizeof(stream->buf))                                                              // Vérifie la taille de l'en-tête
+    {
+        stream->status = ESP01_BUFFER_OVERFLOW;
+        ESP01_RETURN_ERROR("HTTP_STREAM", ESP01_BUFFER_OVERFLOW);
+    }
+    stream->len = (uint16_t)n;
+    stream->header_len = (uint16_t)n;
+    g_connections[conn_id].resp_status = (uint16_t)status_code; // Code retenu pour les métriques
+    return ESP01_OK;
+}
+
+/**
+ * @brief Écrit des octets dans le flux.
+ * @param stream Flux.
+ * @param data   Données.
+ * @param len    Taille.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_stream_write(esp01_http_stream_t *stream, const char *data, size_t len)
+{
+    VALIDATE_PARAM(stream, ESP01_INVALID_PARAM);           // Vérifie le flux
+    VALIDATE_PARAM(data || len == 0, ESP01_INVALID_PARAM); // Vérifie les données
+
+    while (stream->status == ESP01_OK && len > 0)
+    {
+        size_t space = sizeof(stream->buf) - stream->len; // Place restante dans le tampon
+        if (len <= space)                                 // Tient dans le tampon : copie
+        {
+            memcpy(stream->buf + stream->len, data, len);
+            stream->len += (uint16_t)len;
+            break;
+        }
+        _http_stream_flush(stream, data, len, false); // Tampon + données dans le même chunk, sans copie dans buf
+        break;
+    }
+    return stream->status;
+}
+
+/**
+ * @brief Écrit une valeur formatée dans le flux.
+ * @param stream Flux.
+ * @param fmt    Format printf.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_stream_printf(esp01_http_stream_t *stream, const char *fmt, ...)
+{
+    VALIDATE_PARAM(stream && fmt, ESP01_INVALID_PARAM); // Vérifie les paramètres
+    if (stream->status != ESP01_OK)                     // Erreur déjà rencontrée
+    {
+        return stream->status;
+    }
+
+    va_list args;
+    size_t space = sizeof(stream->buf) - stream->len;               // Place restante dans le tampon
+    va_start(args, fmt);
+    int n = vsnprintf(stream->buf + stream->len, space, fmt, args); // Formate directement dans le tampon
+    va_end(args);
+    if (n < 0)
+    {
+        stream->status = ESP01_FAIL;
+        return stream->status;
+    }
+    if ((size_t)n >= space) // Ne tient pas : vide le tampon et recommence
+    {
+        if (_http_stream_flush(stream, NULL, 0, false) != ESP01_OK)
+        {
+            return stream->status;
+        }
+        if ((size_t)n >= sizeof(stream->buf)) // Valeur plus grande que le tampon entier
+        {
+            stream->status = ESP01_BUFFER_OVERFLOW;
+            ESP01_RETURN_ERROR("HTTP_STREAM", ESP01_BUFFER_OVERFLOW);
+        }
+        va_start(args, fmt);
+        vsnprintf(stream->buf, sizeof(stream->buf), fmt, args);
+        va_end(args);
+    }
+    stream->len += (uint16_t)n;
+    return ESP01_OK;
+}
+
+/**
+ * @brief Termine la réponse en flux.
+ * @param stream Flux.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_stream_end(esp01_http_stream_t *stream)
+{
+    VALIDATE_PARAM(stream, ESP01_INVALID_PARAM); // Vérifie le flux
+
+    _http_stream_flush(stream, NULL, 0, true); // Dernier chunk + chunk final
+    ESP01_LOG_DEBUG("HTTP", "Réponse en flux envoyée sur connexion %d, %lu octets", stream->conn_id, (unsigned long)stream->total); // Log la réussite
+    _http_record_stats(stream->status_code, stream->start); // Met à jour les statistiques
+    return stream->status;
+}
+
+/**
+ * @brief Sortie d'un écrivain JSON vers une réponse en flux.
+ */
+static ESP01_Status_t _http_json_stream_write(void *ctx, const char *data, size_t len)
+{
+    return esp01_http_stream_write((esp01_http_stream_t *)ctx, data, len);
+}
+
+/**
+ * @brief Initialise un écrivain JSON qui écrit directement dans une réponse en flux.
+ * @param w      Écrivain JSON.
+ * @param stream Flux démarré.
+ */
+void esp01_http_json_init(esp01_json_writer_t *w, esp01_http_stream_t *stream)
+{
+    esp01_json_init(w, _http_json_stream_write, stream); // Pas de document intermédiaire : les petits morceaux sont regroupés dans le flux
+}
+
+// ==================== TEMPLATES HTML ====================
+
+/**
+ * @brief Cherche l'opération ENDLOOP correspondant à une boucle.
+ * @param op Première opération du corps de boucle.
+ * @retval const esp01_tpl_op_t* ENDLOOP correspondant, NULL si absent.
+ */
+static const esp01_tpl_op_t *_tpl_find_endloop(const esp01_tpl_op_t *op)
+{
+    int depth = 0; // Profondeur des boucles imbriquées
+    for (; op->type != ESP01_TPL_OP_END; op++)
+    {
+        if (op->type == ESP01_TPL_OP_LOOP)
+        {
+            depth++;
+        }
+        else if (op->type == ESP01_TPL_OP_ENDLOOP && depth-- == 0)
+        {
+            return op;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Rend les opérations [op, end[ d'un template.
+ * @param stream Flux.
+ * @param op     Première opération.
+ * @param end    Borne de fin (NULL : jusqu'à ESP01_TPL_OP_END).
+ * @param index  Indice de l'itération de boucle courante.
+ * @retval ESP01_Status_t Code de statut.
+ */
+static ESP01_Status_t _tpl_render_range(esp01_http_stream_t *stream, const esp01_tpl_op_t *op, const esp01_tpl_op_t *end, uint16_t index,
+                                        esp01_tpl_var_cb_t var_cb, esp01_tpl_loop_cb_t loop_cb, void *ctx)
+{
+    for (; op != end && op->type != ESP01_TPL_OP_END && stream->status == ESP01_OK; op++)
+    {
+        switch (op->type)
+        {
+        case ESP01_TPL_OP_LIT:
+            esp01_http_stream_write(stream, (const char *)op->data, op->len); // Littéral envoyé tel quel
+            break;
+        case ESP01_TPL_OP_VAR:
+            if (var_cb)
+            {
+                var_cb(stream, op->id, index, ctx); // La valeur est écrite directement dans le flux
+            }
+            break;
+        case ESP01_TPL_OP_INCLUDE:
+            _tpl_render_range(stream, (const esp01_tpl_op_t *)op->data, NULL, index, var_cb, loop_cb, ctx); // Sous-template
+            break;
+        case ESP01_TPL_OP_LOOP:
+        {
+            const esp01_tpl_op_t *loop_end = _tpl_find_endloop(op + 1); // Fin du corps de boucle
+            if (!loop_end)
+            {
+                ESP01_LOG_ERROR("TPL", "Boucle %d sans ENDLOOP", op->id);
+                stream->status = ESP01_INVALID_PARAM;
+                return stream->status;
+            }
+            for (uint16_t i = 0; loop_cb && loop_cb(op->id, i, ctx) && stream->status == ESP01_OK; i++) // Tant que l'élément existe
+            {
+                _tpl_render_range(stream, op + 1, loop_end, i, var_cb, loop_cb, ctx);                    // Rend le corps de boucle
+            }
+            op = loop_end; // Reprend après ENDLOOP
+            break;
+        }
+        default:
+            break; // ENDLOOP orphelin ignoré
+        }
+    }
+    return stream->status;
+}
+
+/**
+ * @brief Rend un template précompilé dans un flux.
+ */
+ESP01_Status_t esp01_tpl_render(esp01_http_stream_t *stream, const esp01_tpl_op_t *tpl,
+                                esp01_tpl_var_cb_t var_cb, esp01_tpl_loop_cb_t loop_cb, void *ctx)
+{
+    VALIDATE_PARAM(stream && tpl, ESP01_INVALID_PARAM); // Vérifie les paramètres
+    return _tpl_render_range(stream, tpl, NULL, 0, var_cb, loop_cb, ctx);
+}
+
+/**
+ * @brief Envoie une page rendue depuis un template.
+ */
+ESP01_Status_t esp01_http_send_template(int conn_id, int status_code, const char *content_type, const esp01_tpl_op_t *tpl,
+                                        esp01_tpl_var_cb_t var_cb, esp01_tpl_loop_cb_t loop_cb, void *ctx)
+{
+    VALIDATE_PARAM(tpl, ESP01_INVALID_PARAM); // Vérifie le template
+
+    esp01_http_stream_t stream; // Seul tampon de la réponse (ESP01_HTTP_STREAM_BUF_SIZE)
+    ESP01_Status_t st = esp01_http_stream_begin(&stream, conn_id, status_code, content_type);
+    if (st != ESP01_OK)
+    {
+        return st;
+    }
+    esp01_tpl_render(&stream, tpl, var_cb, loop_cb, ctx); // Rend le template
+    return esp01_http_stream_end(&stream);                // Termine la réponse
+}
+
+// ==================== MÉTRIQUES (FORMAT PROMETHEUS) ====================
+
+/**
+ * @brief Bornes de l'histogramme de latence, en secondes (2^i ms).
+ */
+static const char *const k_http_lat_le[ESP01_HTTP_LAT_BUCKETS] = {
+    "0.001", "0.002", "0.004", "0.008", "0.016", "0.032", "0.064",
+    "0.128", "0.256", "0.512", "1.024", "2.048", "4.096", "+Inf"};
+
+/**
+ * @brief Enregistre le traitement d'une requête dans les métriques d'une route.
+ * @param stats      Métriques de la route.
+ * @param status     Code HTTP envoyé.
+ * @param bytes      Octets de réponse écrits.
+ * @param elapsed_ms Durée du traitement (ms).
+ */
+static void _http_metrics_record(esp01_route_stats_t *stats, int status, uint32_t bytes, uint32_t elapsed_ms)
+{
+    uint8_t bucket = 0;
+    while (bucket < ESP01_HTTP_LAT_BUCKETS - 1 && elapsed_ms > (1UL << bucket)) // Première borne 2^i >= durée
+    {
+        bucket++;
+    }
+    stats->requests++;
+    stats->bytes_out += bytes;
+    if (status >= 100 && status < 600)
+    {
+        stats->status_class[status / 100 - 1]++;
+    }
+    stats->latency_sum_ms += elapsed_ms;
+    stats->latency_buckets[bucket]++;
+}
+
+/**
+ * @brief Retourne les métriques et le libellé d'une route (index g_route_count : hors routes).
+ */
+static const esp01_route_stats_t *_http_metrics_route(int i, const char **label)
+{
+    if (i < g_route_count)
+    {
+        *label = g_routes[i].path;
+        return &g_routes[i].stats;
+    }
+    *label = "none"; // 400, 404, favicon
+    return &g_http_unrouted_stats;
+}
+
+/**
+ * @brief Écrit l'en-tête d'une famille de métriques.
+ */
+static void _http_metrics_family(esp01_http_stream_t *out, const char *name, const char *type, const char *help)
+{
+    esp01_http_stream_printf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+/**
+ * @brief Handler de la route de métriques : rendu en flux, famille par famille.
+ * @param conn_id Identifiant de connexion.
+ * @param req     Requête parsée (non utilisée).
+ */
+static void _http_metrics_handler(int conn_id, const http_parsed_request_t *req)
+{
+    (void)req;
+    esp01_http_stream_t out; // Seul tampon : celui du flux (chunks)
+    if (esp01_http_stream_begin(&out, conn_id, ESP01_HTTP_OK_CODE, "text/plain; version=0.0.4") != ESP01_OK)
+    {
+        return;
+    }
+
+    const char *label;
+    _http_metrics_family(&out, "esp01_http_requests_total", "counter", "Requetes traitees par route");
+    for (int i = 0; i <= g_route_count; i++)
+    {
+        const esp01_route_stats_t *s = _http_metrics_route(i, &label);
+        esp01_http_stream_printf(&out, "esp01_http_requests_total{route=\"%s\"} %lu\n", label, (unsigned long)s->requests);
+    }
+    _http_metrics_family(&out, "esp01_http_responses_total", "counter", "Reponses par route et classe de statut");
+    for (int i = 0; i <= g_route_count; i++)
+    {
+        const esp01_route_stats_t *s = _http_metrics_route(i, &label);
+        for (int c = 0; c < 5; c++)
+        {
+            if (s->status_class[c])
+            {
+                esp01_http_stream_printf(&out, "esp01_http_responses_total{route=\"%s\",code=\"%dxx\"} %lu\n", label, c + 1, (unsigned long)s->status_class[c]);
+            }
+        }
+    }
+    _http_metrics_family(&out, "esp01_http_response_bytes_total", "counter", "Octets de reponse ecrits par route");
+    for (int i = 0; i <= g_route_count; i++)
+    {
+        const esp01_route_stats_t *s = _http_metrics_route(i, &label);
+        esp01_http_stream_printf(&out, "esp01_http_response_bytes_total{route=\"%s\"} %lu\n", label, (unsigned long)s->bytes_out);
+    }
+    _http_metrics_family(&out, "esp01_http_request_duration_seconds", "histogram", "Duree de traitement des requetes");
+    for (int i = 0; i <= g_route_count; i++)
+    {
+        const esp01_route_stats_t *s = _http_metrics_route(i, &label);
+        uint32_t cumul = 0; // Les buckets Prometheus sont cumulatifs
+        for (int b = 0; b < ESP01_HTTP_LAT_BUCKETS; b++)
+        {
+            cumul += s->latency_buckets[b];
+            esp01_http_stream_printf(&out, "esp01_http_request_duration_seconds_bucket{route=\"%s\",le=\"%s\"} %lu\n", label, k_http_lat_le[b], (unsigned long)cumul);
+        }
+        esp01_http_stream_printf(&out, "esp01_http_request_duration_seconds_sum{route=\"%s\"} %lu.%03lu\n", label,
+                                 (unsigned long)(s->latency_sum_ms / 1000), (unsigned long)(s->latency_sum_ms % 1000));
+        esp01_http_stream_printf(&out, "esp01_http_request_duration_seconds_count{route=\"%s\"} %lu\n", label, (unsigned long)s->requests);
+    }
+    const struct
+    {
+        const char *name;
+        const char *type;
+        const char *help;
+        uint32_t value;
+    } counters[] = {
+        {"esp01_http_link_accepts_total", "counter", "Liens ouverts par un client", g_stats.link_accepts},
+        {"esp01_http_link_closes_total", "counter", "Liens fermes", g_stats.link_closes},
+        {"esp01_http_link_timeouts_total", "counter", "Liens fermes pour inactivite", g_stats.link_timeouts},
+        {"esp01_http_links_active", "gauge", "Liens ouverts", (uint32_t)esp01_get_active_connection_count()},
+        {"esp01_http_links_peak", "gauge", "Liens ouverts simultanement (maximum)", g_stats.links_peak},
+        {"esp01_http_link_keepalive_closes_total", "counter", "Liens keep-alive fermes sans requete suivante", g_stats.link_keepalive_closes},
+        {"esp01_http_link_evictions_total", "counter", "Liens inactifs fermes pour liberer une place", g_stats.link_evictions},
+        {"esp01_udp_rx_datagrams_total", "counter", "Datagrammes UDP recus", g_stats.udp_rx_datagrams},
+        {"esp01_udp_rx_dropped_total", "counter", "Datagrammes UDP abandonnes (file pleine)", g_stats.udp_rx_dropped},
+        {"esp01_udp_tx_datagrams_total", "counter", "Datagrammes UDP emis", g_stats.udp_tx_datagrams},
+        {"esp01_http_cache_hits_total", "counter", "Reponses servies depuis le cache", g_stats.cache_hits},
+        {"esp01_http_cache_misses_total", "counter", "Requetes en cache ayant appele le handler", g_stats.cache_misses},
+        {"esp01_http_sse_events_total", "counter", "Evenements SSE mis en file", g_stats.sse_events},
+        {"esp01_http_sse_dropped_total", "counter", "Evenements SSE abandonnes (file pleine)", g_stats.sse_dropped},
+        {"esp01_http_rl_client_limited_total", "counter", "Requetes refusees (limite par client)", g_stats.rl_client_limited},
+        {"esp01_http_rl_global_limited_total", "counter", "Requetes refusees (limite globale)", g_stats.rl_global_limited},
+        {"esp01_http_rl_closed_total", "counter", "Liens fermes au lieu d'un refus", g_stats.rl_closed},
+        {"esp01_at_sends_total", "counter", "AT+CIPSEND emis", g_send_stats.sends},
+        {"esp01_at_send_failures_total", "counter", "SEND FAIL recus", g_send_stats.send_fail},
+        {"esp01_at_send_timeouts_total", "counter", "Envois expires sans confirmation", g_send_stats.timeouts},
+        {"esp01_at_busy_retries_total", "counter", "Commandes relancees apres busy", g_send_stats.busy_retries},
+        {"esp01_at_send_bytes_total", "counter", "Octets transmis par AT+CIPSEND", g_send_stats.bytes},
+        {"esp01_uart_tx_bytes_total", "counter", "Octets ecrits vers l'ESP01 (commandes comprises)", g_uart_stats.tx_bytes},
+        {"esp01_uart_rx_bytes_total", "counter", "Octets lus depuis l'ESP01", g_uart_stats.rx_bytes},
+        {"esp01_uart_capacity_bytes_per_second", "gauge", "Debit maximal de la liaison serie (8N1)", esp01_uart_capacity()},
+    };
+    for (size_t i = 0; i < sizeof(counters) / sizeof(counters[0]); i++)
+    {
+        _http_metrics_family(&out, counters[i].name, counters[i].type, counters[i].help);
+        esp01_http_stream_printf(&out, "%s %lu\n", counters[i].name, (unsigned long)counters[i].value);
+    }
+    esp01_http_stream_end(&out);
+}
+
+/**
+ * @brief Ajoute la route de métriques (format texte Prometheus).
+ * @param path Chemin de la route (NULL : "/metrics").
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_enable_metrics(const char *path)
+{
+    return esp01_add_route(path ? path : "/metrics", _http_metrics_handler); // Route intégrée
+}
+
+// ==================== WEBSOCKET (RFC 6455) ====================
+
+#define ESP01_WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC85B11" // Suffixe de la clé (RFC 6455, 1.3)
+#define ESP01_WS_MAX_KEY_LEN 32                               // Sec-WebSocket-Key : 24 caractères en pratique
+
+/**
+ * @brief Rotation à gauche sur 32 bits (SHA-1).
+ */
+static uint32_t _http_rol32(uint32_t x, int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+/**
+ * @brief Traite un bloc de 64 octets (SHA-1).
+ * @param h     État (5 mots).
+ * @param block Bloc.
+ */
+static void _http_sha1_block(uint32_t h[5], const uint8_t *block)
+{
+    uint32_t w[16]; // Fenêtre glissante des 80 mots
+    for (int i = 0; i < 16; i++)
+    {
+        w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) | ((uint32_t)block[4 * i + 2] << 8) | block[4 * i + 3];
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++)
+    {
+        if (i >= 16) // Extension du message
+        {
+            w[i & 15] = _http_rol32(w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15], 1);
+        }
+        uint32_t f, k;
+        if (i < 20)
+        {
+            f = (b & c) | (~b & d), k = 0x5A827999;
+        }
+        else if (i < 40)
+        {
+            f = b ^ c ^ d, k = 0x6ED9EBA1;
+        }
+        else if (i < 60)
+        {
+            f = (b & c) | (b & d) | (c & d), k = 0x8F1BBCDC;
+        }
+        else
+        {
+            f = b ^ c ^ d, k = 0xCA62C1D6;
+        }
+        uint32_t t = _http_rol32(a, 5) + f + e + k + w[i & 15];
+        e = d;
+        d = c;
+        c = _http_rol32(b, 30);
+        b = a;
+        a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+}
+
+/**
+ * @brief Calcule l'empreinte SHA-1 d'un message court (poignée de main).
+ * @param data Message.
+ * @param len  Taille.
+ * @param out  Empreinte (20 octets).
+ */
+static void _http_sha1(const uint8_t *data, size_t len, uint8_t out[20])
+{
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    size_t done = 0;
+    for (; len - done >= 64; done += 64) // Blocs complets
+    {
+        _http_sha1_block(h, data + done);
+    }
+
+    uint8_t tail[128] = {0}; // Dernier bloc + bourrage (1 ou 2 blocs)
+    size_t rest = len - done;
+    memcpy(tail, data + done, rest);
+    tail[rest] = 0x80;
+    size_t tail_len = (rest < 56) ? 64 : 128;
+    uint64_t bits = (uint64_t)len * 8;
+    for (int i = 0; i < 8; i++) // Longueur en bits, gros-boutiste
+    {
+        tail[tail_len - 1 - i] = (uint8_t)(bits >> (8 * i));
+    }
+    for (size_t off = 0; off < tail_len; off += 64)
+    {
+        _http_sha1_block(h, tail + off);
+    }
+
+    for (int i = 0; i < 20; i++)
+    {
+        out[i] = (uint8_t)(h[i / 4] >> (24 - 8 * (i % 4)));
+    }
+}
+
+/**
+ * @brief Encode des octets en base64 (terminé par '\0').
+ * @param data Octets.
+ * @param len  Taille.
+ * @param out  Sortie (4 * ((len + 2) / 3) + 1 octets).
+ */
+static void _http_base64(const uint8_t *data, size_t len, char *out)
+{
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (size_t i = 0; i < len; i += 3)
+    {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < len)
+        {
+            v |= (uint32_t)data[i + 1] << 8;
+        }
+        if (i + 2 < len)
+        {
+            v |= data[i + 2];
+        }
+        *out++ = table[(v >> 18) & 0x3F];
+        *out++ = table[(v >> 12) & 0x3F];
+        *out++ = (i + 1 < len) ? table[(v >> 6) & 0x3F] : '=';
+        *out++ = (i + 2 < len) ? table[v & 0x3F] : '=';
+    }
+    *out = '\0';
+}
+
+/**
+ * @brief Handler HTTP d'une route WebSocket sans poignée de main valide.
+ */
+static void _http_ws_reject(int conn_id, const http_parsed_request_t *req)
+{
+    (void)req;
+    const char *body = "<html><body><h1>400 WebSocket attendu</h1></body></html>";
+    esp01_send_http_response(conn_id, ESP01_HTTP_BAD_REQUEST_CODE, "text/html", body, strlen(body));
+}
+
+/**
+ * @brief Ajoute une route WebSocket.
+ * @param path     Chemin de la route.
+ * @param on_event Callback des évènements du lien.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_add_route_ws(const char *path, esp01_ws_cb_t on_event)
+{
+    VALIDATE_PARAM(path && on_event, ESP01_INVALID_PARAM);          // Vérifie les paramètres
+    ESP01_Status_t st = esp01_add_route(path, _http_ws_reject);    // Requêtes HTTP ordinaires refusées
+    if (st == ESP01_OK)
+    {
+        g_routes[g_route_count - 1].on_ws = on_event; // Route ajoutée en dernier
+    }
+    return st;
+}
+
+/**
+ * @brief Effectue la poignée de main WebSocket si la requête la demande.
+ * @param conn_id Identifiant de connexion.
+ * @param req     Requête parsée (GET, Upgrade: websocket, Sec-WebSocket-Key).
+ * @param route   Route WebSocket.
+ * @retval true si le lien est passé en WebSocket.
+ */
+static bool _http_ws_upgrade(int conn_id, const http_parsed_request_t *req, const esp01_route_t *route)
+{
+    size_t up_len = 0, key_len = 0, ver_len = 0;
+    const char *up = esp01_http_get_header(req, "Upgrade", &up_len);
+    const char *key = esp01_http_get_header(req, "Sec-WebSocket-Key", &key_len);
+    const char *ver = esp01_http_get_header(req, "Sec-WebSocket-Version", &ver_len);
+    if (strcmp(req->method, "GET") != 0 || !up || up_len != 9 || !_http_equals_nocase(up, "websocket", 9) ||
+        !key || key_len == 0 || key_len > ESP01_WS_MAX_KEY_LEN || (ver && (ver_len != 2 || strncmp(ver, "13", 2) != 0)))
+    {
+        return false;
+    }
+
+    char src[ESP01_WS_MAX_KEY_LEN + sizeof(ESP01_WS_GUID)]; // Clé + GUID
+    memcpy(src, key, key_len);
+    memcpy(src + key_len, ESP01_WS_GUID, sizeof(ESP01_WS_GUID) - 1);
+    uint8_t digest[20];
+    char accept[29]; // base64 de 20 octets
+    _http_sha1((const uint8_t *)src, key_len + sizeof(ESP01_WS_GUID) - 1, digest);
+    _http_base64(digest, sizeof(digest), accept);
+
+    char header[ESP01_MAX_HEADER_LINE];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 101 Switching Protocols\r\n"
+                     "Upgrade: websocket\r\n"
+                     "Connection: Upgrade\r\n"
+                     "Sec-WebSocket-Accept: %s\r\n"
+                     "\r\n",
+                     accept);
+    connection_info_t *conn = &g_connections[conn_id];
+    conn->resp_status = ESP01_HTTP_SWITCHING_CODE; // Code retenu pour les métriques
+    esp01_tx_part_t part = {header, (size_t)n};
+    if (_http_link_write(conn_id, &part, 1) != ESP01_OK)
+    {
+        return true; // Lien fermé pendant l'écriture : rien d'autre à faire
+    }
+
+    memset(&conn->ws, 0, sizeof(conn->ws)); // Aucune trame en cours
+    conn->ws_cb = route->on_ws;             // Les octets suivants du lien sont des trames
+    ESP01_LOG_DEBUG("HTTP", "WebSocket ouvert sur connexion %d (%s)", conn_id, req->path);
+    route->on_ws(conn_id, ESP01_WS_EVT_OPEN, NULL, 0);
+    return true;
+}
+
+/**
+ * @brief Taille de l'en-tête d'une trame d'après ses 2 premiers octets.
+ */
+static uint8_t _http_ws_hdr_size(const uint8_t *hdr)
+{
+    uint8_t len7 = hdr[1] & 0x7F;
+    return (uint8_t)(2 + (len7 == 126 ? 2 : len7 == 127 ? 8 : 0) + ((hdr[1] & 0x80) ? 4 : 0));
+}
+
+/**
+ * @brief Signale une erreur de protocole : le lien sera fermé avec ce code.
+ */
+static void _http_ws_fail(esp01_ws_parser_t *ws, uint16_t code)
+{
+    ws->close_code = code;
+    ws->ready = ESP01_WS_OP_CLOSE;
+}
+
+/**
+ * @brief Fin d'une trame : message complet ou trame de contrôle à traiter.
+ */
+static void _http_ws_frame_end(esp01_ws_parser_t *ws)
+{
+    ws->hdr_len = 0; // Trame suivante
+    if (ws->frame_op & 0x08) // Contrôle : payload à la suite du message en cours
+    {
+        ws->ctrl_len = ws->frame_pos;
+        if (ws->frame_op != ESP01_WS_OP_PONG) // Pong : rien à faire (l'activité du lien est déjà notée)
+        {
+            ws->ready = ws->frame_op;
+        }
+        return;
+    }
+    ws->msg_len += ws->frame_pos;
+    if (ws->frame_fin) // Dernier fragment
+    {
+        ws->ready = ws->msg_op;
+    }
+}
+
+/**
+ * @brief Analyse l'en-tête complet d'une trame.
+ */
+static void _http_ws_frame_start(esp01_ws_parser_t *ws)
+{
+    const uint8_t *h = ws->hdr;
+    uint8_t op = h[0] & 0x0F;
+    uint8_t len7 = h[1] & 0x7F;
+    uint32_t len = len7;
+    if (len7 == 126)
+    {
+        len = ((uint32_t)h[2] << 8) | h[3];
+    }
+    else if (len7 == 127)
+    {
+        if (h[2] | h[3] | h[4] | h[5]) // Plus de 4 Go
+        {
+            _http_ws_fail(ws, 1009);
+            return;
+        }
+        len = ((uint32_t)h[6] << 24) | ((uint32_t)h[7] << 16) | ((uint32_t)h[8] << 8) | h[9];
+    }
+
+    bool control = (op & 0x08) != 0;
+    if ((h[0] & 0x70) || !(h[1] & 0x80)) // Bits réservés, ou trame client non masquée
+    {
+        _http_ws_fail(ws, 1002);
+    }
+    else if (control && (op > ESP01_WS_OP_PONG || !(h[0] & 0x80) || len > 125)) // Contrôle : non fragmenté, 125 octets max
+    {
+        _http_ws_fail(ws, 1002);
+    }
+    else if (!control && (op > ESP01_WS_OP_BINARY || (op == ESP01_WS_OP_CONT) != (ws->msg_op != 0))) // Suite sans début, ou début pendant un message
+    {
+        _http_ws_fail(ws, 1002);
+    }
+    if (ws->ready)
+    {
+        return;
+    }
+
+    ws->frame_op = op;
+    ws->frame_fin = (h[0] & 0x80) != 0;
+    ws->frame_left = len;
+    ws->frame_pos = 0;
+    if (!control && op != ESP01_WS_OP_CONT)
+    {
+        ws->msg_op = op; // Début de message
+    }
+    if (len == 0)
+    {
+        _http_ws_frame_end(ws);
+    }
+}
+
+/**
+ * @brief Alimente le parseur de trames d'un lien WebSocket.
+ * @param conn_id Identifiant de connexion.
+ * @param data    Octets reçus.
+ * @param len     Taille.
+ * @retval Nombre d'octets consommés : s'arrête sur une trame à traiter.
+ */
+static size_t _http_ws_feed(int conn_id, const uint8_t *data, size_t len)
+{
+    connection_info_t *conn = &g_connections[conn_id];
+    esp01_ws_parser_t *ws = &conn->ws;
+    uint8_t *buf = (uint8_t *)conn->parser.buf; // Tampon du parseur HTTP, libre après la poignée de main
+    size_t consumed = 0;
+    while (consumed < len && !ws->ready)
+    {
+        if (ws->hdr_len < 2 || ws->hdr_len < _http_ws_hdr_size(ws->hdr)) // En-tête incomplet
+        {
+            ws->hdr[ws->hdr_len++] = data[consumed++];
+            if (ws->hdr_len >= 2 && ws->hdr_len == _http_ws_hdr_size(ws->hdr))
+            {
+                _http_ws_frame_start(ws);
+            }
+            continue;
+        }
+        size_t n = len - consumed; // Payload disponible dans ces octets
+        if (n > ws->frame_left)
+        {
+            n = ws->frame_left;
+        }
+        size_t dst = (size_t)ws->msg_len + ws->frame_pos;
+        if (dst + n >= ESP01_HTTP_PARSER_BUF_SIZE) // Message trop grand (place pour le '\0')
+        {
+            _http_ws_fail(ws, 1009);
+            break;
+        }
+        const uint8_t *mask = ws->hdr + _http_ws_hdr_size(ws->hdr) - 4; // Clé en fin d'en-tête
+        for (size_t i = 0; i < n; i++)
+        {
+            buf[dst + i] = data[consumed + i] ^ mask[(ws->frame_pos + i) & 3];
+        }
+        consumed += n;
+        ws->frame_pos += (uint16_t)n;
+        ws->frame_left -= (uint32_t)n;
+        if (ws->frame_left == 0)
+        {
+            _http_ws_frame_end(ws);
+        }
+    }
+    if (ws->close_code) // Erreur : le reste du flux est ignoré
+    {
+        return len;
+    }
+    return consumed;
+}
+
+/**
+ * @brief Traite la trame prête d'un lien WebSocket (appelé par l'ordonnanceur).
+ * @param conn_id Identifiant de connexion.
+ */
+static void _http_ws_dispatch(int conn_id)
+{
+    connection_info_t *conn = &g_connections[conn_id];
+    esp01_ws_parser_t *ws = &conn->ws;
+    uint8_t *buf = (uint8_t *)conn->parser.buf;
+    esp01_ws_cb_t cb = conn->ws_cb;
+
+    switch (ws->ready)
+    {
+    case ESP01_WS_OP_PING: // Pong avec le même payload
+        esp01_ws_send(conn_id, ESP01_WS_OP_PONG, buf + ws->msg_len, ws->ctrl_len);
+        break;
+    case ESP01_WS_OP_CLOSE: // Fermeture demandée par le client, ou erreur de protocole
+    {
+        uint16_t code = ws->close_code;
+        if (!code) // Renvoie le code du client (1000 s'il n'en donne pas)
+        {
+            code = ws->ctrl_len >= 2 ? (uint16_t)((buf[ws->msg_len] << 8) | buf[ws->msg_len + 1]) : 1000;
+        }
+        ESP01_LOG_DEBUG("HTTP", "WebSocket %d : fermeture (code %u)", conn_id, code);
+        esp01_ws_close(conn_id, code);
+        break;
+    }
+    default: // Message complet
+        buf[ws->msg_len] = '\0'; // Texte utilisable comme chaîne
+        if (cb)
+        {
+            cb(conn_id, ws->ready == ESP01_WS_OP_TEXT ? ESP01_WS_EVT_TEXT : ESP01_WS_EVT_BINARY, buf, ws->msg_len);
+        }
+        ws->msg_len = 0;
+        ws->msg_op = 0;
+        break;
+    }
+    ws->ctrl_len = 0;
+    ws->ready = 0; // Les octets suivants du lien peuvent être analysés
+}
+
+/**
+ * @brief Envoie une trame WebSocket sur un lien.
+ * @param conn_id Lien WebSocket.
+ * @param opcode  Opcode.
+ * @param data    Payload.
+ * @param len     Taille.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_ws_send(int conn_id, uint8_t opcode, const void *data, size_t len)
+{
+    VALIDATE_PARAM(conn_id >= 0 && conn_id < ESP01_MAX_CONNECTIONS, ESP01_INVALID_PARAM); // Vérifie l'identifiant
+    VALIDATE_PARAM((data || len == 0) && len <= 0xFFFF, ESP01_INVALID_PARAM);           // Vérifie le payload
+    if (!esp01_ws_is_open(conn_id))
+    {
+        return ESP01_NOT_CONNECTED;
+    }
+
+    uint8_t hdr[4]; // Trame serveur : jamais masquée
+    size_t hdr_len = 2;
+    hdr[0] = (uint8_t)(0x80 | (opcode & 0x0F)); // FIN + opcode
+    if (len < 126)
+    {
+        hdr[1] = (uint8_t)len;
+    }
+    else
+    {
+        hdr[1] = 126; // Longueur sur 16 bits
+        hdr[2] = (uint8_t)(len >> 8);
+        hdr[3] = (uint8_t)len;
+        hdr_len = 4;
+    }
+    esp01_tx_part_t parts[2] = {{hdr, hdr_len}, {data, len}};
+    return _http_link_write(conn_id, parts, 2);
+}
+
+/**
+ * @brief Envoie un message texte sur un lien WebSocket.
+ * @param conn_id Lien WebSocket.
+ * @param text    Texte.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_ws_send_text(int conn_id, const char *text)
+{
+    VALIDATE_PARAM(text, ESP01_INVALID_PARAM);
+    return esp01_ws_send(conn_id, ESP01_WS_OP_TEXT, text, strlen(text));
+}
+
+/**
+ * @brief Envoie un message texte à tous les liens WebSocket ouverts.
+ * @param text Texte.
+ * @retval Nombre de liens auxquels le message a été confié.
+ */
+int esp01_ws_broadcast_text(const char *text)
+{
+    VALIDATE_PARAM(text, 0);
+    int count = 0;
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i)
+    {
+        if (esp01_ws_is_open(i) && esp01_ws_send_text(i, text) == ESP01_OK)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Ferme un lien WebSocket.
+ * @param conn_id Lien WebSocket.
+ * @param code    Code de fermeture.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_ws_close(int conn_id, uint16_t code)
+{
+    uint8_t payload[2] = {(uint8_t)(code >> 8), (uint8_t)code};
+    ESP01_Status_t st = esp01_ws_send(conn_id, ESP01_WS_OP_CLOSE, payload, sizeof(payload));
+    if (st != ESP01_OK)
+    {
+        return st;
+    }
+    return esp01_http_close_connection(conn_id); // Vide la file (trame Close) puis AT+CIPCLOSE
+}
+
+/**
+ * @brief Indique si un lien est un WebSocket ouvert.
+ * @param conn_id Identifiant de connexion.
+ * @retval true si WebSocket et actif.
+ */
+bool esp01_ws_is_open(int conn_id)
+{
+    return conn_id >= 0 && conn_id < ESP01_MAX_CONNECTIONS && g_connections[conn_id].is_active && g_connections[conn_id].ws_cb;
+}
+
+// ==================== SERVER-SENT EVENTS ====================
+
+static uint32_t g_http_sse_last_id = 0; // Dernier identifiant d'évènement SSE émis
+
+/**
+ * @brief Callback SSE par défaut (route sans callback applicatif).
+ */
+static void _http_sse_noop(int conn_id, esp01_sse_event_t event, uint32_t last_event_id)
+{
+    (void)conn_id;
+    (void)event;
+    (void)last_event_id;
+}
+
+/**
+ * @brief Handler HTTP d'une route SSE appelée avec une autre méthode que GET.
+ */
+static void _http_sse_reject(int conn_id, const http_parsed_request_t *req)
+{
+    (void)req;
+    const char *body = "<html><body><h1>405 GET attendu</h1></body></html>";
+    esp01_send_http_response(conn_id, ESP01_HTTP_METHOD_NOT_ALLOWED_CODE, "text/html", body, strlen(body));
+}
+
+/**
+ * @brief Ajoute une route Server-Sent Events.
+ * @param path     Chemin de la route.
+ * @param on_event Callback d'ouverture/fermeture (optionnel).
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_add_route_sse(const char *path, esp01_sse_cb_t on_event)
+{
+    VALIDATE_PARAM(path, ESP01_INVALID_PARAM);                   // Vérifie les paramètres
+    ESP01_Status_t st = esp01_add_route(path, _http_sse_reject); // Méthodes autres que GET refusées
+    if (st == ESP01_OK)
+    {
+        g_routes[g_route_count - 1].on_sse = on_event ? on_event : _http_sse_noop; // Route ajoutée en dernier
+    }
+    return st;
+}
+
+/**
+ * @brief Ouvre un flux SSE sur le lien d'une requête GET.
+ * @param conn_id Identifiant de connexion.
+ * @param req     Requête parsée.
+ * @param route   Route SSE.
+ * @retval true si la requête a été traitée (flux ouvert ou lien perdu).
+ */
+static bool _http_sse_open(int conn_id, const http_parsed_request_t *req, const esp01_route_t *route)
+{
+    if (strcmp(req->method, "GET") != 0)
+    {
+        return false;
+    }
+
+    uint32_t last_id = 0; // Reconnexion : dernier évènement reçu par le navigateur
+    size_t id_len = 0;
+    const char *id = esp01_http_get_header(req, "Last-Event-ID", &id_len);
+    for (size_t i = 0; id && i < id_len && id[i] >= '0' && id[i] <= '9'; i++)
+    {
+        last_id = last_id * 10 + (uint32_t)(id[i] - '0');
+    }
+
+    char header[ESP01_MAX_HEADER_LINE];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.1 200 OK\r\n"
+                     "Content-Type: text/event-stream\r\n"
+                     "Cache-Control: no-cache\r\n"
+                     "%s"
+                     "\r\n"
+                     "retry: %u\n\n",
+                     _http_connection_header(conn_id), (unsigned)ESP01_SSE_RETRY_MS);
+    connection_info_t *conn = &g_connections[conn_id];
+    conn->resp_status = ESP01_HTTP_OK_CODE; // Code retenu pour les métriques
+    esp01_tx_part_t part = {header, (size_t)n};
+    if (_http_link_write(conn_id, &part, 1) != ESP01_OK)
+    {
+        return true; // Lien fermé pendant l'écriture
+    }
+
+    conn->sse_cb = route->on_sse; // Le lien ne reçoit plus de requêtes
+    ESP01_LOG_DEBUG("HTTP", "Flux SSE ouvert sur connexion %d (%s, Last-Event-ID=%lu)", conn_id, req->path, (unsigned long)last_id);
+    route->on_sse(conn_id, ESP01_SSE_EVT_OPEN, last_id);
+    return true;
+}
+
+/**
+ * @brief Met en forme un évènement SSE ("id:", "event:", une ligne "data:" par ligne).
+ * @param buf   Tampon de sortie.
+ * @param size  Taille du tampon.
+ * @param id    Identifiant de l'évènement.
+ * @param event Nom de l'évènement (NULL : aucun).
+ * @param data  Données.
+ * @retval Taille de l'évènement, ou 0 s'il ne tient pas dans le tampon.
+ */
+static size_t _http_sse_format(char *buf, size_t size, uint32_t id, const char *event, const char *data)
+{
+    int n = event ? snprintf(buf, size, "id: %lu\nevent: %s\n", (unsigned long)id, event)
+                  : snprintf(buf, size, "id: %lu\n", (unsigned long)id);
+    size_t len = (n > 0) ? (size_t)n : size;
+    do
+    {
+        size_t line = strcspn(data, "\r\n"); // Une ligne "data:" par ligne du texte
+        if (len + 6 + line + 2 > size)       // "data: " + ligne + "\n" + "\n" final
+        {
+            return 0;
+        }
+        memcpy(buf + len, "data: ", 6);
+        memcpy(buf + len + 6, data, line);
+        len += 6 + line;
+        buf[len++] = '\n';
+        data += line;
+        if (data[0] == '\r' && data[1] == '\n') // Fin de ligne CRLF
+        {
+            data++;
+        }
+    } while (*data++ != '\0');
+    buf[len++] = '\n'; // Fin de l'évènement
+    return len;
+}
+
+/**
+ * @brief Met des octets en file sur un lien SSE, sans attendre de place.
+ * @param conn_id Lien SSE.
+ * @param data    Octets (évènement complet ou commentaire).
+ * @param len     Taille.
+ * @retval ESP01_Status_t Code de statut.
+ */
+static ESP01_Status_t _http_sse_queue(int conn_id, const char *data, size_t len)
+{
+    if (!esp01_sse_is_open(conn_id))
+    {
+        return ESP01_NOT_CONNECTED;
+    }
+    connection_info_t *conn = &g_connections[conn_id];
+    if (len == 0 || len > (size_t)(ESP01_HTTP_TXQ_SIZE - conn->tx_len)) // Client trop lent : l'évènement est perdu
+    {
+        g_stats.sse_dropped++;
+        return ESP01_BUFFER_OVERFLOW;
+    }
+    esp01_tx_part_t part = {data, len};
+    ESP01_Status_t st = _http_link_write(conn_id, &part, 1); // Tient dans la file : pas de tour d'ordonnanceur
+    if (st == ESP01_OK)
+    {
+        conn->last_activity = HAL_GetTick(); // Flux vivant tant que la file se vide
+    }
+    return st;
+}
+
+/**
+ * @brief Met un évènement en file sur un lien SSE.
+ * @param conn_id Lien SSE.
+ * @param event   Nom de l'évènement (NULL : "message").
+ * @param data    Données.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_sse_send(int conn_id, const char *event, const char *data)
+{
+    VALIDATE_PARAM(data, ESP01_INVALID_PARAM);
+    if (!esp01_sse_is_open(conn_id))
+    {
+        return ESP01_NOT_CONNECTED;
+    }
+    char buf[ESP01_HTTP_TXQ_SIZE]; // Un évènement tient dans la file du lien
+    size_t len = _http_sse_format(buf, sizeof(buf), ++g_http_sse_last_id, event, data);
+    ESP01_Status_t st = _http_sse_queue(conn_id, buf, len);
+    if (st == ESP01_OK)
+    {
+        g_stats.sse_events++;
+    }
+    return st;
+}
+
+/**
+ * @brief Met un évènement en file sur tous les liens SSE ouverts.
+ * @param event Nom de l'évènement (NULL : "message").
+ * @param data  Données.
+ * @retval Nombre de liens auxquels l'évènement a été confié.
+ */
+int esp01_sse_broadcast(const char *event, const char *data)
+{
+    VALIDATE_PARAM(data, 0);
+    char buf[ESP01_HTTP_TXQ_SIZE];
+    size_t len = _http_sse_format(buf, sizeof(buf), ++g_http_sse_last_id, event, data); // Même identifiant pour tous
+    int count = 0;
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i)
+    {
+        if (esp01_sse_is_open(i) && _http_sse_queue(i, buf, len) == ESP01_OK)
+        {
+            g_stats.sse_events++;
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Retourne l'identifiant du dernier évènement SSE émis.
+ */
+uint32_t esp01_sse_last_id(void)
+{
+    return g_http_sse_last_id;
+}
+
+/**
+ * @brief Indique si un lien est un flux SSE ouvert.
+ * @param conn_id Identifiant de connexion.
+ * @retval true si SSE et actif.
+ */
+bool esp01_sse_is_open(int conn_id)
+{
+    return conn_id >= 0 && conn_id < ESP01_MAX_CONNECTIONS && g_connections[conn_id].is_active && g_connections[conn_id].sse_cb;
+}
+
+/**
+ * @brief Repasse un lien WebSocket ou SSE en HTTP ; la fermeture sera signalée par l'ordonnanceur.
+ * @param conn Connexion.
+ */
+static void _http_push_detach(connection_info_t *conn)
+{
+    if (conn->ws_cb)
+    {
+        conn->ws_close_cb = conn->ws_cb;
+        conn->ws_cb = NULL;
+        memset(&conn->ws, 0, sizeof(conn->ws));
+    }
+    if (conn->sse_cb)
+    {
+        conn->sse_close_cb = conn->sse_cb;
+        conn->sse_cb = NULL;
+    }
+}
+
+/**
+ * @brief Signale à l'application la fermeture d'un lien WebSocket ou SSE.
+ * @param conn_id Identifiant de connexion.
+ */
+static void _http_push_notify_close(int conn_id)
+{
+    connection_info_t *conn = &g_connections[conn_id];
+    esp01_ws_cb_t ws_cb = conn->ws_close_cb;
+    esp01_sse_cb_t sse_cb = conn->sse_close_cb;
+    conn->ws_close_cb = NULL;
+    conn->sse_close_cb = NULL;
+    if (ws_cb)
+    {
+        ws_cb(conn_id, ESP01_WS_EVT_CLOSE, NULL, 0);
+    }
+    if (sse_cb)
+    {
+        sse_cb(conn_id, ESP01_SSE_EVT_CLOSE, 0);
+    }
+}
+
+// ==================== LIMITATION DE DÉBIT ====================
+
+// Réponses de refus constantes : un seul AT+CIPSEND, aucun formatage (le lien reste ouvert)
+static const char g_http_rl_429[] = "HTTP/1.1 429 Too Many Requests\r\n"
+                                    "Content-Type: text/plain\r\n"
+                                    "Content-Length: 17\r\n"
+                                    "Retry-After: 1\r\n"
+                                    "\r\n"
+                                    "Too Many Requests";
+static const char g_http_rl_503[] = "HTTP/1.1 503 Service Unavailable\r\n"
+                                    "Content-Type: text/plain\r\n"
+                                    "Content-Length: 19\r\n"
+                                    "Retry-After: 1\r\n"
+                                    "\r\n"
+                                    "Service Unavailable";
+
+/**
+ * @brief Configure la limitation de débit des requêtes HTTP.
+ * @param client_rate  Requêtes par seconde et par adresse IP (0 : pas de limite par client).
+ * @param client_burst Rafale autorisée par client.
+ * @param global_rate  Requêtes par seconde, tous clients (0 : pas de limite globale).
+ * @param global_burst Rafale autorisée, tous clients.
+ * @param action       Réponse 429/503 ou fermeture immédiate du lien.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_set_rate_limit(uint16_t client_rate, uint16_t client_burst, uint16_t global_rate, uint16_t global_burst,
+                                         esp01_http_rl_action_t action)
+{
+    VALIDATE_PARAM((client_rate == 0 || client_burst > 0) && (global_rate == 0 || global_burst > 0), ESP01_INVALID_PARAM); // Rafale d'au moins une requête
+    g_http_rl.client_rate = client_rate;
+    g_http_rl.client_burst = client_burst;
+    g_http_rl.global_rate = global_rate;
+    g_http_rl.global_burst = global_burst;
+    g_http_rl.action = action;
+    memset(g_http_rl.clients, 0, sizeof(g_http_rl.clients)); // Seaux pleins au prochain passage
+    g_http_rl.global.tokens = (uint32_t)global_burst * 1000;
+    g_http_rl.global.refill_at = HAL_GetTick();
+    ESP01_LOG_DEBUG("HTTP", "Limitation de débit : %u/s (rafale %u) par client, %u/s (rafale %u) au total", client_rate, client_burst, global_rate, global_burst);
+    return ESP01_OK;
+}
+
+/**
+ * @brief Remplit un seau à jetons selon le temps écoulé (jetons en millièmes).
+ * @param b     Seau.
+ * @param rate  Jetons par seconde.
+ * @param burst Capacité.
+ * @param now   Timestamp courant.
+ */
+static void _http_rl_refill(_http_rl_bucket_t *b, uint16_t rate, uint16_t burst, uint32_t now)
+{
+    uint32_t cap = (uint32_t)burst * 1000;
+    uint32_t elapsed = now - b->refill_at;
+    b->refill_at = now;
+    if (elapsed >= cap / rate + 1) // Seau forcément plein (évite le débordement du produit)
+    {
+        b->tokens = cap;
+    }
+    else
+    {
+        b->tokens = (b->tokens + elapsed * rate > cap) ? cap : b->tokens + elapsed * rate; // rate jetons/s = rate millièmes/ms
+    }
+}
+
+/**
+ * @brief Retourne le seau d'une adresse IP (le moins récemment vu est recyclé).
+ * @param ip  Adresse IP du client.
+ * @param now Timestamp courant.
+ */
+static _http_rl_bucket_t *_http_rl_client(const char *ip, uint32_t now)
+{
+    _http_rl_bucket_t *oldest = &g_http_rl.clients[0];
+    for (int i = 0; i < ESP01_HTTP_RL_CLIENTS; i++)
+    {
+        _http_rl_bucket_t *b = &g_http_rl.clients[i];
+        if (b->ip[0] && strcmp(b->ip, ip) == 0)
+        {
+            return b;
+        }
+        if (!b->ip[0] || (oldest->ip[0] && (int32_t)(b->refill_at - oldest->refill_at) < 0))
+        {
+            oldest = b;
+        }
+    }
+    esp01_safe_strcpy(oldest->ip, sizeof(oldest->ip), ip); // Nouveau client : seau plein
+    oldest->tokens = (uint32_t)g_http_rl.client_burst * 1000;
+    oldest->refill_at = now;
+    return oldest;
+}
+
+/**
+ * @brief Admet ou refuse une requête complète selon les seaux du client et global.
+ * @param conn_id Lien de la requête.
+ * @retval true si la requête peut être routée ; sinon le refus est déjà envoyé.
+ */
+static bool _http_rl_admit(int conn_id)
+{
+    if (!g_http_rl.client_rate && !g_http_rl.global_rate) // Limitation désactivée
+    {
+        return true;
+    }
+
+    connection_info_t *conn = &g_connections[conn_id];
+    uint32_t now = HAL_GetTick();
+    _http_rl_bucket_t *client = NULL;
+    if (g_http_rl.client_rate && conn->client_ip[0]) // IP connue (AT+CIPDINFO=1)
+    {
+        client = _http_rl_client(conn->client_ip, now);
+        _http_rl_refill(client, g_http_rl.client_rate, g_http_rl.client_burst, now);
+    }
+    if (g_http_rl.global_rate)
+    {
+        _http_rl_refill(&g_http_rl.global, g_http_rl.global_rate, g_http_rl.global_burst, now);
+    }
+
+    bool client_ok = !client || client->tokens >= 1000;
+    bool global_ok = !g_http_rl.global_rate || g_http_rl.global.tokens >= 1000;
+    if (client_ok && global_ok) // Une requête consommée dans chaque seau
+    {
+        if (client)
+        {
+            client->tokens -= 1000;
+        }
+        if (g_http_rl.global_rate)
+        {
+            g_http_rl.global.tokens -= 1000;
+        }
+        return true;
+    }
+
+    if (client_ok) // Client raisonnable, serveur saturé
+    {
+        g_stats.rl_global_limited++;
+    }
+    else
+    {
+        g_stats.rl_client_limited++;
+    }
+    ESP01_LOG_DEBUG("HTTP", "Requête refusée sur connexion %d (%s, %s)", conn_id, conn->client_ip[0] ? conn->client_ip : "IP inconnue",
+                    client_ok ? "limite globale" : "limite client");
+    if (g_http_rl.action == ESP01_HTTP_RL_CLOSE) // Fermeture immédiate : pas de réponse
+    {
+        g_stats.rl_closed++;
+        esp01_http_close_connection(conn_id);
+        return false;
+    }
+    const char *reply = client_ok ? g_http_rl_503 : g_http_rl_429;
+    esp01_tx_part_t part = {reply, client_ok ? sizeof(g_http_rl_503) - 1 : sizeof(g_http_rl_429) - 1};
+    conn->resp_status = client_ok ? ESP01_HTTP_UNAVAILABLE_CODE : ESP01_HTTP_TOO_MANY_REQUESTS_CODE; // Code retenu pour les métriques
+    _http_link_write(conn_id, &part, 1);
+    return false;
+}
+
+// ==================== MISE À JOUR OTA ====================
+
+/**
+ * @brief Réception d'une image OTA vers le slot inactif.
+ */
+typedef struct
+{
+    const esp01_ota_flash_t *flash;     // Backend du slot inactif (NULL : OTA désactivée)
+    esp01_ota_state_t state;            // Étape courante
+    int8_t conn_id;                     // Lien de la requête en cours (-1 : aucun)
+    uint16_t fail_status;               // Code HTTP de l'échec
+    const char *fail_msg;               // Motif de l'échec
+    uint32_t size;                      // Taille annoncée (Content-Length)
+    uint32_t received;                  // Octets reçus
+    uint32_t written;                   // Octets transmis au backend
+    uint32_t erased;                    // Fin de la zone effacée
+    uint32_t crc;                       // CRC-32 courant (non complémenté)
+    uint32_t expected_crc;              // CRC-32 annoncé (X-Firmware-CRC32)
+    uint8_t buf[2][ESP01_OTA_BUF_SIZE]; // Tampons ping-pong : l'un se remplit pendant la programmation de l'autre
+    uint16_t fill;                      // Octets dans le tampon courant
+    uint8_t active;                     // Tampon en cours de remplissage
+} _http_ota_t;
+
+static _http_ota_t g_http_ota = {.conn_id = -1}; // Une seule image reçue à la fois
+
+/**
+ * @brief Met à jour un CRC-32 (IEEE 802.3, polynôme réfléchi 0xEDB88320), table de 16 entrées.
+ * @param crc  CRC courant (0xFFFFFFFF au départ, à complémenter à la fin).
+ * @param data Octets.
+ * @param len  Nombre d'octets.
+ * @retval CRC mis à jour.
+ */
+static uint32_t _http_crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    static const uint32_t k_crc_nibble[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+    for (size_t i = 0; i < len; i++)
+    {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ k_crc_nibble[crc & 0x0F]; // Quartet de poids faible
+        crc = (crc >> 4) ^ k_crc_nibble[crc & 0x0F]; // Quartet de poids fort
+    }
+    return crc;
+}
+
+/**
+ * @brief Attend la fin de l'opération flash en cours (backend asynchrone).
+ * @retval ESP01_OK, ou ESP01_TIMEOUT après ESP01_OTA_FLASH_TIMEOUT_MS.
+ * @note  Le DMA RX est vidé dans l'accumulateur pendant l'attente (les trames
+ *        suivantes ne débordent pas le tampon circulaire). Appelée depuis le
+ *        callback de corps, donc pendant l'analyse : rien n'est analysé ici.
+ */
+static ESP01_Status_t _http_ota_wait(void)
+{
+    const esp01_ota_flash_t *f = g_http_ota.flash;
+    uint32_t start = HAL_GetTick();
+    while (f->busy && f->busy(f->ctx))
+    {
+        _http_acc_fill(); // Ajout en fin d'accumulateur uniquement : les octets en cours d'analyse ne bougent pas
+        if (HAL_GetTick() - start > ESP01_OTA_FLASH_TIMEOUT_MS)
+        {
+            return ESP01_TIMEOUT;
+        }
+    }
+    return ESP01_OK;
+}
+
+/**
+ * @brief Abandonne l'image en cours : le slot actif reste celui qui démarre (rollback).
+ * @param status Code HTTP à répondre (0 : lien fermé, aucune réponse).
+ * @param msg    Motif (JSON, ASCII).
+ */
+static void _http_ota_fail(uint16_t status, const char *msg)
+{
+    const esp01_ota_flash_t *f = g_http_ota.flash;
+    if (g_http_ota.state == ESP01_OTA_RECEIVING && f->abort)
+    {
+        f->abort(f->ctx);
+    }
+    g_http_ota.state = ESP01_OTA_FAILED;
+    g_http_ota.fail_status = status;
+    g_http_ota.fail_msg = msg;
+    ESP01_LOG_ERROR("OTA", "Image refusée après %lu octets : %s", (unsigned long)g_http_ota.received, msg);
+}
+
+/**
+ * @brief Efface le bloc suivant dès que le backend est libre, pendant la réception du tampon courant.
+ * @retval ESP01_Status_t Statut de l'effacement démarré (ESP01_OK si rien à faire).
+ */
+static ESP01_Status_t _http_ota_erase_ahead(void)
+{
+    const esp01_ota_flash_t *f = g_http_ota.flash;
+    if (!f->erase_size || g_http_ota.erased >= g_http_ota.size || g_http_ota.erased >= g_http_ota.written + ESP01_OTA_BUF_SIZE)
+    {
+        return ESP01_OK; // Prochain tampon déjà couvert
+    }
+    if (f->busy && f->busy(f->ctx))
+    {
+        return ESP01_OK; // Programmation en cours : nouvel essai au prochain morceau
+    }
+    ESP01_Status_t st = f->erase(f->ctx, g_http_ota.erased);
+    g_http_ota.erased += f->erase_size;
+    return st;
+}
+
+/**
+ * @brief Programme le tampon courant et bascule sur l'autre.
+ * @retval ESP01_Status_t Statut du backend.
+ * @note  Le dernier tampon est complété par 0xFF jusqu'à write_align (non compté dans le CRC).
+ */
+static ESP01_Status_t _http_ota_flush(void)
+{
+    const esp01_ota_flash_t *f = g_http_ota.flash;
+    uint8_t *buf = g_http_ota.buf[g_http_ota.active];
+    uint16_t len = g_http_ota.fill;
+    if (len == 0)
+    {
+        return ESP01_OK;
+    }
+    if (f->write_align > 1)
+    {
+        while (len % f->write_align)
+        {
+            buf[len++] = 0xFF;
+        }
+    }
+
+    ESP01_Status_t st = _http_ota_wait(); // Programmation du tampon précédent (ou effacement anticipé) terminée
+    while (st == ESP01_OK && f->erase_size && g_http_ota.erased < g_http_ota.written + len) // Bloc pas encore effacé
+    {
+        st = f->erase(f->ctx, g_http_ota.erased);
+        g_http_ota.erased += f->erase_size;
+        if (st == ESP01_OK)
+        {
+            st = _http_ota_wait();
+        }
+    }
+    if (st == ESP01_OK)
+    {
+        st = f->write(f->ctx, g_http_ota.written, buf, len); // Peut rendre la main avant la fin (busy)
+    }
+    g_http_ota.written += len;
+    g_http_ota.active ^= 1; // L'autre tampon est libre : son écriture a été attendue
+    g_http_ota.fill = 0;
+    return st;
+}
+
+/**
+ * @brief Démarre la réception d'une image (premier morceau du corps).
+ * @param conn_id Lien de la requête.
+ * @param req     Requête (méthode, Content-Length, X-Firmware-CRC32).
+ */
+static void _http_ota_begin(int conn_id, const http_parsed_request_t *req)
+{
+    _http_ota_t *ota = &g_http_ota;
+    if (ota->state == ESP01_OTA_RECEIVING && ota->flash->abort) // Image précédente du lien jamais terminée
+    {
+        ota->flash->abort(ota->flash->ctx);
+    }
+    ota->conn_id = (int8_t)conn_id;
+    ota->state = ESP01_OTA_RECEIVING;
+    ota->size = req->content_length;
+    ota->received = 0;
+    ota->written = 0;
+    ota->erased = 0;
+    ota->fill = 0;
+    ota->active = 0;
+    ota->crc = 0xFFFFFFFFUL;
+
+    char hex[12];
+    char *end = NULL;
+    if (strcmp(req->method, "POST") != 0 && strcmp(req->method, "PUT") != 0)
+    {
+        _http_ota_fail(ESP01_HTTP_METHOD_NOT_ALLOWED_CODE, "POST ou PUT attendu");
+    }
+    else if (ota->size > ota->flash->slot_size)
+    {
+        _http_ota_fail(ESP01_HTTP_PAYLOAD_TOO_LARGE_CODE, "Image plus grande que le slot");
+    }
+    else if (esp01_http_copy_header(req, "X-Firmware-CRC32", hex, sizeof(hex)) != ESP01_OK || !hex[0])
+    {
+        _http_ota_fail(ESP01_HTTP_BAD_REQUEST_CODE, "En-tete X-Firmware-CRC32 manquant");
+    }
+    else
+    {
+        ota->expected_crc = (uint32_t)strtoul(hex, &end, 16); // Hexadécimal, comme la sortie de crc32(1)
+        if (*end != '\0')
+        {
+            _http_ota_fail(ESP01_HTTP_BAD_REQUEST_CODE, "X-Firmware-CRC32 invalide");
+        }
+        else
+        {
+            ESP01_LOG_DEBUG("OTA", "Réception d'une image de %lu octets (conn %d)", (unsigned long)ota->size, conn_id);
+        }
+    }
+}
+
+/**
+ * @brief Callback de corps de la route OTA : CRC au fil de l'eau, tampons ping-pong vers le backend.
+ */
+static void _http_ota_body(int conn_id, const http_parsed_request_t *req, const uint8_t *data, size_t len)
+{
+    _http_ota_t *ota = &g_http_ota;
+    if (g_connections[conn_id].parser.body_received == 0 && !(ota->state == ESP01_OTA_RECEIVING && ota->conn_id != conn_id))
+    {
+        _http_ota_begin(conn_id, req); // Premier morceau (un autre lien en cours garde la main)
+    }
+    if (ota->state != ESP01_OTA_RECEIVING || ota->conn_id != conn_id)
+    {
+        return; // Image refusée ou concurrente : le reste du corps est ignoré
+    }
+
+    ota->crc = _http_crc32(ota->crc, data, len);
+    ota->received += (uint32_t)len;
+    ESP01_Status_t st = _http_ota_erase_ahead();
+    while (st == ESP01_OK && len > 0)
+    {
+        size_t n = ESP01_OTA_BUF_SIZE - ota->fill; // Place dans le tampon courant
+        if (n > len)
+        {
+            n = len;
+        }
+        memcpy(ota->buf[ota->active] + ota->fill, data, n);
+        ota->fill += (uint16_t)n;
+        data += n;
+        len -= n;
+        if (ota->fill == ESP01_OTA_BUF_SIZE)
+        {
+            st = _http_ota_flush();
+        }
+    }
+    if (st != ESP01_OK)
+    {
+        _http_ota_fail(ESP01_HTTP_INTERNAL_ERR_CODE, "Erreur d'ecriture flash");
+    }
+}
+
+/**
+ * @brief Termine l'image : dernier tampon, vérification du CRC puis validation du slot.
+ */
+static void _http_ota_finish(void)
+{
+    _http_ota_t *ota = &g_http_ota;
+    ESP01_Status_t st = _http_ota_flush(); // Dernier tampon, complété à l'alignement
+    if (st == ESP01_OK)
+    {
+        st = _http_ota_wait();
+    }
+    uint32_t crc = ota->crc ^ 0xFFFFFFFFUL;
+    if (st != ESP01_OK)
+    {
+        _http_ota_fail(ESP01_HTTP_INTERNAL_ERR_CODE, "Erreur d'ecriture flash");
+    }
+    else if (ota->received != ota->size)
+    {
+        _http_ota_fail(ESP01_HTTP_BAD_REQUEST_CODE, "Image incomplete");
+    }
+    else if (crc != ota->expected_crc)
+    {
+        _http_ota_fail(ESP01_HTTP_BAD_REQUEST_CODE, "CRC-32 invalide");
+    }
+    else if (ota->flash->commit(ota->flash->ctx, ota->size, crc) != ESP01_OK)
+    {
+        _http_ota_fail(ESP01_HTTP_INTERNAL_ERR_CODE, "Validation du slot refusee");
+    }
+    else
+    {
+        ota->state = ESP01_OTA_DONE;
+        ESP01_LOG_DEBUG("OTA", "Image de %lu octets validée (CRC-32 %08lX)", (unsigned long)ota->size, (unsigned long)crc);
+    }
+}
+
+/**
+ * @brief Répond à une requête OTA en JSON.
+ * @note  Sans effet si le lien est fermé ou sans code de réponse.
+ */
+static void _http_ota_reply(int conn_id, int status, const char *msg)
+{
+    if (status == 0 || !g_connections[conn_id].is_active)
+    {
+        ESP01_LOG_DEBUG("OTA", "Pas de réponse : connexion %d fermée", conn_id);
+        return;
+    }
+    char body[96];
+    int n = (status == ESP01_HTTP_OK_CODE)
+                ? snprintf(body, sizeof(body), "{\"status\":\"ok\",\"size\":%lu,\"crc32\":\"%08lx\"}", (unsigned long)g_http_ota.size,
+                           (unsigned long)g_http_ota.expected_crc)
+                : snprintf(body, sizeof(body), "{\"status\":\"error\",\"message\":\"%s\"}", msg);
+    esp01_send_http_response(conn_id, status, "application/json", body, (size_t)n);
+}
+
+/**
+ * @brief Handler de la route OTA, appelé une fois le corps entièrement reçu.
+ */
+static void _http_ota_handler(int conn_id, const http_parsed_request_t *req)
+{
+    _http_ota_t *ota = &g_http_ota;
+    if (ota->conn_id != conn_id) // Aucun morceau de cette requête pris en compte
+    {
+        if (strcmp(req->method, "POST") != 0 && strcmp(req->method, "PUT") != 0)
+        {
+            _http_ota_reply(conn_id, ESP01_HTTP_METHOD_NOT_ALLOWED_CODE, "POST ou PUT attendu");
+        }
+        else if (ota->state == ESP01_OTA_RECEIVING)
+        {
+            _http_ota_reply(conn_id, ESP01_HTTP_CONFLICT_CODE, "Mise a jour deja en cours");
+        }
+        else
+        {
+            _http_ota_reply(conn_id, ESP01_HTTP_LENGTH_REQUIRED_CODE, "Image vide ou Content-Length absent");
+        }
+        return;
+    }
+    ota->conn_id = -1; // Requête terminée
+    if (ota->state == ESP01_OTA_RECEIVING)
+    {
+        _http_ota_finish();
+    }
+    if (ota->state == ESP01_OTA_DONE)
+    {
+        _http_ota_reply(conn_id, ESP01_HTTP_OK_CODE, NULL);
+    }
+    else if (ota->fail_status != 0) // Sinon lien fermé pendant la réception : personne à qui répondre
+    {
+        _http_ota_reply(conn_id, ota->fail_status, ota->fail_msg);
+    }
+}
+
+/**
+ * @brief Abandonne l'image si son lien a été fermé ou réutilisé avant la fin du corps.
+ */
+static void _http_ota_watch(void)
+{
+    if (g_http_ota.state != ESP01_OTA_RECEIVING)
+    {
+        return;
+    }
+    const connection_info_t *conn = &g_connections[g_http_ota.conn_id];
+    if (conn->is_active && (conn->in_handler || conn->parser.state == HTTP_PARSER_BODY || conn->parser.state == HTTP_PARSER_COMPLETE))
+    {
+        return;
+    }
+    _http_ota_fail(0, "Lien ferme pendant la reception");
+    g_http_ota.conn_id = -1;
+}
+
+/**
+ * @brief Ajoute la route de mise à jour OTA (corps de la requête écrit dans le slot inactif).
+ * @param path  Chemin de la route (NULL : "/ota").
+ * @param flash Backend du slot inactif (doit rester valide).
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_enable_ota(const char *path, const esp01_ota_flash_t *flash)
+{
+    VALIDATE_PARAM(flash && flash->write && flash->commit && flash->slot_size, ESP01_INVALID_PARAM);
+    VALIDATE_PARAM(!flash->erase_size || flash->erase, ESP01_INVALID_PARAM);
+    VALIDATE_PARAM(flash->write_align <= 1 || ESP01_OTA_BUF_SIZE % flash->write_align == 0, ESP01_INVALID_PARAM); // Tampons pleins alignés
+    g_http_ota.flash = flash;
+    g_http_ota.state = ESP01_OTA_IDLE;
+    g_http_ota.conn_id = -1;
+    return esp01_add_route_stream(path ? path : "/ota", _http_ota_handler, _http_ota_body);
+}
+
+/**
+ * @brief Retourne l'état de la mise à jour OTA.
+ * @param received Octets reçus de l'image (NULL : ignoré).
+ * @param total    Taille annoncée de l'image (NULL : ignoré).
+ * @retval esp01_ota_state_t État courant.
+ */
+esp01_ota_state_t esp01_http_ota_state(uint32_t *received, uint32_t *total)
+{
+    if (received)
+    {
+        *received = g_http_ota.received;
+    }
+    if (total)
+    {
+        *total = g_http_ota.size;
+    }
+    return g_http_ota.state;
+}
+
+// ==================== FICHIERS (STOCKAGE EXTERNE) ====================
+
+/**
+ * @brief Type MIME d'après l'extension du nom de fichier.
+ */
+static const char *_http_file_type(const char *name)
+{
+    static const struct
+    {
+        const char *ext;
+        const char *type;
+    } k_types[] = {
+        {".csv", "text/csv"}, {".txt", "text/plain"}, {".log", "text/plain"}, {".json", "application/json"},
+        {".html", "text/html"}, {".js", "application/javascript"}, {".css", "text/css"}, {".png", "image/png"},
+    };
+    const char *dot = strrchr(name, '.');
+    for (size_t i = 0; dot && i < sizeof(k_types) / sizeof(k_types[0]); i++)
+    {
+        if (strcmp(dot, k_types[i].ext) == 0)
+        {
+            return k_types[i].type;
+        }
+    }
+    return "application/octet-stream";
+}
+
+/**
+ * @brief Analyse un en-tête Range à intervalle unique ("bytes=a-b", "bytes=a-", "bytes=-n").
+ * @param value Valeur de l'en-tête (terminée par '\0').
+ * @param size  Taille du fichier.
+ * @param first Premier octet demandé (sortie).
+ * @param last  Dernier octet demandé, inclus (sortie).
+ * @retval 1 si l'intervalle est valide, 0 si l'en-tête est ignoré (syntaxe, plusieurs
+ *         intervalles : fichier entier), -1 s'il est hors du fichier (416).
+ */
+static int _http_parse_range(const char *value, uint32_t size, uint32_t *first, uint32_t *last)
+{
+    if (strncmp(value, "bytes=", 6) != 0 || strchr(value, ',')) // Autre unité ou plusieurs intervalles
+    {
+        return 0;
+    }
+    const char *p = value + 6;
+    char *end;
+    if (*p == '-') // Suffixe : les n derniers octets
+    {
+        unsigned long n = strtoul(p + 1, &end, 10);
+        if (end == p + 1 || *end != '\0')
+        {
+            return 0;
+        }
+        if (n == 0 || size == 0)
+        {
+            return -1;
+        }
+        *first = n >= size ? 0 : size - (uint32_t)n;
+        *last = size - 1;
+        return 1;
+    }
+    unsigned long a = strtoul(p, &end, 10);
+    if (end == p || *end != '-')
+    {
+        return 0;
+    }
+    p = end + 1;
+    unsigned long b = size ? size - 1 : 0; // "a-" : jusqu'à la fin
+    if (*p)
+    {
+        b = strtoul(p, &end, 10);
+        if (end == p || *end != '\0' || b < a)
+        {
+            return 0;
+        }
+    }
+    if (a >= size) // Début au-delà de la fin
+    {
+        return -1;
+    }
+    *first = (uint32_t)a;
+    *last = b >= size ? size - 1 : (uint32_t)b;
+    return 1;
+}
+
+/**
+ * @brief Handler des routes de fichiers : GET/HEAD, Range à intervalle unique, lecture par blocs.
+ * @param conn_id Identifiant de connexion.
+ * @param req     Requête parsée.
+ */
+static void _http_file_handler(int conn_id, const http_parsed_request_t *req)
+{
+    const esp01_route_t *route = _http_find_route(req->path);
+    const esp01_http_storage_t *storage = route ? route->storage : NULL;
+    const char *name = req->path + strlen(route ? route->path : "") + 1; // Nom relatif au préfixe
+    bool head = strcmp(req->method, "HEAD") == 0;
+    if (!head && strcmp(req->method, "GET") != 0)
+    {
+        const char *body = "<html><body><h1>405 GET ou HEAD attendu</h1></body></html>";
+        esp01_send_http_response(conn_id, ESP01_HTTP_METHOD_NOT_ALLOWED_CODE, "text/html", body, strlen(body));
+        return;
+    }
+    uint32_t size = 0;
+    const char *type = NULL;
+    if (!storage || !*name || strstr(name, "..") || storage->stat(storage->ctx, name, &size, &type) != ESP01_OK)
+    {
+        esp01_send_404_response(conn_id); // Fichier absent (ou chemin hors du préfixe)
+        return;
+    }
+
+    uint32_t start = HAL_GetTick();
+    uint32_t first = 0, last = size ? size - 1 : 0;
+    char range[48];
+    int partial = 0;
+    if (esp01_http_copy_header(req, "Range", range, sizeof(range)) == ESP01_OK)
+    {
+        partial = _http_parse_range(range, size, &first, &last);
+    }
+    int status = partial > 0 ? ESP01_HTTP_PARTIAL_CONTENT_CODE : partial < 0 ? ESP01_HTTP_RANGE_NOT_SATISFIABLE_CODE : ESP01_HTTP_OK_CODE;
+    uint32_t length = (partial < 0 || size == 0) ? 0 : last - first + 1;
+
+    char header[ESP01_MAX_HEADER_LINE];
+    size_t n = 0;
+    bool fits = _http_fmt_append(header, sizeof(header), &n, "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %lu\r\nAccept-Ranges: bytes\r\n",
+                                 status, _http_status_text(status), type ? type : _http_file_type(name), (unsigned long)length); // Type MIME du stockage : non borné
+    if (fits && status == ESP01_HTTP_PARTIAL_CONTENT_CODE)
+    {
+        fits = _http_fmt_append(header, sizeof(header), &n, "Content-Range: bytes %lu-%lu/%lu\r\n", (unsigned long)first, (unsigned long)last,
+                                (unsigned long)size);
+    }
+    else if (fits && status == ESP01_HTTP_RANGE_NOT_SATISFIABLE_CODE)
+    {
+        fits = _http_fmt_append(header, sizeof(header), &n, "Content-Range: bytes */%lu\r\n", (unsigned long)size);
+    }
+    if (!fits || !_http_fmt_append(header, sizeof(header), &n, "%s\r\n", _http_connection_header(conn_id)))
+    {
+        ESP01_LOG_ERROR("HTTP", "En-tête de fichier trop long (type MIME de %s)", name);
+        esp01_send_http_response(conn_id, ESP01_HTTP_INTERNAL_ERR_CODE, "text/plain", "Erreur interne", strlen("Erreur interne"));
+        return;
+    }
+
+    g_connections[conn_id].resp_status = (uint16_t)status; // Code retenu pour les métriques
+    esp01_tx_part_t part = {header, n};
+    ESP01_Status_t st = _http_link_write(conn_id, &part, 1);
+    uint8_t block[ESP01_HTTP_FILE_CHUNK]; // Bloc lu : la file du lien régule le débit
+    uint32_t offset = first;
+    while (st == ESP01_OK && !head && length > 0)
+    {
+        size_t want = length < sizeof(block) ? length : sizeof(block);
+        int got = storage->read(storage->ctx, name, offset, block, want);
+        if (got <= 0) // Erreur, ou fin de fichier avant la taille annoncée : le client voit une réponse tronquée
+        {
+            ESP01_LOG_ERROR("HTTP", "Lecture de %s échouée à l'offset %lu", name, (unsigned long)offset);
+            esp01_http_close_connection(conn_id);
+            return; // Réponse incomplète : non comptée dans les statistiques
+        }
+        if ((size_t)got > want) // Backend qui annonce plus que demandé : jamais au-delà du bloc
+        {
+            got = (int)want;
+        }
+        part = (esp01_tx_part_t){block, (size_t)got};
+        st = _http_link_write(conn_id, &part, 1);
+        offset += (uint32_t)got;
+        length -= (uint32_t)got;
+    }
+    ESP01_LOG_DEBUG("HTTP", "Fichier %s : %d, octets %lu-%lu/%lu", name, status, (unsigned long)first, (unsigned long)last, (unsigned long)size);
+    _http_record_stats(status, start); // Met à jour les statistiques
+}
+
+/**
+ * @brief Sert les fichiers d'un stockage externe sous un préfixe de chemin.
+ * @param prefix  Préfixe (ex: "/files" sert "/files/log.csv" comme "log.csv").
+ * @param storage Backend de stockage (doit rester valide).
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_add_route_files(const char *prefix, const esp01_http_storage_t *storage)
+{
+    VALIDATE_PARAM(prefix && prefix[0] == '/' && prefix[1] && prefix[strlen(prefix) - 1] != '/', ESP01_INVALID_PARAM); // "/x", sans '/' final
+    VALIDATE_PARAM(storage && storage->stat && storage->read, ESP01_INVALID_PARAM);
+    ESP01_Status_t st = esp01_add_route(prefix, _http_file_handler);
+    if (st == ESP01_OK)
+    {
+        g_routes[g_route_count - 1].storage = storage; // Route de préfixe
+    }
+    return st;
+}
+
+// ==================== CLIENT HTTP ====================
+
+/**
+ * @brief États du parseur de réponse du client HTTP.
+ */
+typedef enum
+{
+    _HTTP_CLIENT_STATUS = 0,  // Ligne de statut
+    _HTTP_CLIENT_HEADERS,     // En-têtes
+    _HTTP_CLIENT_BODY,        // Corps (Content-Length ou jusqu'à la fermeture)
+    _HTTP_CLIENT_CHUNK_SIZE,  // Ligne de taille d'un chunk
+    _HTTP_CLIENT_CHUNK_DATA,  // Données d'un chunk
+    _HTTP_CLIENT_CHUNK_END,   // CRLF après les données d'un chunk
+    _HTTP_CLIENT_TRAILER,     // En-têtes de fin (ignorés)
+    _HTTP_CLIENT_DONE,        // Réponse complète
+    _HTTP_CLIENT_ERROR        // Réponse invalide
+} _http_client_state_t;
+
+/**
+ * @brief Connexion persistante et réponse en cours du client HTTP.
+ */
+typedef struct
+{
+    int link;                                // Lien sortant (-1 : aucun)
+    char host[ESP01_HTTP_CLIENT_HOST_LEN];   // Hôte de la connexion persistante
+    uint16_t port;                           // Port de la connexion persistante
+    bool busy;                               // Requête en cours
+    _http_client_state_t state;              // État du parseur de réponse
+    char line[ESP01_HTTP_CLIENT_LINE_LEN];   // Ligne en cours (statut, en-tête, taille de chunk)
+    uint16_t line_len;                       // Octets de la ligne
+    bool head;                               // Requête HEAD : pas de corps
+    bool chunked;                            // Transfer-Encoding: chunked
+    bool keep_alive;                         // Connexion réutilisable après la réponse
+    bool until_close;                        // Corps délimité par la fermeture du lien
+    uint32_t left;                           // Octets restants (corps ou chunk)
+    uint32_t received;                       // Octets reçus pour la requête en cours
+    uint32_t last_rx;                        // Timestamp du dernier octet reçu
+    const esp01_http_client_req_t *req;      // Requête en cours (callbacks)
+    esp01_http_client_resp_t *resp;          // Résultat en cours
+} _http_client_t;
+
+static _http_client_t g_http_client = {.link = -1}; // Client HTTP (une requête à la fois)
+
+/**
+ * @brief Traite une ligne complète de la réponse (statut, en-tête, taille de chunk).
+ * @param cl   Client.
+ * @param line Ligne sans CRLF.
+ * @param len  Longueur.
+ */
+static void _http_client_line(_http_client_t *cl, const char *line, size_t len)
+{
+    esp01_http_client_resp_t *resp = cl->resp;
+    switch (cl->state)
+    {
+    case _HTTP_CLIENT_STATUS: // "HTTP/1.1 200 OK"
+        if (len < 12 || strncmp(line, "HTTP/1.", 7) != 0 || line[8] != ' ' || line[9] < '1' || line[9] > '5' ||
+            !isdigit((unsigned char)line[10]) || !isdigit((unsigned char)line[11])) // Trois chiffres
+        {
+            cl->state = _HTTP_CLIENT_ERROR;
+            return;
+        }
+        resp->status_code = (line[9] - '0') * 100 + (line[10] - '0') * 10 + (line[11] - '0');
+        resp->content_length = -1;
+        cl->keep_alive = (line[7] == '1'); // HTTP/1.0 : fermeture par défaut
+        cl->chunked = false;
+        cl->state = _HTTP_CLIENT_HEADERS;
+        return;
+
+    case _HTTP_CLIENT_HEADERS:
+        if (len == 0) // Fin des en-têtes : cadrage du corps
+        {
+            int code = resp->status_code;
+            if (code < 200) // 100 Continue... : la vraie réponse suit
+            {
+                cl->state = _HTTP_CLIENT_STATUS;
+            }
+            else if (cl->head || code == ESP01_HTTP_NO_CONTENT_CODE || code == ESP01_HTTP_NOT_MODIFIED_CODE)
+            {
+                cl->state = _HTTP_CLIENT_DONE;
+            }
+            else if (cl->chunked)
+            {
+                cl->state = _HTTP_CLIENT_CHUNK_SIZE;
+            }
+            else if (resp->content_length >= 0)
+            {
+                cl->left = (uint32_t)resp->content_length;
+                cl->state = cl->left ? _HTTP_CLIENT_BODY : _HTTP_CLIENT_DONE;
+            }
+            else // Ni longueur ni chunks : le corps s'arrête à la fermeture
+            {
+                cl->until_close = true;
+                cl->keep_alive = false;
+                cl->state = _HTTP_CLIENT_BODY;
+            }
+            return;
+        }
+        {
+            const char *colon = memchr(line, ':', len);
+            if (!colon) // Ligne d'en-tête invalide : ignorée
+            {
+                return;
+            }
+            size_t name_len = (size_t)(colon - line);
+            const char *value = colon + 1;
+            size_t value_len = len - name_len - 1;
+            while (value_len > 0 && (*value == ' ' || *value == '\t')) // Espaces autour de la valeur
+            {
+                value++, value_len--;
+            }
+            while (value_len > 0 && (value[value_len - 1] == ' ' || value[value_len - 1] == '\t'))
+            {
+                value_len--;
+            }
+
+            if (name_len == 14 && _http_equals_nocase(line, "Content-Length", 14))
+            {
+                uint32_t n = 0; // Valeur décodée
+                for (size_t i = 0; i < value_len; i++)
+                {
+                    if (!isdigit((unsigned char)value[i]) || n > (UINT32_MAX - 9) / 10) // Caractère invalide ou débordement
+                    {
+                        cl->state = _HTTP_CLIENT_ERROR;
+                        return;
+                    }
+                    n = n * 10 + (uint32_t)(value[i] - '0');
+                }
+                if (value_len == 0 || n > INT32_MAX) // Vide, ou hors de content_length (-1 : absent)
+                {
+                    cl->state = _HTTP_CLIENT_ERROR;
+                    return;
+                }
+                resp->content_length = (int32_t)n;
+            }
+            else if (name_len == 17 && _http_equals_nocase(line, "Transfer-Encoding", 17))
+            {
+                cl->chunked = (value_len >= 7 && _http_equals_nocase(value + value_len - 7, "chunked", 7)); // Dernier codage appliqué
+            }
+            else if (name_len == 10 && _http_equals_nocase(line, "Connection", 10))
+            {
+                if (value_len == 5 && _http_equals_nocase(value, "close", 5))
+                {
+                    cl->keep_alive = false;
+                }
+                else if (value_len == 10 && _http_equals_nocase(value, "keep-alive", 10))
+                {
+                    cl->keep_alive = true;
+                }
+            }
+            if (cl->req->on_header)
+            {
+                cl->req->on_header(line, name_len, value, value_len, cl->req->ctx);
+            }
+        }
+        return;
+
+    case _HTTP_CLIENT_CHUNK_SIZE: // Taille hexadécimale, extensions ";..." ignorées
+    {
+        uint32_t n = 0;
+        size_t i = 0;
+        for (; i < len; i++)
+        {
+            char c = line[i];
+            int digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : -1;
+            if (digit < 0 || n > 0x0FFFFFFF)
+            {
+                break;
+            }
+            n = (n << 4) | (uint32_t)digit;
+        }
+        if (i == 0) // Pas de taille
+        {
+            cl->state = _HTTP_CLIENT_ERROR;
+        }
+        else if (n == 0) // Dernier chunk
+        {
+            cl->state = _HTTP_CLIENT_TRAILER;
+        }
+        else
+        {
+            cl->left = n;
+            cl->state = _HTTP_CLIENT_CHUNK_DATA;
+        }
+        return;
+    }
+
+    case _HTTP_CLIENT_CHUNK_END:
+        cl->state = (len == 0) ? _HTTP_CLIENT_CHUNK_SIZE : _HTTP_CLIENT_ERROR;
+        return;
+
+    case _HTTP_CLIENT_TRAILER:
+        if (len == 0)
+        {
+            cl->state = _HTTP_CLIENT_DONE;
+        }
+        return;
+
+    default:
+        return;
+    }
+}
+
+/**
+ * @brief Alimente le parseur de réponse du client avec le payload d'une trame +IPD.
+ * @param data Payload.
+ * @param len  Taille.
+ * @retval Nombre d'octets consommés (toujours len : rien n'attend l'ordonnanceur).
+ */
+static size_t _http_client_feed(const uint8_t *data, size_t len)
+{
+    _http_client_t *cl = &g_http_client;
+    if (!cl->busy) // Pas de requête en cours : octets ignorés
+    {
+        return len;
+    }
+    cl->received += (uint32_t)len;
+    cl->last_rx = HAL_GetTick();
+
+    size_t pos = 0;
+    while (pos < len && cl->state != _HTTP_CLIENT_DONE && cl->state != _HTTP_CLIENT_ERROR)
+    {
+        if (cl->state == _HTTP_CLIENT_BODY || cl->state == _HTTP_CLIENT_CHUNK_DATA) // Corps : transmis sans copie
+        {
+            size_t n = len - pos;
+            if (!cl->until_close && n > cl->left)
+            {
+                n = cl->left;
+            }
+            if (cl->req->on_body)
+            {
+                cl->req->on_body(data + pos, n, cl->req->ctx);
+            }
+            cl->resp->body_len += (uint32_t)n;
+            pos += n;
+            if (cl->until_close)
+            {
+                continue;
+            }
+            cl->left -= (uint32_t)n;
+            if (cl->left == 0)
+            {
+                cl->state = (cl->state == _HTTP_CLIENT_BODY) ? _HTTP_CLIENT_DONE : _HTTP_CLIENT_CHUNK_END;
+            }
+            continue;
+        }
+        char c = (char)data[pos++]; // Lignes : accumulées jusqu'au LF
+        if (c == '\n')
+        {
+            size_t n = cl->line_len;
+            if (n > 0 && cl->line[n - 1] == '\r')
+            {
+                n--;
+            }
+            cl->line_len = 0;
+            _http_client_line(cl, cl->line, n);
+        }
+        else if (cl->line_len < sizeof(cl->line)) // Au-delà : ligne tronquée
+        {
+            cl->line[cl->line_len++] = c;
+        }
+    }
+    return len;
+}
+
+/**
+ * @brief Indique si la connexion persistante du client vise cet hôte et est encore ouverte.
+ */
+static bool _http_client_connected(const char *host, uint16_t port)
+{
+    const _http_client_t *cl = &g_http_client;
+    return cl->link >= 0 && g_connections[cl->link].is_active && g_connections[cl->link].is_client &&
+           cl->port == port && strcmp(cl->host, host) == 0;
+}
+
+/**
+ * @brief Ouvre un lien sortant vers un hôte (AT+CIPSTART sur le premier lien libre).
+ * @param host Hôte (nom ou IP).
+ * @param port Port TCP.
+ * @retval ESP01_Status_t Code de statut.
+ */
+static ESP01_Status_t _http_client_connect(const char *host, uint16_t port)
+{
+    esp01_http_client_close(); // Connexion vers un autre hôte, ou fermée par le serveur
+
+    int link = -1;
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS && link < 0; ++i)
+    {
+        if (!g_connections[i].is_active)
+        {
+            link = i;
+        }
+    }
+    if (link < 0)
+    {
+        ESP01_LOG_WARN("HTTP_CLIENT", "Aucun lien libre pour %s:%u", host, port);
+        return ESP01_FAIL;
+    }
+
+    connection_info_t *conn = &g_connections[link];
+    _http_drop_held(link); // Trames d'un ancien occupant du lien abandonnées
+    memset(conn, 0, sizeof(*conn));
+    conn->conn_id = link;
+    conn->is_client = true; // "n,CONNECT" : lien sortant, pas un client du serveur
+
+    esp01_send_wait_idle(ESP01_TIMEOUT_LONG); // Aucune commande acceptée avant le "SEND OK" en attente
+    char cmd[ESP01_MAX_CMD_BUF];
+    int cmd_len = snprintf(cmd, sizeof(cmd), "AT+CIPSTART=%d,\"TCP\",\"%s\",%u\r\n", link, host, port);
+    g_http_rx_events = 0;
+    esp01_uart_write(cmd, cmd_len); // Envoie la commande (sans vidage RX)
+    ESP01_Status_t st = _http_wait_event(ESP01_HTTP_EVT_OK | ESP01_HTTP_EVT_ERROR, ESP01_TIMEOUT_LONG); // DNS + connexion TCP
+    if (st != ESP01_OK || !(g_http_rx_events & ESP01_HTTP_EVT_OK) || !conn->is_active)
+    {
+        ESP01_LOG_WARN("HTTP_CLIENT", "Connexion à %s:%u échouée (code=%d)", host, port, st);
+        conn->is_client = false;
+        return ESP01_CONNECTION_ERROR;
+    }
+    g_http_client.link = link;
+    esp01_safe_strcpy(g_http_client.host, sizeof(g_http_client.host), host);
+    g_http_client.port = port;
+    ESP01_LOG_DEBUG("HTTP_CLIENT", "Connecté à %s:%u sur le lien %d", host, port, link);
+    return ESP01_OK;
+}
+
+/**
+ * @brief Écrit la requête (ligne, en-têtes, corps) dans la file du lien du client.
+ * @param req  Requête.
+ * @param path Chemin + query (dans l'URL).
+ * @retval ESP01_Status_t Code de statut.
+ */
+static ESP01_Status_t _http_client_send(const esp01_http_client_req_t *req, const char *path)
+{
+    _http_client_t *cl = &g_http_client;
+    const char *method = req->method ? req->method : "GET";
+    char head[ESP01_MAX_HEADER_LINE];
+    size_t n = 0;
+    bool fits = _http_fmt_append(head, sizeof(head), &n, (cl->port == 80) ? "%s %s HTTP/1.1\r\nHost: %s\r\n" : "%s %s HTTP/1.1\r\nHost: %s:%u\r\n",
+                                 method, path, cl->host, cl->port);
+    char tail[ESP01_MAX_HEADER_LINE];
+    size_t m = 0;
+    if (fits && req->content_type) // Chaîne de l'appelant : longueur non bornée
+    {
+        fits = _http_fmt_append(tail, sizeof(tail), &m, "Content-Type: %s\r\n", req->content_type);
+    }
+    if (fits && req->body_writer)
+    {
+        fits = _http_fmt_append(tail, sizeof(tail), &m, "Transfer-Encoding: chunked\r\n");
+    }
+    else if (fits && (req->body || strcmp(method, "POST") == 0 || strcmp(method, "PUT") == 0))
+    {
+        fits = _http_fmt_append(tail, sizeof(tail), &m, "Content-Length: %u\r\n", (unsigned)req->body_len);
+    }
+    if (!fits || !_http_fmt_append(tail, sizeof(tail), &m, "\r\n"))
+    {
+        ESP01_RETURN_ERROR("HTTP_CLIENT", ESP01_BUFFER_OVERFLOW);
+    }
+
+    esp01_tx_part_t parts[4] = {{head, n},
+                                {req->headers, req->headers ? strlen(req->headers) : 0},
+                                {tail, m},
+                                {req->body, req->body_writer ? 0 : req->body_len}};
+    ESP01_Status_t st = _http_link_write(cl->link, parts, 4);
+    if (st == ESP01_OK && req->body_writer) // Corps en flux : chunks dans la même file
+    {
+        esp01_http_stream_t out;
+        memset(&out, 0, sizeof(out));
+        out.conn_id = cl->link;
+        out.status = ESP01_OK;
+        st = req->body_writer(&out, req->ctx);
+        if (st == ESP01_OK)
+        {
+            st = _http_stream_flush(&out, NULL, 0, true); // Dernier chunk + chunk final
+        }
+    }
+    if (st == ESP01_OK)
+    {
+        st = esp01_http_flush(cl->link);
+    }
+    return st;
+}
+
+/**
+ * @brief Attend la fin de la réponse du client (les autres liens restent servis).
+ * @param timeout_ms Silence max du serveur.
+ * @retval ESP01_Status_t Code de statut.
+ */
+static ESP01_Status_t _http_client_wait(uint32_t timeout_ms)
+{
+    _http_client_t *cl = &g_http_client;
+    for (;;)
+    {
+        if (cl->state == _HTTP_CLIENT_DONE)
+        {
+            return ESP01_OK;
+        }
+        if (cl->state == _HTTP_CLIENT_ERROR)
+        {
+            ESP01_RETURN_ERROR("HTTP_CLIENT", ESP01_PARSE_ERROR);
+        }
+        if (!g_connections[cl->link].is_active) // Fermé par le serveur
+        {
+            if (cl->state == _HTTP_CLIENT_BODY && cl->until_close) // Fin du corps
+            {
+                return ESP01_OK;
+            }
+            return ESP01_NOT_CONNECTED;
+        }
+        if ((HAL_GetTick() - cl->last_rx) >= timeout_ms)
+        {
+            ESP01_RETURN_ERROR("HTTP_CLIENT", ESP01_TIMEOUT);
+        }
+        _http_schedule_round(); // Trames du lien (et des autres liens)
+        HAL_Delay(1);          // Petite pause CPU
+    }
+}
+
+/**
+ * @brief Envoie une requête HTTP/1.1 et reçoit la réponse.
+ * @param req  Requête.
+ * @param resp Résultat.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_client_request(const esp01_http_client_req_t *req, esp01_http_client_resp_t *resp)
+{
+    VALIDATE_PARAM(req && req->url && resp, ESP01_INVALID_PARAM); // Vérifie les paramètres
+    _http_client_t *cl = &g_http_client;
+    if (cl->busy) // Appel imbriqué (callback, handler)
+    {
+        ESP01_RETURN_ERROR("HTTP_CLIENT", ESP01_FAIL);
+    }
+
+    // --- Découpage de l'URL : http://hote[:port][/chemin] ---
+    if (strncmp(req->url, "http://", 7) != 0)
+    {
+        ESP01_LOG_ERROR("HTTP_CLIENT", "URL non supportée (http:// uniquement) : %s", req->url);
+        return ESP01_INVALID_PARAM;
+    }
+    const char *host = req->url + 7;
+    size_t host_len = strcspn(host, ":/?");
+    const char *path = host + host_len;
+    uint16_t port = 80;
+    if (*path == ':')
+    {
+        uint32_t p = 0;
+        for (path++; *path >= '0' && *path <= '9'; path++)
+        {
+            p = p * 10 + (uint32_t)(*path - '0');
+        }
+        port = (uint16_t)p;
+    }
+    char host_buf[ESP01_HTTP_CLIENT_HOST_LEN];
+    VALIDATE_PARAM(host_len > 0 && host_len < sizeof(host_buf) && port > 0, ESP01_INVALID_PARAM);
+    memcpy(host_buf, host, host_len);
+    host_buf[host_len] = '\0';
+    if (*path == '\0') // Pas de chemin
+    {
+        path = "/";
+    }
+    VALIDATE_PARAM(*path == '/', ESP01_INVALID_PARAM); // "?query" sans chemin
+
+    cl->busy = true;
+    ESP01_Status_t st = ESP01_FAIL;
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        bool reused = _http_client_connected(host_buf, port);
+        if (!reused && (st = _http_client_connect(host_buf, port)) != ESP01_OK)
+        {
+            break;
+        }
+
+        memset(resp, 0, sizeof(*resp));
+        resp->content_length = -1;
+        resp->reused = reused;
+        cl->req = req;
+        cl->resp = resp;
+        cl->state = _HTTP_CLIENT_STATUS;
+        cl->line_len = 0;
+        cl->head = req->method && strcmp(req->method, "HEAD") == 0;
+        cl->until_close = false;
+        cl->keep_alive = false;
+        cl->received = 0;
+        cl->last_rx = HAL_GetTick();
+
+        st = _http_client_send(req, path);
+        if (st == ESP01_OK)
+        {
+            st = _http_client_wait(req->timeout_ms ? req->timeout_ms : ESP01_HTTP_CLIENT_TIMEOUT_MS);
+        }
+        if (st == ESP01_NOT_CONNECTED && reused && cl->received == 0) // Keep-alive fermé par le serveur : nouvelle connexion
+        {
+            ESP01_LOG_DEBUG("HTTP_CLIENT", "Connexion persistante fermée par %s, nouvelle tentative", host_buf);
+            esp01_http_client_close(); // Lien rendu : _http_client_connect repart d'un état vierge
+            continue;
+        }
+        break;
+    }
+    cl->busy = false;
+    cl->req = NULL;
+    cl->resp = NULL;
+
+    if (st == ESP01_OK && cl->keep_alive && g_connections[cl->link].is_active) // Connexion conservée
+    {
+        resp->keep_alive = true;
+    }
+    else
+    {
+        esp01_http_client_close();
+    }
+    ESP01_LOG_DEBUG("HTTP_CLIENT", "%s %s : code=%d, %lu octets (statut=%s)", req->method ? req->method : "GET", req->url,
+                    resp->status_code, (unsigned long)resp->body_len, esp01_get_error_string(st));
+    return st;
+}
+
+/**
+ * @brief Ferme la connexion persistante du client HTTP.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_client_close(void)
+{
+    _http_client_t *cl = &g_http_client;
+    if (cl->link < 0)
+    {
+        return ESP01_OK;
+    }
+    int link = cl->link;
+    cl->link = -1;
+    ESP01_Status_t st = ESP01_OK;
+    if (g_connections[link].is_active && g_connections[link].is_client)
+    {
+        st = esp01_http_close_connection(link);
+    }
+    g_connections[link].is_client = false; // Le lien peut de nouveau être attribué au serveur
+    return st;
+}
+
+// ==================== SOCKETS UDP ====================
+
+/**
+ * @brief Réserve une zone contiguë du pool pour un datagramme.
+ * @param len Taille du datagramme.
+ * @retval Index dans g_udp_rx_pool, ou -1 si la place manque.
+ */
+static int _http_udp_alloc(uint16_t len)
+{
+    if (g_udp_rx_count == 0)
+    {
+        return 0;
+    }
+    const _http_udp_dgram_t *first = &g_udp_rx[g_udp_rx_first];
+    const _http_udp_dgram_t *last = &g_udp_rx[(g_udp_rx_first + g_udp_rx_count - 1) % ESP01_UDP_RX_MAX_QUEUED];
+    uint16_t tail = last->off + last->len; // Fin du datagramme le plus récent
+    if (last->off >= first->off)           // Zone occupée d'un seul tenant : fin du pool, puis début
+    {
+        if (ESP01_UDP_RX_POOL_SIZE - tail >= len)
+        {
+            return tail;
+        }
+        return first->off >= len ? 0 : -1;
+    }
+    return first->off - tail >= len ? tail : -1; // Zone occupée à cheval : place entre les deux
+}
+
+/**
+ * @brief Début d'une trame +IPD sur un lien UDP : réserve la place du datagramme.
+ * @param ipd En-tête de la trame (lien, taille, émetteur).
+ * @note  Appelé par la lecture RX ; faute de place, le datagramme est abandonné (UDP).
+ */
+static void _http_udp_begin(const http_request_t *ipd)
+{
+    g_udp_rx_cur = -1;
+    int off = (g_udp_rx_count < ESP01_UDP_RX_MAX_QUEUED && ipd->content_length > 0 && ipd->content_length <= ESP01_UDP_RX_POOL_SIZE)
+                  ? _http_udp_alloc((uint16_t)ipd->content_length)
+                  : -1;
+    if (off < 0)
+    {
+        g_stats.udp_rx_dropped++;
+        ESP01_LOG_WARN("UDP", "Datagramme de %d octets abandonné sur le lien %d (file pleine)", ipd->content_length, ipd->conn_id);
+        return;
+    }
+    uint8_t idx = (g_udp_rx_first + g_udp_rx_count) % ESP01_UDP_RX_MAX_QUEUED;
+    _http_udp_dgram_t *d = &g_udp_rx[idx];
+    d->off = (uint16_t)off;
+    d->len = (uint16_t)ipd->content_length;
+    d->got = 0;
+    d->link = (int8_t)ipd->conn_id;
+    d->port = ipd->has_ip ? (uint16_t)ipd->client_port : 0;
+    esp01_safe_strcpy(d->ip, sizeof(d->ip), ipd->has_ip ? ipd->client_ip : "");
+    g_udp_rx_count++;
+    g_udp_rx_cur = (int8_t)idx;
+}
+
+/**
+ * @brief Copie le payload d'une trame d'un lien UDP dans son datagramme.
+ * @param data Payload (la trame peut arriver en plusieurs morceaux).
+ * @param len  Taille du morceau.
+ * @retval Octets consommés (toujours len).
+ */
+static size_t _http_udp_feed(const uint8_t *data, size_t len)
+{
+    if (g_udp_rx_cur < 0) // Datagramme abandonné
+    {
+        return len;
+    }
+    _http_udp_dgram_t *d = &g_udp_rx[g_udp_rx_cur];
+    size_t n = len < (size_t)(d->len - d->got) ? len : (size_t)(d->len - d->got);
+    memcpy(g_udp_rx_pool + d->off + d->got, data, n);
+    d->got += (uint16_t)n;
+    if (d->got == d->len) // Datagramme complet : livrable
+    {
+        g_udp_rx_cur = -1;
+        g_stats.udp_rx_datagrams++;
+    }
+    return len;
+}
+
+/**
+ * @brief Livre les datagrammes reçus complets aux callbacks des liens UDP.
+ * @note  Appelé par esp01_process_requests, hors lecture RX : le callback peut émettre.
+ *        Le datagramme reste en tête de file pendant l'appel (sa zone n'est pas réattribuée).
+ */
+static void _http_udp_deliver(void)
+{
+    while (g_udp_rx_count > 0)
+    {
+        const _http_udp_dgram_t *d = &g_udp_rx[g_udp_rx_first];
+        bool complete = d->got == d->len;
+        if (!complete && g_udp_rx_first == g_udp_rx_cur) // Trame en cours de réception
+        {
+            break;
+        }
+        esp01_udp_cb_t cb = g_connections[d->link].udp_cb;
+        if (complete && cb)
+        {
+            cb(d->link, g_udp_rx_pool + d->off, d->len, d->ip, d->port);
+        }
+        else if (!complete) // Trame interrompue
+        {
+            g_stats.udp_rx_dropped++;
+        }
+        g_udp_rx_first = (g_udp_rx_first + 1) % ESP01_UDP_RX_MAX_QUEUED;
+        g_udp_rx_count--;
+    }
+}
+
+/**
+ * @brief Ouvre un lien UDP sur un lien libre.
+ * @param remote_host Destination par défaut.
+ * @param remote_port Port de destination par défaut.
+ * @param local_port  Port local (0 : choisi par l'ESP01).
+ * @param mode        Filtrage de l'émetteur.
+ * @param on_datagram Callback de réception.
+ * @param link        Lien attribué (sortie).
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_udp_open(const char *remote_host, uint16_t remote_port, uint16_t local_port, esp01_udp_mode_t mode,
+                              esp01_udp_cb_t on_datagram, int *link)
+{
+    VALIDATE_PARAM(remote_host && remote_host[0] && link && mode <= ESP01_UDP_PEER_ANY, ESP01_INVALID_PARAM);
+    *link = -1;
+
+    int id = -1;
+    for (int i = ESP01_MAX_CONNECTIONS - 1; i >= 0 && id < 0; --i) // Les clients entrants prennent les premiers liens
+    {
+        if (!g_connections[i].is_active)
+        {
+            id = i;
+        }
+    }
+    if (id < 0)
+    {
+        ESP01_LOG_WARN("UDP", "Aucun lien libre pour %s:%u", remote_host, remote_port);
+        return ESP01_FAIL;
+    }
+
+    connection_info_t *conn = &g_connections[id];
+    memset(conn, 0, sizeof(*conn));
+    conn->conn_id = id;
+    conn->is_udp = true; // "n,CONNECT" : lien UDP, pas un client du serveur
+    conn->udp_cb = on_datagram;
+
+    esp01_send_wait_idle(ESP01_TIMEOUT_LONG); // Aucune commande acceptée avant le "SEND OK" en attente
+    char cmd[ESP01_MAX_CMD_BUF];
+    int cmd_len = local_port ? snprintf(cmd, sizeof(cmd), "AT+CIPSTART=%d,\"UDP\",\"%s\",%u,%u,%d\r\n", id, remote_host, remote_port, local_port, (int)mode)
+                             : snprintf(cmd, sizeof(cmd), "AT+CIPSTART=%d,\"UDP\",\"%s\",%u\r\n", id, remote_host, remote_port);
+    g_http_rx_events = 0;
+    esp01_uart_write(cmd, cmd_len); // Envoie la commande (sans vidage RX)
+    ESP01_Status_t st = _http_wait_event(ESP01_HTTP_EVT_OK | ESP01_HTTP_EVT_ERROR, ESP01_TIMEOUT_LONG); // Résolution DNS éventuelle
+    if (st != ESP01_OK || !(g_http_rx_events & ESP01_HTTP_EVT_OK) || !conn->is_active)
+    {
+        ESP01_LOG_WARN("UDP", "Ouverture de %s:%u (local %u) échouée (code=%d)", remote_host, remote_port, local_port, st);
+        memset(conn, 0, sizeof(*conn));
+        return ESP01_CONNECTION_ERROR;
+    }
+    *link = id;
+    ESP01_LOG_DEBUG("UDP", "Lien %d ouvert vers %s:%u (local %u, mode %d)", id, remote_host, remote_port, local_port, (int)mode);
+    return ESP01_OK;
+}
+
+/**
+ * @brief Émet un datagramme vers la destination du lien.
+ * @param link Lien UDP.
+ * @param data Contenu.
+ * @param len  Taille.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_udp_send(int link, const void *data, size_t len)
+{
+    return esp01_udp_send_to(link, NULL, 0, data, len);
+}
+
+/**
+ * @brief Émet un datagramme vers une destination donnée.
+ * @param link        Lien UDP.
+ * @param remote_ip   Destination (NULL : celle du lien).
+ * @param remote_port Port de destination.
+ * @param data        Contenu.
+ * @param len         Taille.
+ * @retval ESP01_Status_t Code de statut.
+ * @note   Un seul AT+CIPSEND, sans passer par la file d'émission du lien : le
+ *         datagramme n'est jamais découpé. "SEND OK" est traité par la lecture RX.
+ */
+ESP01_Status_t esp01_udp_send_to(int link, const char *remote_ip, uint16_t remote_port, const void *data, size_t len)
+{
+    VALIDATE_PARAM(link >= 0 && link < ESP01_MAX_CONNECTIONS && data && len > 0 && len <= ESP01_MAX_SEND_LEN, ESP01_INVALID_PARAM);
+    if (!esp01_udp_is_open(link))
+    {
+        return ESP01_NOT_CONNECTED;
+    }
+    esp01_tx_part_t part = {data, len};
+    ESP01_Status_t st = esp01_send_submit_to(link, remote_ip, remote_port, &part, 1, _http_scan_rx); // Rend la main dès la transmission
+    if (st == ESP01_OK)
+    {
+        g_stats.udp_tx_datagrams++;
+    }
+    return st;
+}
+
+/**
+ * @brief Ferme un lien UDP.
+ * @param link Lien UDP.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_udp_close(int link)
+{
+    VALIDATE_PARAM(link >= 0 && link < ESP01_MAX_CONNECTIONS, ESP01_INVALID_PARAM);
+    connection_info_t *conn = &g_connections[link];
+    if (!conn->is_udp)
+    {
+        return ESP01_OK;
+    }
+    ESP01_Status_t st = conn->is_active ? esp01_http_close_connection(link) : ESP01_OK; // AT+CIPCLOSE
+    memset(conn, 0, sizeof(*conn)); // Datagrammes en file abandonnés (plus de callback)
+    return st;
+}
+
+/**
+ * @brief Indique si un lien UDP est ouvert.
+ * @param link Lien.
+ * @retval true si le lien est un lien UDP ouvert.
+ */
+bool esp01_udp_is_open(int link)
+{
+    return link >= 0 && link < ESP01_MAX_CONNECTIONS && g_connections[link].is_active && g_connections[link].is_udp;
+}
+
+// ==================== GESTION DES CONNEXIONS ====================
+
+/**
+ * @brief Retourne le nombre de connexions TCP actives.
+ * @retval Nombre de connexions actives.
+ */
+int esp01_get_active_connection_count(void)
+{
+    int count = 0;                                                       // Initialise le compteur
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i)                      // Parcours toutes les connexions
+    {
+        if (g_connections[i].is_active)                                  // Si la connexion est active
+        {
+            count++;                                                     // Incrémente le compteur
+        }
+    }
+    ESP01_LOG_DEBUG("HTTP", "Nombre de connexions actives : %d", count); // Log le résultat
+    return count;                                                        // Retourne le nombre de connexions actives
+}
+
+/**
+ * @brief Vérifie si une connexion TCP est active.
+ * @param conn_id  Identifiant de connexion.
+ * @retval true si active, false sinon.
+ */
+bool esp01_is_connection_active(int conn_id)
+{
+    bool active = (conn_id >= 0 && conn_id < ESP01_MAX_CONNECTIONS && g_connections[conn_id].is_active); // Vérifie les bornes et l'état
+    ESP01_LOG_DEBUG("HTTP", "Connexion %d active ? %s", conn_id, active ? "OUI" : "NON");                // Log le résultat
+    return active;                                                                                       // Retourne l'état
+}
+
+/**
+ * @brief Configure la durée de vie des liens.
+ * @param idle_timeout_ms      Silence max d'un lien (0 : pas de limite).
+ * @param keepalive_timeout_ms Attente max de la requête suivante (0 : pas de limite).
+ * @param reserve              Liens gardés libres (0 : pas d'éviction).
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_set_link_policy(uint32_t idle_timeout_ms, uint32_t keepalive_timeout_ms, uint8_t reserve)
+{
+    VALIDATE_PARAM(reserve < ESP01_MAX_CONNECTIONS, ESP01_INVALID_PARAM); // Au moins un lien utilisable
+    g_http_idle_timeout_ms = idle_timeout_ms;
+    g_http_keepalive_timeout_ms = keepalive_timeout_ms;
+    g_http_link_reserve = reserve;
+    ESP01_LOG_DEBUG("HTTP", "Liens : inactivité %lu ms, keep-alive %lu ms, %u lien(s) réservé(s)", (unsigned long)idle_timeout_ms,
+                    (unsigned long)keepalive_timeout_ms, reserve);
+    return ESP01_OK;
+}
+
+/**
+ * @brief Indique si un lien HTTP est au repos (aucune requête, réponse ou trame en cours).
+ * @param conn_id Identifiant de connexion.
+ * @retval true si le lien peut être fermé sans rien interrompre.
+ */
+static bool _http_link_quiet(int conn_id)
+{
+    const connection_info_t *conn = &g_connections[conn_id];
+    return conn->is_active && !conn->is_client && !conn->is_udp && !conn->ws_cb && !conn->sse_cb && !conn->in_handler &&
+           conn->parser.state == HTTP_PARSER_REQUEST_LINE && conn->parser.buf_len == 0 && conn->tx_len == 0 && conn->rx_pending == 0 &&
+           esp01_send_outstanding(conn_id) == 0 && !_http_link_held(conn_id);
+}
+
+/**
+ * @brief Ferme un lien côté serveur et libère sa place.
+ * @param conn_id Identifiant de connexion.
+ */
+static void _http_link_drop(int conn_id)
+{
+    esp01_http_close_connection(conn_id);                   // AT+CIPCLOSE
+    _http_push_notify_close(conn_id);                       // Fermeture WebSocket/SSE éventuelle
+    memset(&g_connections[conn_id], 0, sizeof(connection_info_t)); // Réinitialise la structure
+}
+
+/**
+ * @brief Ferme le lien au repos le moins récemment utilisé quand les places libres manquent.
+ * @param now Timestamp courant.
+ */
+static void _http_link_evict_lru(uint32_t now)
+{
+    if (!g_http_link_reserve)
+    {
+        return;
+    }
+    int active = 0;
+    int victim = -1;
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i)
+    {
+        if (!g_connections[i].is_active)
+        {
+            continue;
+        }
+        active++;
+        if (_http_link_quiet(i) && now - g_connections[i].last_activity >= ESP01_HTTP_EVICT_MIN_IDLE_MS &&
+            (victim < 0 || (int32_t)(g_connections[i].last_activity - g_connections[victim].last_activity) < 0))
+        {
+            victim = i;
+        }
+    }
+    if (active < ESP01_MAX_CONNECTIONS - g_http_link_reserve || victim < 0) // Assez de places, ou aucun lien au repos
+    {
+        return;
+    }
+    ESP01_LOG_DEBUG("HTTP", "%d liens ouverts : éviction de la connexion %d (inactive depuis %lu ms)", active, victim,
+                    (unsigned long)(now - g_connections[victim].last_activity));
+    g_stats.link_evictions++;
+    _http_link_drop(victim);
+}
+
+/**
+ * @brief Nettoie les connexions inactives (timeouts, keep-alive, éviction LRU).
+ */
+void esp01_cleanup_inactive_connections(void)
+{
+    uint32_t now = HAL_GetTick();                   // Récupère le temps courant
+    _http_ota_watch();                              // Image OTA d'un lien fermé : rollback
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i) // Parcours toutes les connexions
+    {
+        if (g_connections[i].is_active && !g_connections[i].is_udp && g_http_idle_timeout_ms &&
+            (now - g_connections[i].last_activity > g_http_idle_timeout_ms)) // Si la connexion est inactive depuis trop longtemps (UDP : jamais)
+        {
+            ESP01_LOG_DEBUG("HTTP", "Connexion %d inactive depuis %lu ms, fermeture...", i, (unsigned long)(now - g_connections[i].last_activity)); // Log la fermeture
+            g_stats.link_timeouts++;                                                                                                                // Métriques des liens
+            _http_link_drop(i);                                                                                                                     // Ferme la connexion
+        }
+        else if (g_http_keepalive_timeout_ms && g_connections[i].requests > 0 && _http_link_quiet(i) &&
+                 now - g_connections[i].last_activity > g_http_keepalive_timeout_ms) // Pas de requête suivante après une réponse
+        {
+            ESP01_LOG_DEBUG("HTTP", "Connexion %d : keep-alive expiré, fermeture", i);
+            g_stats.link_keepalive_closes++;
+            _http_link_drop(i);
+        }
+        else if (!g_connections[i].is_active) // Si la connexion n'est pas active
+        {
+            _http_push_notify_close(i);                              // Fermeture WebSocket/SSE pas encore signalée
+            memset(&g_connections[i], 0, sizeof(connection_info_t)); // Réinitialise la structure
+        }
+        else if (g_connections[i].ws_cb && now - g_connections[i].last_activity > ESP01_WS_PING_INTERVAL_MS &&
+                 g_connections[i].ws.ping_at != g_connections[i].last_activity) // WebSocket silencieux : le pong du client prolonge le lien
+        {
+            g_connections[i].ws.ping_at = g_connections[i].last_activity; // Un seul ping par période de silence
+            esp01_ws_send(i, ESP01_WS_OP_PING, NULL, 0);
+        }
+        else if (g_connections[i].sse_cb && now - g_connections[i].last_activity > ESP01_SSE_HEARTBEAT_MS) // Flux SSE sans évènement
+        {
+            _http_sse_queue(i, ":\n\n", 3); // Commentaire ignoré par le navigateur ; file pleine : le lien finira par expirer
+        }
+        else if (g_connections[i].parser.buf_len > 0 &&
+                 (now - g_connections[i].last_activity > ESP01_HTTP_REQUEST_TIMEOUT)) // Requête incomplète depuis trop longtemps
+        {
+            ESP01_LOG_DEBUG("HTTP", "Requête incomplète abandonnée sur connexion %d", i); // Log l'abandon
+            esp01_http_parser_reset(&g_connections[i].parser);                        // Réarme le parseur du lien
+        }
+    }
+    _http_link_evict_lru(now); // Places libres pour les prochains clients
+}
+
+/**
+ * @brief Ferme une connexion TCP HTTP.
+ * @param conn_id  Identifiant de connexion.
+ * @retval ESP01_Status_t Code de statut.
+ */
+ESP01_Status_t esp01_http_close_connection(int conn_id)
+{
+    ESP01_LOG_DEBUG("HTTP", "Fermeture de la connexion %d", conn_id);                                   // Log la fermeture
+    VALIDATE_PARAM(conn_id >= 0 && conn_id < ESP01_MAX_CONNECTIONS, ESP01_INVALID_PARAM);               // Vérifie l'identifiant
+    if (g_connections[conn_id].is_active)                                                               // Termine d'abord la réponse en file
+    {
+        esp01_http_flush(conn_id);
+    }
+
+    esp01_send_wait_idle(ESP01_TIMEOUT_LONG); // Aucune commande acceptée avant le "SEND OK" en attente
+
+    char cmd[ESP01_MAX_CIPSEND_BUF];                                           // Buffer pour la commande AT
+    int cmd_len = snprintf(cmd, sizeof(cmd), "AT+CIPCLOSE=%d\r\n", conn_id); // Prépare la commande AT+CIPCLOSE
+    g_http_rx_events = 0;                                                      // Oublie les évènements précédents
+    esp01_uart_write(cmd, cmd_len);                                            // Envoie la commande (sans vidage RX)
+    ESP01_Status_t st = _http_wait_event(ESP01_HTTP_EVT_OK | ESP01_HTTP_EVT_ERROR, ESP01_TIMEOUT_SHORT);
+    if (st == ESP01_OK && !(g_http_rx_events & ESP01_HTTP_EVT_OK)) // ERROR
+    {
+        st = ESP01_FAIL;
+    }
+    if (st != ESP01_OK)
+    {
+        ESP01_LOG_WARN("HTTP_CLOSE", "Fermeture connexion %d : échec ou timeout (code=%d)", conn_id, st);
+        return st;
+    }
+    connection_info_t *conn = &g_connections[conn_id];
+    conn->is_active = 0;                    // Marque la connexion comme inactive
+    conn->tx_head = 0;                      // Abandonne la file d'émission
+    conn->tx_len = 0;
+    _http_push_detach(conn);                // Fermeture WebSocket/SSE signalée par l'ordonnanceur
+    if (!conn->in_handler)                  // La requête en cours de traitement reste valide jusqu'au retour du handler
+    {
+        esp01_http_parser_reset(&conn->parser); // Abandonne la requête éventuellement en cours
+    }
+    ESP01_LOG_DEBUG("HTTP", "Connexion %d fermée", conn_id); // Log la réussite
+    return ESP01_OK;                                         // Retourne OK
+}
+
+/**
+ * @brief Retourne l'adresse IP du client pour une connexion.
+ * @param conn_id  Identifiant de connexion.
+ * @retval Pointeur vers la chaîne IP, ou "N/A".
+ */
+const char *esp01_http_get_client_ip(int conn_id)
+{
+    if (conn_id < 0 || conn_id >= ESP01_MAX_CONNECTIONS)                                                    // Vérifie les bornes
+    {
+        return "N/A";                                                                                       // Retourne "N/A" si hors bornes
+    }
+    if (!g_connections[conn_id].is_active || !g_connections[conn_id].client_ip[0])                          // Vérifie l'état et la présence d'une IP
+    {
+        return "N/A";                                                                                       // Retourne "N/A" si pas d'IP
+    }
+    ESP01_LOG_DEBUG("HTTP", "IP client pour connexion %d : %s", conn_id, g_connections[conn_id].client_ip); // Log l'IP
+    return g_connections[conn_id].client_ip;                                                                // Retourne l'IP
+}
+
+/**
+ * @brief Affiche l'état des connexions actives (log debug).
+ */
+void esp01_print_connection_status(void)
+{
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i) // Parcours toutes les connexions
+    {
+        if (g_connections[i].is_active)                                                             // Si la connexion est active
+        {
+            ESP01_LOG_DEBUG("HTTP", "Connexion %d active, IP : %s", i, g_connections[i].client_ip); // Log l'état de la connexion
+        }
+    }
+}
+
+// ==================== TRAITEMENT AUTOMATIQUE DES REQUÊTES ====================
+
+/**
+ * @brief Route une requête complète vers son handler (ou 204/404).
+ * @param conn_id Identifiant de connexion.
+ * @param req     Requête parsée.
+ * @retval Route servie, ou NULL (favicon, route inconnue).
+ */
+static esp01_route_t *_http_dispatch_request(int conn_id, const http_parsed_request_t *req)
+{
+    if (strcmp(req->path, "/favicon.ico") == 0) // Le navigateur demande l'icône
+    {
+        ESP01_LOG_DEBUG("HTTP", "favicon.ico demandé, réponse 204 No Content");
+        esp01_send_http_response(conn_id, ESP01_HTTP_NO_CONTENT_CODE, "image/x-icon", NULL, 0);
+        return NULL;
+    }
+    esp01_route_t *route = _http_find_route(req->path); // Recherche la route
+    if (!route)
+    {
+        esp01_send_404_response(conn_id); // Route inconnue
+        return NULL;
+    }
+    if (route->on_ws && _http_ws_upgrade(conn_id, req, route)) // Poignée de main WebSocket
+    {
+        return route;
+    }
+    if (route->on_sse && _http_sse_open(conn_id, req, route)) // Flux SSE
+    {
+        return route;
+    }
+
+    char key[ESP01_HTTP_CACHE_KEY_LEN]; // Chemin + query string
+    bool cacheable = route->cache_ttl_ms > 0 && strcmp(req->method, "GET") == 0 && _http_cache_key(req, key);
+    if (cacheable)
+    {
+        const _http_cache_entry_t *hit = _http_cache_lookup(key);
+        if (hit) // Réponse encore fraîche : le handler n'est pas appelé
+        {
+            uint32_t start = HAL_GetTick();
+            ESP01_LOG_DEBUG("HTTP", "Cache : %s servi depuis le cache", key);
+            g_connections[conn_id].resp_status = ESP01_HTTP_OK_CODE; // Seules les réponses 200 sont en cache
+            _http_cache_send(conn_id, hit);
+            g_stats.cache_hits++;
+            _http_record_stats(ESP01_HTTP_OK_CODE, start);
+            return route;
+        }
+        g_stats.cache_misses++;
+    }
+
+    ESP01_LOG_DEBUG("HTTP", "Appel du handler pour la route : %s", req->path);
+    bool capturing = cacheable && _http_cache_begin(conn_id, key); // Copie la réponse au fil de son écriture
+    route->handler(conn_id, req);                                  // Appelle le handler utilisateur
+    if (capturing)
+    {
+        _http_cache_end(route->cache_ttl_ms);
+    }
+    return route;
+}
+
+/**
+ * @brief Indique si un lien a une requête complète (ou invalide) pas encore traitée.
+ * @param conn Connexion.
+ * @retval true si les octets suivants du lien doivent attendre.
+ */
+static bool _http_link_busy(const connection_info_t *conn)
+{
+    if (conn->ws_cb) // WebSocket : trame prête
+    {
+        return conn->ws.ready != 0;
+    }
+    if (conn->is_client || conn->is_udp) // Lien sortant ou UDP : données consommées au fil de l'eau
+    {
+        return false;
+    }
+    return conn->parser.state == HTTP_PARSER_COMPLETE || conn->parser.state == HTTP_PARSER_ERROR;
+}
+
+/**
+ * @brief Alimente le parseur d'un lien avec le payload d'une trame +IPD.
+ * @param conn_id Identifiant de connexion.
+ * @param data    Payload de la trame.
+ * @param len     Taille du payload.
+ * @retval Nombre d'octets consommés : le parseur s'arrête sur une requête complète,
+ *         qui sera routée par l'ordonnanceur ; le reste attend son tour.
+ * @note  Une requête peut s'étendre sur plusieurs trames ; plusieurs requêtes
+ *        peuvent aussi se suivre dans une même trame.
+ */
+static size_t _http_feed_link(int conn_id, const uint8_t *data, size_t len)
+{
+    if (g_connections[conn_id].ws_cb) // Lien WebSocket : trames
+    {
+        return _http_ws_feed(conn_id, data, len);
+    }
+    if (g_connections[conn_id].sse_cb) // Flux SSE : le client n'envoie plus rien d'utile
+    {
+        return len;
+    }
+    if (g_connections[conn_id].is_client) // Lien sortant : réponse du client HTTP
+    {
+        return _http_client_feed(data, len);
+    }
+    if (g_connections[conn_id].is_udp) // Lien UDP : datagramme de la trame en cours
+    {
+        return _http_udp_feed(data, len);
+    }
+    esp01_http_parser_t *parser = &g_connections[conn_id].parser; // Parseur du lien
+    if (parser->conn_id != conn_id)                              // Parseur jamais initialisé pour ce lien
+    {
+        esp01_http_parser_init(parser, conn_id, NULL);
+    }
+
+    size_t consumed = 0; // Octets consommés
+    while (consumed < len)
+    {
+        size_t used = esp01_http_parser_feed(parser, data + consumed, len - consumed); // Avance le parseur
+        consumed += used;
+
+        if (parser->state == HTTP_PARSER_BODY && parser->body_received == 0) // Fin des en-têtes
+        {
+            parser->on_body = _http_find_body_cb(parser->request.path);       // Corps par morceaux ou conservé
+        }
+        else if (parser->state == HTTP_PARSER_COMPLETE)                      // Requête complète : attend l'ordonnanceur
+        {
+            return consumed;
+        }
+        else if (parser->state == HTTP_PARSER_ERROR) // Requête invalide : le reste de la trame est ignoré
+        {
+            return len;
+        }
+        else if (used == 0) // Rien consommé sans changement d'état (sécurité)
+        {
+            return len;
+        }
+    }
+    return consumed;
+}
+
+/**
+ * @brief Index dans g_accumulator d'une position relative au premier octet occupé.
+ */
+#define ESP01_HTTP_ACC_IDX(off) ((uint16_t)((g_acc_head + (off)) % ESP01_MAX_TOTAL_HTTP))
+
+/**
+ * @brief Ajoute des octets reçus en fin d'accumulateur circulaire.
+ * @param data Octets reçus.
+ * @param len  Nombre d'octets.
+ * @retval Nombre d'octets ajoutés (limité par la place libre).
+ */
+static size_t _http_acc_append(const uint8_t *data, size_t len)
+{
+    size_t space = ESP01_MAX_TOTAL_HTTP - (size_t)g_acc_len; // Place libre
+    size_t n = len < space ? len : space;                    // Octets ajoutés
+    size_t tail = ESP01_HTTP_ACC_IDX(g_acc_len);             // Fin des données
+    size_t first = ESP01_MAX_TOTAL_HTTP - tail;              // Place avant le rebouclage
+    if (first > n)
+    {
+        first = n;
+    }
+    memcpy(g_accumulator + tail, data, first);      // Jusqu'à la fin du tampon
+    memcpy(g_accumulator, data + first, n - first); // Suite en début de tampon
+    g_acc_len += (int)n;
+    if (n < len) // Rien n'est écrasé : les octets en trop sont perdus
+    {
+        ESP01_LOG_ERROR("HTTP", "Accumulateur HTTP plein : %d octets perdus", (int)(len - n));
+    }
+    return n;
+}
+
+/**
+ * @brief Copie linéaire (terminée par '\0') du début d'une zone de l'accumulateur.
+ * @param off Position relative au premier octet occupé.
+ * @param dst Destination.
+ * @param max Taille de la destination.
+ * @retval Nombre d'octets copiés.
+ */
+static int _http_acc_copy(int off, char *dst, int max)
+{
+    int n = g_acc_len - off; // Octets disponibles
+    if (n > max - 1)
+    {
+        n = max - 1;
+    }
+    for (int k = 0; k < n; ++k)
+    {
+        dst[k] = g_accumulator[ESP01_HTTP_ACC_IDX(off + k)];
+    }
+    dst[n] = '\0';
+    return n;
+}
+
+/**
+ * @brief Transmet au parseur d'un lien des octets de l'accumulateur (sans recopie).
+ * @param conn_id Lien.
+ * @param idx     Index du premier octet dans g_accumulator.
+ * @param len     Nombre d'octets.
+ * @retval Nombre d'octets consommés par le parseur.
+ */
+static size_t _http_acc_feed(int conn_id, uint16_t idx, size_t len)
+{
+    size_t first = ESP01_MAX_TOTAL_HTTP - idx; // Octets avant le rebouclage
+    if (first > len)
+    {
+        first = len;
+    }
+    size_t used = _http_feed_link(conn_id, (const uint8_t *)g_accumulator + idx, first);
+    if (used == first && len > first) // Suite en début de tampon
+    {
+        used += _http_feed_link(conn_id, (const uint8_t *)g_accumulator, len - first);
+    }
+    return used;
+}
+
+/**
+ * @brief Met à jour la connexion associée à un en-tête +IPD.
+ * @param ipd En-tête +IPD parsé (conn_id dans les bornes).
+ */
+static void _http_touch_connection(const http_request_t *ipd)
+{
+    connection_info_t *conn = &g_connections[ipd->conn_id];                          // Récupère la structure de connexion
+    conn->conn_id = ipd->conn_id;                                                    // Met à jour l'identifiant
+    conn->is_active = true;                                                          // Marque la connexion comme active
+    conn->last_activity = HAL_GetTick();                                             // Met à jour le timestamp d'activité
+    if (ipd->has_ip)                                                                 // Si l'IP est présente
+    {
+        esp01_safe_strcpy(conn->client_ip, sizeof(conn->client_ip), ipd->client_ip); // Copie l'IP
+    }
+    else
+    {
+        conn->client_ip[0] = 0;           // Vide la chaîne IP
+    }
+    conn->client_port = ipd->client_port; // Met à jour le port client
+}
+
+/**
+ * @brief Applique la réponse "+CIPRECVLEN:" : octets en attente par lien (mode passif).
+ * @param values Valeurs après le préfixe, séparées par des virgules (-1 : lien fermé).
+ * @param len    Longueur des valeurs.
+ */
+static void _http_on_recvlen(const char *values, int len)
+{
+    int k = 0;                                                  // Position dans la liste
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS && k < len; ++i) // Une valeur par lien
+    {
+        bool negative = (values[k] == '-'); // -1 : lien fermé
+        if (negative)
+        {
+            k++;
+        }
+        uint32_t pending = 0; // Octets en attente
+        while (k < len && values[k] >= '0' && values[k] <= '9')
+        {
+            pending = pending * 10 + (uint32_t)(values[k++] - '0');
+        }
+        if (!negative && pending > 0) // Données à lire
+        {
+            if (!g_connections[i].is_active) // Lien inconnu : notification perdue
+            {
+                g_connections[i].conn_id = i;
+                g_connections[i].is_active = true;
+                g_connections[i].last_activity = HAL_GetTick();
+            }
+            g_connections[i].rx_pending = pending; // Valeur de référence
+        }
+        else
+        {
+            g_connections[i].rx_pending = 0; // Rien à lire
+        }
+        if (k >= len || values[k] != ',') // Fin de la liste
+        {
+            break;
+        }
+        k++; // Valeur suivante
+    }
+}
+
+/**
+ * @brief Resynchronise les octets en attente par lien (AT+CIPRECVLEN?, mode passif).
+ * @note  Rattrape les notifications +IPD perdues (vidage RX avant une commande AT).
+ *        La commande est envoyée sans vidage RX : la réponse et les notifications
+ *        des autres liens (+IPD, CONNECT, CLOSED) passent par l'analyseur.
+ */
+static void _http_sync_recvlen(void)
+{
+    static const char cmd[] = "AT+CIPRECVLEN?\r\n";
+    esp01_send_wait_idle(ESP01_TIMEOUT_LONG); // Pas de commande avant le "SEND OK" en attente
+    g_http_rx_events = 0;                     // Oublie les évènements précédents
+    esp01_uart_write(cmd, strlen(cmd));       // Envoie la commande (sans vidage RX)
+    if (_http_wait_event(ESP01_HTTP_EVT_OK | ESP01_HTTP_EVT_ERROR, ESP01_TIMEOUT_SHORT) != ESP01_OK)
+    {
+        ESP01_LOG_WARN("HTTP", "AT+CIPRECVLEN? sans réponse");
+    }
+}
+
+/**
+ * @brief Longueur de l'en-tête d'une réponse AT+CIPRECVDATA.
+ * @param hdr     Octets reçus depuis "+CIPRECVDATA".
+ * @param len     Nombre d'octets.
+ * @param actual  Nombre d'octets de données annoncés (sortie).
+ * @retval Longueur de l'en-tête (les octets suivants sont des données), 0 si incomplet, -1 si invalide.
+ * @note   Formats : "+CIPRECVDATA:<len>,[\"ip\",port,]<data>" (AT 2.x) ou "+CIPRECVDATA,<len>:<data>" (AT 1.x).
+ */
+static int _http_recvdata_header_len(const char *hdr, int len, int *actual)
+{
+    int i = (int)strlen("+CIPRECVDATA") + 1; // Passe le préfixe et le séparateur
+    int n = 0;                               // Longueur annoncée
+    if (len <= i)
+    {
+        return 0;
+    }
+    while (i < len && hdr[i] >= '0' && hdr[i] <= '9') // Décode la longueur
+    {
+        n = n * 10 + (hdr[i++] - '0');
+    }
+    if (i >= len)
+    {
+        return 0;
+    }
+    *actual = n;
+    if (hdr[i] == ':') // Format AT 1.x
+    {
+        return i + 1;
+    }
+    if (hdr[i] != ',') // Séparateur attendu
+    {
+        return -1;
+    }
+    if (++i >= len) // Premier octet suivant nécessaire
+    {
+        return 0;
+    }
+    if (hdr[i] != '"') // Données immédiatement après la virgule
+    {
+        return i;
+    }
+    int data_start = i; // Format avec IP/port ("ip",port,) ou données commençant par '"'
+    int j = i + 1;      // Vérifie strictement le motif de l'adresse
+    while (j < len && ((hdr[j] >= '0' && hdr[j] <= '9') || (hdr[j] >= 'a' && hdr[j] <= 'f') || (hdr[j] >= 'A' && hdr[j] <= 'F') || hdr[j] == '.' || hdr[j] == ':'))
+    {
+        j++;
+    }
+    if (j >= len)
+    {
+        return 0;
+    }
+    if (hdr[j] != '"' || j == i + 1) // Pas une adresse : données
+    {
+        return data_start;
+    }
+    if (++j >= len)
+    {
+        return 0;
+    }
+    if (hdr[j] != ',')
+    {
+        return data_start;
+    }
+    int k = ++j; // Port
+    while (j < len && hdr[j] >= '0' && hdr[j] <= '9')
+    {
+        j++;
+    }
+    if (j >= len)
+    {
+        return 0;
+    }
+    return (hdr[j] == ',' && j > k) ? j + 1 : data_start; // Données après ",port,"
+}
+
+/**
+ * @brief Lit un morceau des données en attente d'un lien (AT+CIPRECVDATA, mode passif).
+ * @param conn_id Identifiant de connexion.
+ * @note  Les octets reçus avant la réponse (notifications, CONNECT...) sont replacés
+ *        dans l'accumulateur. Les données ne sont transmises au parseur qu'après le
+ *        "OK" final : un handler peut alors répondre sans perturber la lecture.
+ */
+static void _http_recv_passive(int conn_id)
+{
+    connection_info_t *conn = &g_connections[conn_id];                                           // Connexion concernée
+    uint32_t want = conn->rx_pending < ESP01_HTTP_RECV_CHUNK ? conn->rx_pending : ESP01_HTTP_RECV_CHUNK; // Taille du morceau demandé
+    char cmd[ESP01_MAX_CIPSEND_BUF];                                                             // Buffer pour la commande AT
+    snprintf(cmd, sizeof(cmd), "AT+CIPRECVDATA=%d,%lu\r\n", conn_id, (unsigned long)want);       // Prépare la commande AT
+    esp01_send_wait_idle(ESP01_TIMEOUT_LONG);                                                    // Pas de commande avant le "SEND OK" en attente
+    esp01_uart_write(cmd, strlen(cmd));                                                          // Envoie la commande (sans vidage RX)
+
+    char line[ESP01_SMALL_BUF_SIZE]; // Ligne / en-tête en cours
+    int line_len = 0;                // Octets dans line
+    int actual = -1;                 // Octets de données annoncés (-1 : en-tête non reçu)
+    int got = 0;                     // Octets de données reçus
+    bool done = false;               // "OK" reçu
+    uint32_t start = HAL_GetTick();  // Timestamp de départ
+
+    while (!done && (HAL_GetTick() - start) < ESP01_TIMEOUT_SHORT) // Boucle jusqu'au "OK" ou timeout
+    {
+        uint8_t buf[ESP01_SMALL_BUF_SIZE];              // Buffer temporaire pour lecture
+        int len = esp01_get_new_data(buf, sizeof(buf)); // Récupère les nouveaux octets reçus
+        if (len <= 0)
+        {
+            HAL_Delay(1); // Petite pause CPU
+            continue;
+        }
+        for (int i = 0; i < len; ++i) // Traite octet par octet
+        {
+            if (done) // Octets suivant le "OK" : pour l'accumulateur
+            {
+                _http_acc_append(buf + i, (uint16_t)(len - i));
+                break;
+            }
+            if (actual >= 0 && got < actual) // Données utiles
+            {
+                g_http_recv_buf[got++] = buf[i];
+                continue;
+            }
+            if (line_len < (int)sizeof(line) - 1) // Ligne courante (en-tête, notification, OK...)
+            {
+                line[line_len++] = (char)buf[i];
+            }
+            line[line_len] = '\0';
+
+            if (actual < 0 && strncmp(line, "+CIPRECVDATA", line_len < 12 ? line_len : 12) == 0) // En-tête en cours
+            {
+                int hdr_len = _http_recvdata_header_len(line, line_len, &actual);
+                if (hdr_len < 0 || actual > (int)want) // En-tête invalide
+                {
+                    ESP01_LOG_WARN("HTTP", "Réponse AT+CIPRECVDATA invalide (conn %d)", conn_id);
+                    conn->rx_pending = 0;
+                    return;
+                }
+                if (hdr_len == 0) // En-tête incomplet
+                {
+                    actual = -1;
+                    continue;
+                }
+                for (int k = hdr_len; k < line_len && got < actual; ++k) // Données déjà lues avec l'en-tête
+                {
+                    g_http_recv_buf[got++] = (uint8_t)line[k];
+                }
+                line_len = 0;
+                continue;
+            }
+            if (buf[i] != '\n') // Ligne non terminée
+            {
+                continue;
+            }
+            if (strncmp(line, "OK", 2) == 0 && actual >= 0) // Fin de la réponse
+            {
+                done = true;
+            }
+            else if (strstr(line, "ERROR")) // Lien fermé ou rien à lire
+            {
+                conn->rx_pending = 0;
+                return;
+            }
+            else if (actual < 0 && line_len > 2 && strncmp(line, "AT+", 3) != 0) // Autre ligne (notification) : pour l'accumulateur
+            {
+                _http_acc_append((const uint8_t *)line, (uint16_t)line_len);
+            }
+            line_len = 0;
+        }
+    }
+
+    if (!done) // Timeout
+    {
+        ESP01_LOG_WARN("HTTP", "Timeout AT+CIPRECVDATA (conn %d)", conn_id);
+        conn->rx_pending = 0; // Resynchronisation par AT+CIPRECVLEN?
+        return;
+    }
+    conn->rx_pending = (got > 0 && (uint32_t)got < conn->rx_pending) ? conn->rx_pending - got : 0; // Octets restants
+    conn->last_activity = HAL_GetTick();                                                       // Met à jour le timestamp d'activité
+    ESP01_LOG_DEBUG("HTTP", "CIPRECVDATA : %d octets lus sur connexion %d (reste %lu)", got, conn_id, (unsigned long)conn->rx_pending);
+    if (got > 0)
+    {
+        size_t used = _http_feed_link(conn_id, g_http_recv_buf, (size_t)got); // Alimente le parseur du lien
+        if (used < (size_t)got)                                               // Requête suivante déjà lue : attend son tour
+        {
+            char hdr[ESP01_SMALL_BUF_SIZE];
+            int n = snprintf(hdr, sizeof(hdr), "+IPD,%d,%d:", conn_id, got - (int)used); // Trame +IPD équivalente
+            _http_acc_append((const uint8_t *)hdr, (uint16_t)n);
+            _http_acc_append(g_http_recv_buf + used, (uint16_t)(got - used));
+        }
+    }
+}
+
+/**
+ * @brief Lit les données en attente dans l'ESP (mode passif), un morceau par lien.
+ * @note  Un seul morceau par lien et par appel : le débit suit le rythme de
+ *        traitement de l'application (contrôle de flux).
+ */
+static void _http_poll_passive(void)
+{
+    bool pending = false;                           // Données en attente sur au moins un lien
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i) // Parcours toutes les connexions
+    {
+        if (g_connections[i].rx_pending)
+        {
+            pending = true;
+        }
+    }
+
+    if (!pending && (HAL_GetTick() - g_http_last_recvlen_poll) >= ESP01_HTTP_RECVLEN_POLL_MS) // Resynchronisation périodique
+    {
+        g_http_last_recvlen_poll = HAL_GetTick();
+        _http_sync_recvlen();
+    }
+
+    for (int i = 0; i < ESP01_MAX_CONNECTIONS; ++i)                         // Lecture tour à tour
+    {
+        if (g_connections[i].rx_pending && !_http_link_busy(&g_connections[i])) // Lien libre : la requête précédente a été traitée
+        {
+            _http_recv_passive(i);
+        }
+    }
+}
+
+/**
+ * @brief Laisse des octets d'une trame dans l'accumulateur jusqu'au tour de leur lien.
+ * @param conn_id Lien destinataire.
+ * @param idx     Index du premier octet dans g_accumulator.
+ * @param len     Nombre d'octets.
+ * @retval false si la table des données en attente est pleine.
+ */
+static bool _http_hold(int conn_id, uint16_t idx, uint16_t len)
+{
+    if (g_http_held_count > 0) // Suite de la zone précédente du même lien : fusion
+    {
+        _http_held_t *last = &g_http_held[g_http_held_count - 1];
+        if (last->conn_id == conn_id && (last->off + last->len) % ESP01_MAX_TOTAL_HTTP == idx)
+        {
+            last->len += len;
+            return true;
+        }
+    }
+    if (g_http_held_count >= ESP01_HTTP_MAX_HELD) // Table pleine : l'analyse attend l'ordonnanceur
+    {
+        return false;
+    }
+    g_http_held[g_http_held_count++] = (_http_held_t){idx, len, (int8_t)conn_id};
+    return true;
+}
+
+/**
+ * @brief Indique si un lien a des données en attente dans l'accumulateur.
+ * @param conn_id Lien.
+ * @retval true si au moins une zone est en attente.
+ */
+static bool _http_link_held(int conn_id)
+{
+    for (uint8_t i = 0; i < g_http_held_count; ++i)
+    {
+        if (g_http_held[i].conn_id == conn_id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Retire une entrée de la table des données en attente (ordre conservé).
+ * @param i Indice de l'entrée.
+ */
+static void _http_held_remove(uint8_t i)
+{
+    memmove(&g_http_held[i], &g_http_held[i + 1], (g_http_held_count - i - 1) * sizeof(_http_held_t));
+    g_http_held_count--;
+}
+
+/**
+ * @brief Abandonne les données en attente d'un lien fermé.
+ * @param conn_id Lien fermé.
+ */
+static void _http_drop_held(int conn_id)
+{
+    for (uint8_t i = 0; i < g_http_held_count;)
+    {
+        if (g_http_held[i].conn_id == conn_id)
+        {
+            _http_held_remove(i); // Libérée au prochain avancement de la tête
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+/**
+ * @brief Transmet les données en attente aux liens redevenus libres.
+ * @note  Zones traitées dans l'ordre d'arrivée ; un lien qui redevient occupé
+ *        garde ses zones suivantes pour le tour d'après.
+ */
+static void _http_release_held(void)
+{
+    uint8_t blocked = 0; // Liens occupés (bit par lien)
+    for (uint8_t i = 0; i < g_http_held_count;)
+    {
+        _http_held_t *held = &g_http_held[i];
+        uint8_t bit = (uint8_t)(1u << held->conn_id);
+        if ((blocked & bit) || _http_link_busy(&g_connections[held->conn_id])) // Requête précédente pas encore traitée
+        {
+            blocked |= bit;
+            i++;
+            continue;
+        }
+        size_t used = _http_acc_feed(held->conn_id, held->off, held->len); // Alimente le parseur du lien
+        held->off = (uint16_t)((held->off + used) % ESP01_MAX_TOTAL_HTTP);
+        held->len -= (uint16_t)used;
+        if (held->len == 0) // Zone entièrement consommée
+        {
+            _http_held_remove(i);
+            continue;
+        }
+        blocked |= bit; // Requête suivante dans la même zone
+        i++;
+    }
+}
+
+/**
+ * @brief Libère le début de l'accumulateur jusqu'aux premières données encore utiles.
+ * @note  Seule la tête avance : aucun octet n'est déplacé.
+ */
+static void _http_acc_release(void)
+{
+    uint16_t keep = g_acc_scan; // Octets analysés : libérables
+    if (g_http_held_count > 0)  // Sauf à partir de la plus ancienne zone en attente
+    {
+        uint16_t off = (uint16_t)((g_http_held[0].off + ESP01_MAX_TOTAL_HTTP - g_acc_head) % ESP01_MAX_TOTAL_HTTP);
+        if (off < keep)
+        {
+            keep = off;
+        }
+    }
+    g_acc_head = ESP01_HTTP_ACC_IDX(keep);
+    g_acc_len -= keep;
+    g_acc_scan -= keep;
+}
+
+/**
+ * @brief Traite une ligne AT reçue hors trame +IPD.
+ * @param line Début de la ligne.
+ * @param len  Longueur (fin de ligne comprise).
+ */
+static void _http_on_line(const char *line, int len)
+{
+    while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == '\n')) // Retire la fin de ligne
+    {
+        len--;
+    }
+
+    if (esp01_send_on_line(line, (size_t)len)) // ">", "SEND OK", "busy"... : pipeline d'émission
+    {
+        return;
+    }
+    if (len >= (int)strlen("+CIPRECVLEN:") && strncmp(line, "+CIPRECVLEN:", strlen("+CIPRECVLEN:")) == 0) // Réponse à AT+CIPRECVLEN?
+    {
+        _http_on_recvlen(line + strlen("+CIPRECVLEN:"), len - (int)strlen("+CIPRECVLEN:"));
+        return;
+    }
+    if (len == 2 && strncmp(line, "OK", 2) == 0)
+    {
+        g_http_rx_events |= ESP01_HTTP_EVT_OK;
+    }
+    else if (len >= 5 && strncmp(line, "ERROR", 5) == 0)
+    {
+        g_http_rx_events |= ESP01_HTTP_EVT_ERROR;
+    }
+    else if (len >= 8 && line[0] >= '0' && line[0] < '0' + ESP01_MAX_CONNECTIONS && line[1] == ',') // "n,CONNECT" / "n,CLOSED"
+    {
+        int id = line[0] - '0';
+        connection_info_t *conn = &g_connections[id];
+        bool connect = (len == 9 && strncmp(line + 2, "CONNECT", 7) == 0);
+        bool closed = (len == 8 && strncmp(line + 2, "CLOSED", 6) == 0);
+        if (!connect && !closed)
+        {
+            return;
+        }
+        ESP01_LOG_DEBUG("HTTP", "Lien %d %s", id, connect ? "ouvert" : "fermé");
+        if (connect && !conn->is_client && !conn->is_udp) // Lien sortant ou UDP : ouvert par AT+CIPSTART
+        {
+            g_stats.link_accepts++;
+        }
+        else if (closed)
+        {
+            g_stats.link_closes++;
+        }
+        conn->conn_id = id;
+        conn->is_active = connect;         // Nouvel état du lien
+        conn->last_activity = HAL_GetTick(); // Met à jour le timestamp d'activité
+        conn->requests = 0;                // Nouveau client : pas encore de keep-alive
+        conn->tx_head = 0;                 // File d'émission de l'ancienne connexion abandonnée
+        conn->tx_len = 0;
+        _http_push_detach(conn);           // Fermeture WebSocket/SSE signalée par l'ordonnanceur
+        if (!conn->in_handler) // La requête en cours de traitement reste valide jusqu'au retour du handler
+        {
+            esp01_http_parser_reset(&conn->parser);
+        }
+        if (closed)
+        {
+            _http_drop_held(id); // Requêtes en attente du lien abandonnées
+            conn->is_udp = false; // Le lien peut être attribué à un client du serveur
+            conn->udp_cb = NULL;  // Datagrammes en file abandonnés
+        }
+        else
+        {
+            uint32_t active = (uint32_t)esp01_get_active_connection_count();
+            if (active > g_stats.links_peak) // Occupation maximale des liens
+            {
+                g_stats.links_peak = active;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Lit le flux RX dans l'accumulateur, dans la limite de la place libre.
+ * @retval true si l'accumulateur est plein (des octets peuvent rester dans le DMA).
+ */
+static bool _http_acc_fill(void)
+{
+    uint8_t buffer[ESP01_SMALL_BUF_SIZE]; // Buffer temporaire pour la lecture UART
+    for (;;)
+    {
+        size_t space = ESP01_MAX_TOTAL_HTTP - (size_t)g_acc_len; // Place libre : le reste attend dans le DMA
+        if (space == 0)
+        {
+            return true;
+        }
+        int len = esp01_get_new_data(buffer, space < sizeof(buffer) ? (uint16_t)space : sizeof(buffer)); // Récupère les nouveaux octets reçus
+        if (len <= 0)
+        {
+            return false;
+        }
+        _http_acc_append(buffer, (size_t)len); // Ajoute les données à l'accumulateur
+    }
+}
+
+/**
+ * @brief Libère de la place quand l'accumulateur est plein de données en attente.
+ * @retval true si de la place a été libérée.
+ * @note  Les données en attente du lien arrivé en dernier (client qui envoie trop
+ *        de requêtes d'avance) sont abandonnées ; les autres liens sont préservés.
+ */
+static bool _http_acc_reclaim(void)
+{
+    if (g_http_held_count == 0)
+    {
+        return false;
+    }
+    int conn_id = g_http_held[g_http_held_count - 1].conn_id;
+    ESP01_LOG_ERROR("HTTP", "Accumulateur HTTP plein : requêtes en attente abandonnées sur connexion %d", conn_id);
+    _http_drop_held(conn_id);
+    if (g_acc_frame_left > 0 && g_acc_frame_conn == conn_id) // Fin de la trame en cours ignorée
+    {
+        g_acc_frame_conn = -1;
+    }
+    _http_acc_release();
+    return true;
+}
+
+/**
+ * @brief Analyse les octets de l'accumulateur à partir du curseur.
+ */
+static void _http_acc_scan(void)
+{
+    _http_release_held(); // Données en attente des liens redevenus libres
+
+    while (g_acc_scan < g_acc_len)
+    {
+        int avail = g_acc_len - g_acc_scan; // Octets non analysés
+
+        if (g_acc_frame_left > 0) // Données de la trame +IPD en cours
+        {
+            uint16_t idx = ESP01_HTTP_ACC_IDX(g_acc_scan);
+            uint16_t n = avail < g_acc_frame_left ? (uint16_t)avail : g_acc_frame_left; // Octets disponibles de la trame
+            int id = g_acc_frame_conn;
+            size_t used;
+            if (id < 0) // Lien non suivi : données ignorées
+            {
+                used = n;
+            }
+            else if (_http_link_busy(&g_connections[id]) || _http_link_held(id)) // Requête précédente pas encore traitée
+            {
+                if (!_http_hold(id, idx, n))
+                {
+                    break;
+                }
+                used = n;
+            }
+            else
+            {
+                used = _http_acc_feed(id, idx, n); // Alimente le parseur du lien
+            }
+            g_acc_scan += (uint16_t)used;
+            g_acc_frame_left -= (uint16_t)used;
+            continue;
+        }
+
+        char head[ESP01_SMALL_BUF_SIZE];                         // Début linéarisé (en-tête ou ligne)
+        int head_len = _http_acc_copy(g_acc_scan, head, sizeof(head)); // Octets copiés
+        if (head_len < 5 && strncmp(head, "+IPD,", head_len) == 0)   // Début de trame incomplet
+        {
+            break;
+        }
+        if (strncmp(head, "+IPD,", 5) == 0) // Trame +IPD ou notification du mode passif
+        {
+            char *eoh = NULL;    // Fin de l'en-tête (':' en mode actif, '\n' en mode passif)
+            bool quoted = false; // Dans l'adresse du client (IPv6 : ':' à ignorer)
+            for (int k = 5; k < head_len && !eoh; ++k)
+            {
+                if (head[k] == '"')
+                {
+                    quoted = !quoted;
+                }
+                else if ((head[k] == ':' && !quoted) || head[k] == '\n')
+                {
+                    eoh = head + k;
+                }
+            }
+            http_request_t ipd = eoh ? parse_ipd_header(head) : (http_request_t){0};
+            if (!ipd.is_valid || ipd.content_length < 0) // En-tête incomplet ou invalide
+            {
+                if (!eoh && head_len == avail) // Suite de l'en-tête attendue
+                {
+                    break;
+                }
+                g_acc_scan += 5; // Ignore le faux "+IPD,"
+                continue;
+            }
+            bool tracked = ipd.conn_id >= 0 && ipd.conn_id < ESP01_MAX_CONNECTIONS; // Lien suivi par le serveur
+            g_acc_scan += (uint16_t)(eoh - head + 1);                              // En-tête analysé
+            if (tracked)
+            {
+                _http_touch_connection(&ipd); // Met à jour la connexion
+            }
+            if (ipd.is_passive)               // Notification du mode passif
+            {
+                if (tracked)
+                {
+                    g_connections[ipd.conn_id].rx_pending += ipd.content_length; // Octets à lire par AT+CIPRECVDATA
+                    ESP01_LOG_DEBUG("HTTP", "IPD passif : %d octets en attente sur connexion %d", ipd.content_length, ipd.conn_id);
+                }
+                continue;
+            }
+            if (!tracked)
+            {
+                ESP01_LOG_WARN("HTTP", "IPD ignoré : connexion %d hors limites", ipd.conn_id); // Lien non suivi
+            }
+            else
+            {
+                ESP01_LOG_DEBUG("HTTP", "IPD reçu : %d octets sur connexion %d", ipd.content_length, ipd.conn_id);
+            }
+            if (tracked && g_connections[ipd.conn_id].is_udp) // Une trame = un datagramme
+            {
+                _http_udp_begin(&ipd);
+            }
+            g_acc_frame_conn = tracked ? (int8_t)ipd.conn_id : -1;
+            g_acc_frame_left = (uint16_t)ipd.content_length;
+            continue;
+        }
+        if (head[0] == '>') // Invite d'AT+CIPSEND (sans fin de ligne)
+        {
+            esp01_send_on_line(">", 1);
+            g_acc_scan++;
+            continue;
+        }
+
+        int line_len = 0; // Ligne AT : jusqu'au '\n' ou au prochain "+IPD,"
+        for (int k = 0; k < avail && !line_len; ++k)
+        {
+            char c = g_accumulator[ESP01_HTTP_ACC_IDX(g_acc_scan + k)];
+            if (c == '\n')
+            {
+                line_len = k + 1;
+            }
+            else if (k > 0 && c == '+' && avail - k >= 5)
+            {
+                char tag[6];
+                _http_acc_copy(g_acc_scan + k, tag, sizeof(tag));
+                if (memcmp(tag, "+IPD,", 5) == 0)
+                {
+                    line_len = k;
+                }
+            }
+        }
+        if (!line_len) // Ligne incomplète
+        {
+            if (avail < ESP01_MAX_HEADER_LINE)
+            {
+                break;
+            }
+            line_len = avail; // Octets sans fin de ligne : ignorés
+        }
+        _http_on_line(head, line_len < head_len ? line_len : head_len);
+        g_acc_scan += (uint16_t)line_len;
+    }
+
+    _http_acc_release(); // Avance la tête (rien n'est déplacé)
+}
+
+/**
+ * @brief Lit le flux RX et traite les trames +IPD et les lignes AT.
+ *
+ * @details
+ * L'analyse reprend au curseur g_acc_scan : les octets déjà vus ne sont jamais
+ * relus. Les données d'une trame sont transmises au parseur du lien au fil de
+ * leur arrivée (une trame partielle n'est pas perdue) ; celles d'un lien dont la
+ * requête précédente n'est pas encore traitée restent en place (g_http_held) et
+ * seule la tête de l'accumulateur avance. Aucun handler n'est appelé ici : la
+ * fonction peut être utilisée pendant un envoi.
+ */
+static void _http_scan_rx(void)
+{
+    bool full = true;
+    while (full)
+    {
+        full = _http_acc_fill(); // Lit le DMA tant qu'il y a de la place
+        _http_acc_scan();        // Analyse (libère de la place)
+        if (full && g_acc_len >= ESP01_MAX_TOTAL_HTTP) // Toujours plein : les réponses AT ne seraient plus lues
+        {
+            full = _http_acc_reclaim();
+        }
+    }
+}
+
+/**
+ * @brief Traite la requête complète (ou invalide) d'un lien puis réarme son parseur.
+ * @param conn_id Identifiant de connexion.
+ */
+static void _http_dispatch_link(int conn_id)
+{
+    connection_info_t *conn = &g_connections[conn_id];
+    esp01_http_parser_t *parser = &conn->parser;
+    esp01_route_t *route = NULL;     // Route servie (métriques)
+    uint32_t start = HAL_GetTick();  // Début du traitement (histogramme de latence)
+    uint32_t bytes = conn->tx_bytes; // Octets déjà écrits sur le lien
+    conn->resp_status = 0;
+    conn->in_handler = true; // La requête reste valide pendant le handler
+    g_http_dispatch_depth++;
+
+    if (!conn->is_active) // Client parti entre-temps
+    {
+        ESP01_LOG_DEBUG("HTTP", "Requête abandonnée : connexion %d fermée", conn_id);
+    }
+    else if (conn->ws_cb) // Trame WebSocket prête
+    {
+        _http_ws_dispatch(conn_id);
+    }
+    else if (parser->state == HTTP_PARSER_ERROR) // Requête invalide
+    {
+        ESP01_LOG_DEBUG("HTTP", "Parsing HTTP échoué, envoi d'une 400");
+        const char *body = "<html><body><h1>400 Bad Request</h1></body></html>";                                // Corps HTML pour la 400
+        esp01_send_http_response(conn_id, ESP01_HTTP_BAD_REQUEST_CODE, "text/html", body, strlen(body)); // Envoie la 400
+    }
+    else if (_http_rl_admit(conn_id)) // Sous la limite de débit (sinon le refus est déjà envoyé)
+    {
+        ESP01_LOG_DEBUG("HTTP", "Méthode=%s, Path=%s, Query=%.*s", parser->request.method, parser->request.path, (int)parser->request.query_len, parser->request.query_string);
+        route = _http_dispatch_request(conn_id, &parser->request); // Route la requête
+    }
+    if (conn->resp_status) // Une réponse a été écrite
+    {
+        _http_metrics_record(route ? &route->stats : &g_http_unrouted_stats, conn->resp_status, conn->tx_bytes - bytes, HAL_GetTick() - start);
+    }
+
+    if (conn->is_active && !conn->ws_cb && !conn->sse_cb && !_http_keep_alive(conn_id)) // "Connection: close" annoncé : fermé après envoi
+    {
+        esp01_http_close_connection(conn_id);
+    }
+    else if (conn->is_active && !conn->ws_cb && !conn->sse_cb) // Requête HTTP terminée : le délai keep-alive démarre
+    {
+        conn->requests++;
+        conn->last_activity = HAL_GetTick();
+    }
+
+    g_http_dispatch_depth--;
+    conn->in_handler = false;
+    esp01_http_parser_reset(parser); // Prêt pour la requête suivante (trames en attente libérées)
+}
+
+/**
+ * @brief Un tour de l'ordonnanceur : chaque lien, à tour de rôle, voit au plus
+ *        une requête routée et un segment de sa file d'émission envoyé.
+ * @note  Les handlers ne sont appelés que hors handler (boucle principale, attente
+ *        du client HTTP) : jamais imbriqués.
+ */
+static void _http_schedule_round(void)
+{
+    _http_scan_rx(); // Nouvelles trames et évènements
+
+    int first = g_http_rr_next;                                 // Premier lien servi à ce tour
+    g_http_rr_next = (g_http_rr_next + 1) % ESP01_MAX_CONNECTIONS; // Le suivant commencera le prochain tour
+    for (int k = 0; k < ESP01_MAX_CONNECTIONS; ++k)
+    {
+        int i = (first + k) % ESP01_MAX_CONNECTIONS;
+        connection_info_t *conn = &g_connections[i];
+        if (g_http_dispatch_depth == 0 && _http_link_busy(conn) && !conn->in_handler) // Requête prête
+        {
+            _http_dispatch_link(i);
+        }
+        if (g_http_dispatch_depth == 0 && (conn->ws_close_cb || conn->sse_close_cb) && !conn->in_handler) // WebSocket ou flux SSE fermé
+        {
+            _http_push_notify_close(i);
+        }
+        if (conn->tx_len > 0 && conn->is_active) // Réponse en file
+        {
+            _http_txq_send(i);
+        }
+    }
+}
+
+/**
+ * @brief Un tour d'émission : chaque lien, à tour de rôle, envoie un segment de sa file.
+ * @note  Utilisé pendant un handler (file pleine, esp01_http_flush) : aucun autre
+ *        handler n'est appelé, les requêtes prêtes attendent la boucle principale.
+ */
+static void _http_txq_round(void)
+{
+    _http_scan_rx(); // Nouvelles trames et évènements ("SEND OK", CLOSED)
+
+    int first = g_http_rr_next;                                 // Premier lien servi à ce tour
+    g_http_rr_next = (g_http_rr_next + 1) % ESP01_MAX_CONNECTIONS; // Le suivant commencera le prochain tour
+    for (int k = 0; k < ESP01_MAX_CONNECTIONS; ++k)
+    {
+        int i = (first + k) % ESP01_MAX_CONNECTIONS;
+        if (g_connections[i].tx_len > 0 && g_connections[i].is_active) // Réponse en file
+        {
+            _http_txq_send(i);
+        }
+    }
+}
+
+/**
+ * @brief Traite automatiquement les requêtes HTTP reçues (DMA accumulateur).
+ */
+void esp01_process_requests(void)
+{
+    if (g_processing_request) // Si un traitement est déjà en cours
+    {
+        return;               // Sort sans rien faire
+    }
+
+    g_processing_request = 1; // Marque le début du traitement
+
+    _http_scan_rx(); // Trames +IPD, notifications et évènements AT
+
+    // --- Lecture des données en attente (mode passif) ---
+    if (g_http_passive_recv)
+    {
+        _http_poll_passive();
+    }
+
+    _http_udp_deliver();    // Datagrammes UDP reçus complets
+    _http_schedule_round(); // Requêtes prêtes et files d'émission, lien par lien
 
     g_processing_request = 0; // Marque la fin du traitement
 }
@@ -9,8 +9,20 @@
  * @details
  * Ce header regroupe toutes les fonctions de gestion HTTP du module ESP01 :
  *   - Serveur web embarqué (multi-connexion, gestion des routes, réponses)
+ *   - Traitement concurrent des liens (tourniquet, file d'émission par lien)
  *   - Parsing et gestion des requêtes/réponses HTTP
  *   - Outils de gestion des connexions et statistiques HTTP
+ *   - Réponses en flux (chunked) et moteur de templates HTML précompilés
+ *   - Cache de réponses à courte durée de vie, activable par route
+ *   - Métriques par route (compteurs, histogrammes de latence) au format Prometheus
+ *   - Routes WebSocket (RFC 6455) : poignée de main, trames, ping/pong, envoi par lien
+ *   - Routes Server-Sent Events : flux text/event-stream, évènements numérotés, heartbeats
+ *   - Client HTTP : requêtes sur un lien sortant persistant, réponse analysée au fil de l'eau
+ *   - Limitation de débit par adresse IP et globale (seaux à jetons, 429/503 ou fermeture)
+ *   - Cycle de vie des liens : délais configurables, éviction LRU des liens inactifs
+ *   - Mise à jour OTA en flux vers un slot A/B (CRC-32, validation ou rollback)
+ *   - Fichiers d'un stockage externe (Range, 206 Partial Content), lus par blocs
+ *   - Sockets UDP : datagrammes émis sans attente, réception avec l'adresse de l'émetteur
  *
  * @note
  *   - Nécessite le driver bas niveau STM32_WifiESP.h
@@ -33,18 +45,67 @@
 // --- Limites et tailles ---
 #define ESP01_MAX_HTTP_METHOD_LEN 8
 #define ESP01_MAX_HTTP_PATH_LEN 64
-#define ESP01_MAX_HTTP_QUERY_LEN 64
-#define ESP01_MAX_ROUTES 8
-#define ESP01_MAX_CONNECTIONS 4
+#define ESP01_MAX_ROUTES 10
 #define ESP01_MAX_HEADER_LINE 256
 #define ESP01_MAX_TOTAL_HTTP 2048
 #define ESP01_MAX_CIPSEND_BUF 64
 #define ESP01_MAX_HTTP_REQ_BUF 256
 #define ESP01_MULTI_CONNECTION 1
+#define ESP01_HTTP_PARSER_BUF_SIZE 512 // Ligne de requête + en-têtes conservés par connexion (en-têtes usuels d'un navigateur)
+#define ESP01_HTTP_RECV_CHUNK 512      // Taille max d'une lecture AT+CIPRECVDATA (mode passif)
+#define ESP01_HTTP_RECVLEN_POLL_MS 500 // Période de resynchronisation AT+CIPRECVLEN? (mode passif)
+#define ESP01_HTTP_STREAM_BUF_SIZE 256 // Tampon d'une réponse en flux (en-tête + petits segments)
+#define ESP01_HTTP_TXQ_SIZE 256         // File d'émission par lien : en-tête + petite réponse (au-delà : envoi direct)
+#define ESP01_HTTP_TX_SEGMENT 1024      // Taille max d'un AT+CIPSEND par lien et par tour
+#define ESP01_HTTP_LINK_RAM_BUDGET 4096 // RAM des tampons par lien (parseur + file d'émission), tous liens confondus
+#define ESP01_HTTP_MAX_HELD 8           // Zones de trames +IPD en attente d'un lien occupé (accumulateur circulaire)
+#define ESP01_HTTP_CACHE_POOL_SIZE 2048   // Octets de réponses rendues conservés (toutes routes confondues)
+#define ESP01_HTTP_CACHE_MAX_ENTRIES 4    // Réponses en cache simultanées
+#define ESP01_HTTP_CACHE_KEY_LEN 96       // Clé chemin + "?" + query (au-delà : réponse non mise en cache)
+#define ESP01_HTTP_LAT_BUCKETS 14         // Histogramme de latence : bornes 1, 2, 4 ... 4096 ms puis +Inf
+#define ESP01_WS_PING_INTERVAL_MS 15000   // Ping serveur d'un lien WebSocket silencieux (avant ESP01_CONN_TIMEOUT_MS)
+#define ESP01_SSE_HEARTBEAT_MS 15000      // Commentaire ":" envoyé sur un flux SSE sans évènement (proxys, détection de coupure)
+#define ESP01_SSE_RETRY_MS 3000           // Délai de reconnexion annoncé au navigateur ("retry:")
+#define ESP01_HTTP_CLIENT_HOST_LEN 64     // Nom d'hôte max d'une URL du client HTTP
+#define ESP01_HTTP_CLIENT_LINE_LEN 128    // Ligne de statut/en-tête de réponse conservée (au-delà : tronquée)
+#define ESP01_HTTP_CLIENT_TIMEOUT_MS 10000 // Silence max du serveur pendant une réponse
+#define ESP01_HTTP_RL_CLIENTS 8           // Adresses IP suivies par la limitation de débit (la moins récente est recyclée)
+#define ESP01_HTTP_KEEPALIVE_TIMEOUT_MS 5000 // Attente max de la requête suivante sur un lien ayant déjà répondu
+#define ESP01_HTTP_LINK_RESERVE 1         // Liens gardés libres pour les nouveaux clients (éviction LRU au-delà)
+#define ESP01_HTTP_EVICT_MIN_IDLE_MS 1000 // Silence minimal d'un lien avant qu'il puisse être évincé
+#define ESP01_OTA_BUF_SIZE 256            // Tampons ping-pong de l'écriture OTA (multiple de write_align)
+#define ESP01_OTA_FLASH_TIMEOUT_MS 5000   // Durée max d'un effacement ou d'une programmation flash
+#define ESP01_HTTP_FILE_CHUNK 512         // Bloc lu dans le stockage par la route de fichiers (pile du handler)
+#define ESP01_UDP_RX_POOL_SIZE 512        // Octets de datagrammes reçus en attente de livraison (tous liens UDP)
+#define ESP01_UDP_RX_MAX_QUEUED 8         // Datagrammes reçus en attente de livraison
+// --- Opcodes WebSocket ---
+#define ESP01_WS_OP_CONT 0x0
+#define ESP01_WS_OP_TEXT 0x1
+#define ESP01_WS_OP_BINARY 0x2
+#define ESP01_WS_OP_CLOSE 0x8
+#define ESP01_WS_OP_PING 0x9
+#define ESP01_WS_OP_PONG 0xA
+// Budget RAM des liens : 5 x (512 + 256) = 3840 octets. Réduire ESP01_MAX_CONNECTIONS
+// (AT+CIPSERVERMAXCONN côté ESP) ou les tampons plutôt que de dépasser le budget.
+#if ESP01_MAX_CONNECTIONS * (ESP01_HTTP_PARSER_BUF_SIZE + ESP01_HTTP_TXQ_SIZE) > ESP01_HTTP_LINK_RAM_BUDGET
+#error "Tampons par lien au-delà d'ESP01_HTTP_LINK_RAM_BUDGET"
+#endif
 // --- Codes HTTP ---
+#define ESP01_HTTP_SWITCHING_CODE 101
 #define ESP01_HTTP_OK_CODE 200
+#define ESP01_HTTP_NO_CONTENT_CODE 204
+#define ESP01_HTTP_PARTIAL_CONTENT_CODE 206
+#define ESP01_HTTP_NOT_MODIFIED_CODE 304
+#define ESP01_HTTP_BAD_REQUEST_CODE 400
 #define ESP01_HTTP_NOT_FOUND_CODE 404
+#define ESP01_HTTP_METHOD_NOT_ALLOWED_CODE 405
+#define ESP01_HTTP_CONFLICT_CODE 409
+#define ESP01_HTTP_LENGTH_REQUIRED_CODE 411
+#define ESP01_HTTP_PAYLOAD_TOO_LARGE_CODE 413
+#define ESP01_HTTP_RANGE_NOT_SATISFIABLE_CODE 416
+#define ESP01_HTTP_TOO_MANY_REQUESTS_CODE 429
 #define ESP01_HTTP_INTERNAL_ERR_CODE 500
+#define ESP01_HTTP_UNAVAILABLE_CODE 503
 #define ESP01_HTTP_404_BODY "<html><body><h1>404 Not Found</h1></body></html>"
 
 /* =========================== TYPES & STRUCTURES ============================ */
@@ -55,15 +116,169 @@ typedef struct
 {
     char method[ESP01_MAX_HTTP_METHOD_LEN];      ///< Verbe HTTP (GET, POST, ...)
     char path[ESP01_MAX_HTTP_PATH_LEN];          ///< Chemin de la requête
-    char query_string[ESP01_MAX_HTTP_QUERY_LEN]; ///< Query string extraite
+    const char *query_string;                    ///< Vue sur la query string (dans le buffer de réception, "" si absente)
+    uint16_t query_len;                          ///< Longueur de la query string
     bool is_valid;                               ///< Indique si la requête est valide
+    const char *headers;                         ///< Bloc d'en-têtes brut (vue, non terminé par '\0'), NULL si absent
+    uint16_t headers_len;                        ///< Taille du bloc d'en-têtes
+    uint32_t content_length;                     ///< Valeur de Content-Length (0 si absent)
+    const char *body;                            ///< Corps conservé (routes sans callback, s'il tient dans le parseur), NULL sinon
+    uint16_t body_len;                           ///< Taille du corps conservé
 } http_parsed_request_t;
 
+/**
+ * @brief Paire clé/valeur urlencodée (vues dans les données d'origine, non terminées par '\0').
+ */
+typedef struct
+{
+    const char *key;    ///< Clé (encodée)
+    uint16_t key_len;   ///< Longueur de la clé
+    const char *value;  ///< Valeur (encodée)
+    uint16_t value_len; ///< Longueur de la valeur
+    bool encoded;       ///< true si clé ou valeur contient %XX ou '+' (sinon la vue est déjà décodée)
+} esp01_http_kv_t;
+
+/**
+ * @brief Itérateur sur des paires clé=valeur&... (query string ou formulaire).
+ */
+typedef struct
+{
+    const char *pos; ///< Position courante
+    const char *end; ///< Fin des données
+} esp01_http_kv_iter_t;
+
+/**
+ * @brief États du parseur HTTP incrémental.
+ */
+typedef enum
+{
+    HTTP_PARSER_REQUEST_LINE = 0, ///< Lecture de la ligne de requête
+    HTTP_PARSER_HEADERS,          ///< Lecture des en-têtes
+    HTTP_PARSER_BODY,             ///< Réception du corps (Content-Length)
+    HTTP_PARSER_COMPLETE,         ///< Requête complète, prête à être routée
+    HTTP_PARSER_ERROR             ///< Requête invalide ou en-têtes trop longs
+} http_parser_state_t;
+
+/**
+ * @brief Prototype de callback de réception du corps d'une requête (appelé par morceaux).
+ */
+typedef void (*esp01_http_body_cb_t)(int conn_id, const http_parsed_request_t *req, const uint8_t *data, size_t len);
+
+/**
+ * @brief Parseur HTTP incrémental (machine à états, sans allocation).
+ *
+ * @details
+ * Alimenté directement avec les octets utiles des trames +IPD, il peut reprendre
+ * une requête répartie sur plusieurs trames. La ligne de requête et les en-têtes
+ * sont conservés tels quels dans buf : les en-têtes sont lus à la demande via
+ * esp01_http_get_header(). Le corps est transmis par morceaux au callback
+ * on_body ; sans callback, il est conservé à la suite des en-têtes s'il tient
+ * dans buf (request.body).
+ */
+typedef struct
+{
+    http_parser_state_t state;            ///< État courant
+    int conn_id;                          ///< Connexion associée (transmise au callback)
+    char buf[ESP01_HTTP_PARSER_BUF_SIZE]; ///< Ligne de requête + en-têtes bruts
+    uint16_t buf_len;                     ///< Octets utilisés dans buf
+    uint16_t line_start;                  ///< Début de la ligne en cours dans buf
+    uint16_t headers_start;               ///< Début du bloc d'en-têtes dans buf
+    uint16_t body_start;                  ///< Début du corps conservé dans buf
+    uint32_t body_received;               ///< Octets de corps déjà reçus
+    http_parsed_request_t request;        ///< Requête en cours de construction
+    esp01_http_body_cb_t on_body;         ///< Callback de réception du corps (optionnel)
+} esp01_http_parser_t;
+
 /**
  * @brief Prototype de handler de route HTTP.
  */
 typedef void (*esp01_route_handler_t)(int conn_id, const http_parsed_request_t *req);
 
+/**
+ * @brief Évènements d'un lien WebSocket.
+ */
+typedef enum
+{
+    ESP01_WS_EVT_OPEN = 0, ///< Poignée de main terminée
+    ESP01_WS_EVT_TEXT,     ///< Message texte complet (terminé par '\0')
+    ESP01_WS_EVT_BINARY,   ///< Message binaire complet
+    ESP01_WS_EVT_CLOSE     ///< Lien fermé (par le client, le serveur ou une erreur)
+} esp01_ws_event_t;
+
+/**
+ * @brief Callback d'une route WebSocket (appelé par l'ordonnanceur, comme un handler).
+ * @param conn_id Lien WebSocket.
+ * @param event   Évènement.
+ * @param data    Message reçu (vue dans le tampon du lien, valide pendant l'appel), NULL sinon.
+ * @param len     Taille du message.
+ */
+typedef void (*esp01_ws_cb_t)(int conn_id, esp01_ws_event_t event, const uint8_t *data, size_t len);
+
+/**
+ * @brief Parseur de trames WebSocket d'un lien.
+ *
+ * @details
+ * Le message en cours est reconstitué (démasqué, fragments réunis) dans le
+ * tampon du parseur HTTP du lien, inutilisé après la poignée de main. Le
+ * payload d'une trame de contrôle est placé à la suite. Une trame complète
+ * bloque le lien jusqu'à son traitement par l'ordonnanceur.
+ */
+typedef struct
+{
+    uint8_t hdr[14];     ///< En-tête de la trame en cours de réception
+    uint8_t hdr_len;     ///< Octets d'en-tête reçus
+    uint8_t frame_op;    ///< Opcode de la trame en cours
+    bool frame_fin;      ///< Dernier fragment du message
+    uint32_t frame_left; ///< Octets de payload restant à recevoir
+    uint16_t frame_pos;  ///< Octets de payload reçus (index de la clé de masquage)
+    uint8_t msg_op;      ///< Opcode du message en cours (0 : aucun)
+    uint16_t msg_len;    ///< Octets du message reconstitués
+    uint16_t ctrl_len;   ///< Payload de la dernière trame de contrôle
+    uint8_t ready;       ///< Opcode de la trame à traiter par l'ordonnanceur (0 : aucune)
+    uint16_t close_code; ///< Erreur de protocole détectée (code de fermeture), 0 sinon
+    uint32_t ping_at;    ///< Activité du lien lors du dernier ping serveur
+} esp01_ws_parser_t;
+
+/**
+ * @brief Évènements d'un lien Server-Sent Events.
+ */
+typedef enum
+{
+    ESP01_SSE_EVT_OPEN = 0, ///< En-têtes text/event-stream envoyés
+    ESP01_SSE_EVT_CLOSE     ///< Lien fermé
+} esp01_sse_event_t;
+
+/**
+ * @brief Callback d'une route SSE (appelé par l'ordonnanceur, comme un handler).
+ * @param conn_id       Lien SSE.
+ * @param event         Évènement.
+ * @param last_event_id En-tête Last-Event-ID d'une reconnexion (0 : aucun), à l'ouverture.
+ */
+typedef void (*esp01_sse_cb_t)(int conn_id, esp01_sse_event_t event, uint32_t last_event_id);
+
+/**
+ * @brief Backend de stockage d'une route de fichiers (flash SPI, carte SD...).
+ * @note  Les noms sont relatifs au préfixe de la route ; ".." est refusé avant l'appel.
+ */
+typedef struct
+{
+    ESP01_Status_t (*stat)(void *ctx, const char *name, uint32_t *size, const char **content_type); ///< Taille et type MIME (NULL : d'après l'extension) ; ESP01_FAIL si absent
+    int (*read)(void *ctx, const char *name, uint32_t offset, uint8_t *buf, size_t len);           ///< Lit jusqu'à len octets à offset ; nombre lu, <= 0 : erreur
+    void *ctx;                                                                                     ///< Contexte du backend
+} esp01_http_storage_t;
+
+/**
+ * @brief Métriques d'une route HTTP (exposées par la route de métriques).
+ */
+typedef struct
+{
+    uint32_t requests;                                ///< Requêtes traitées
+    uint32_t bytes_out;                               ///< Octets de réponse écrits (en-tête compris)
+    uint32_t status_class[5];                         ///< Réponses par classe (indice 0 : 1xx ... 4 : 5xx)
+    uint32_t latency_sum_ms;                          ///< Somme des durées de traitement (ms)
+    uint32_t latency_buckets[ESP01_HTTP_LAT_BUCKETS]; ///< Durées <= 2^i ms (non cumulées, dernier : au-delà)
+} esp01_route_stats_t;
+
 /**
  * @brief Structure représentant une route HTTP et son handler associé.
  */
@@ -71,8 +286,34 @@ typedef struct
 {
     char path[ESP01_MAX_HTTP_PATH_LEN]; ///< Chemin de la route
     esp01_route_handler_t handler;      ///< Pointeur vers la fonction handler
+    esp01_http_body_cb_t on_body;       ///< Réception du corps par morceaux (NULL : corps conservé si possible)
+    uint32_t cache_ttl_ms;              ///< Durée de vie des réponses en cache (0 : pas de cache)
+    esp01_route_stats_t stats;          ///< Métriques de la route
+    esp01_ws_cb_t on_ws;                ///< Callback WebSocket (NULL : route HTTP)
+    esp01_sse_cb_t on_sse;              ///< Callback SSE (NULL : route HTTP)
+    const esp01_http_storage_t *storage; ///< Fichiers servis sous ce préfixe (NULL : chemin exact)
 } esp01_route_t;
 
+/**
+ * @brief Filtrage de l'émetteur d'un lien UDP (paramètre <mode> d'AT+CIPSTART).
+ */
+typedef enum
+{
+    ESP01_UDP_PEER_FIXED = 0, ///< Destination fixe
+    ESP01_UDP_PEER_ONCE = 1,  ///< La destination devient le premier émetteur reçu
+    ESP01_UDP_PEER_ANY = 2    ///< La destination suit chaque émetteur (serveur, collecte de plusieurs capteurs)
+} esp01_udp_mode_t;
+
+/**
+ * @brief Callback de réception d'un datagramme UDP (appelé depuis esp01_http_loop, peut émettre).
+ * @param link        Lien UDP.
+ * @param data        Contenu du datagramme (valide pendant l'appel).
+ * @param len         Taille du datagramme.
+ * @param remote_ip   Adresse de l'émetteur ("" sans AT+CIPDINFO=1).
+ * @param remote_port Port de l'émetteur (0 sans AT+CIPDINFO=1).
+ */
+typedef void (*esp01_udp_cb_t)(int link, const uint8_t *data, size_t len, const char *remote_ip, uint16_t remote_port);
+
 /**
  * @brief Informations sur une connexion HTTP active.
  */
@@ -83,6 +324,23 @@ typedef struct
     bool is_active;                   ///< Etat actif/inactif
     char client_ip[ESP01_MAX_IP_LEN]; ///< Adresse IP du client
     uint16_t client_port;             ///< Port du client
+    uint32_t rx_pending;              ///< Octets en attente dans l'ESP (mode réception passif)
+    esp01_http_parser_t parser;       ///< Parseur de la requête en cours sur ce lien
+    uint8_t tx_buf[ESP01_HTTP_TXQ_SIZE]; ///< File d'émission circulaire du lien
+    uint16_t tx_head;                    ///< Début des octets en attente dans tx_buf
+    uint16_t tx_len;                     ///< Octets en attente d'émission
+    bool in_handler;                     ///< Handler en cours d'exécution pour ce lien
+    uint16_t resp_status;                ///< Code HTTP de la réponse en cours (0 : aucune)
+    uint32_t tx_bytes;                   ///< Octets de réponse écrits sur ce lien
+    esp01_ws_cb_t ws_cb;                 ///< Callback WebSocket du lien (NULL : lien HTTP)
+    esp01_ws_cb_t ws_close_cb;           ///< Fermeture WebSocket à signaler à l'application
+    esp01_ws_parser_t ws;                ///< Parseur de trames WebSocket
+    esp01_sse_cb_t sse_cb;               ///< Callback SSE du lien (NULL : lien HTTP)
+    esp01_sse_cb_t sse_close_cb;         ///< Fermeture SSE à signaler à l'application
+    bool is_client;                      ///< Lien sortant du client HTTP (AT+CIPSTART)
+    uint16_t requests;                   ///< Requêtes HTTP traitées sur ce lien (keep-alive)
+    bool is_udp;                         ///< Lien UDP (AT+CIPSTART="UDP")
+    esp01_udp_cb_t udp_cb;               ///< Callback de réception du lien UDP (NULL : datagrammes ignorés)
 } connection_info_t;
 
 /**
@@ -96,6 +354,7 @@ typedef struct
     char client_ip[ESP01_MAX_IP_LEN]; ///< Adresse IP du client
     int client_port;                  ///< Port du client
     bool has_ip;                      ///< Indique si l'IP est connue
+    bool is_passive;                  ///< Notification du mode passif (données à lire par AT+CIPRECVDATA)
 } http_request_t;
 
 /**
@@ -109,15 +368,197 @@ typedef struct
     uint32_t failed_responses;       ///< Nombre de réponses en erreur
     uint32_t total_response_time_ms; ///< Temps total de réponse (ms)
     uint32_t avg_response_time_ms;   ///< Temps de réponse moyen (ms)
+    uint32_t cache_hits;             ///< Réponses servies depuis le cache (handler non appelé)
+    uint32_t cache_misses;           ///< Requêtes GET sur une route en cache ayant appelé le handler
+    uint32_t link_accepts;           ///< Liens ouverts par un client (n,CONNECT)
+    uint32_t link_closes;            ///< Liens fermés (n,CLOSED)
+    uint32_t link_timeouts;          ///< Liens fermés pour inactivité
+    uint32_t link_keepalive_closes;  ///< Liens keep-alive fermés faute de requête suivante
+    uint32_t link_evictions;         ///< Liens inactifs fermés pour libérer une place (LRU)
+    uint32_t links_peak;             ///< Nombre maximal de liens ouverts simultanément
+    uint32_t sse_events;             ///< Évènements SSE mis en file (par lien)
+    uint32_t sse_dropped;            ///< Évènements SSE abandonnés (file du lien pleine)
+    uint32_t rl_client_limited;      ///< Requêtes refusées : limite par client dépassée
+    uint32_t rl_global_limited;      ///< Requêtes refusées : limite globale dépassée
+    uint32_t rl_closed;              ///< Liens fermés au lieu d'une réponse de refus
+    uint32_t udp_rx_datagrams;       ///< Datagrammes UDP reçus complets
+    uint32_t udp_rx_dropped;         ///< Datagrammes UDP abandonnés (file de réception pleine)
+    uint32_t udp_tx_datagrams;       ///< Datagrammes UDP émis
 } esp01_stats_t;
 
+/**
+ * @brief Réponse HTTP envoyée en flux (Transfer-Encoding: chunked).
+ *
+ * @details
+ * Les petits segments sont regroupés dans buf ; un segment plus grand que la
+ * place restante forme un chunk avec le contenu de buf. Chaque vidage passe
+ * par la file d'émission du lien. La première erreur est conservée dans status.
+ */
+typedef struct
+{
+    int conn_id;                              ///< Connexion cible
+    int status_code;                          ///< Code HTTP envoyé
+    char buf[ESP01_HTTP_STREAM_BUF_SIZE];     ///< Octets en attente d'envoi
+    uint16_t len;                             ///< Octets utilisés dans buf
+    uint16_t header_len;                      ///< En-tête HTTP en début de buf (non encore envoyé)
+    uint32_t total;                           ///< Octets de corps écrits
+    uint32_t start;                           ///< Timestamp de début (statistiques)
+    ESP01_Status_t status;                    ///< Premier code d'erreur rencontré
+} esp01_http_stream_t;
+
+/**
+ * @brief Traitement d'une requête au-delà de la limite de débit.
+ */
+typedef enum
+{
+    ESP01_HTTP_RL_REPLY = 0, ///< Réponse constante 429 (client) ou 503 (global), lien conservé
+    ESP01_HTTP_RL_CLOSE      ///< AT+CIPCLOSE immédiat, sans réponse
+} esp01_http_rl_action_t;
+
+/**
+ * @brief Backend flash d'une mise à jour OTA : slot inactif d'un schéma A/B.
+ *
+ * @details
+ * Les offsets sont relatifs au début du slot. erase() et write() peuvent démarrer
+ * une opération asynchrone (HAL_FLASHEx_Erase_IT, HAL_FLASH_Program_IT...) :
+ * busy() indique qu'elle est en cours et le tampon passé à write() reste valide
+ * jusque-là. commit() marque le slot à démarrer au prochain reset ; abort() le
+ * laisse inactif (le slot courant reste celui qui démarre).
+ * Le pilote ne fournit que l'interface : sur une cible hôte, un backend fichier
+ * se résume à fseek()/fwrite() dans write(), busy à NULL et rename() dans commit().
+ */
+typedef struct
+{
+    uint32_t slot_size;                                                                  ///< Taille du slot (image max)
+    uint32_t erase_size;                                                                 ///< Taille d'un bloc effaçable (0 : pas d'effacement)
+    uint16_t write_align;                                                                ///< Alignement des écritures (0 ou 1 : aucun)
+    ESP01_Status_t (*erase)(void *ctx, uint32_t offset);                                 ///< Efface le bloc commençant à offset
+    ESP01_Status_t (*write)(void *ctx, uint32_t offset, const uint8_t *data, size_t len); ///< Programme len octets à offset
+    bool (*busy)(void *ctx);                                                             ///< Opération en cours (NULL : backend synchrone)
+    ESP01_Status_t (*commit)(void *ctx, uint32_t size, uint32_t crc32);                  ///< Image vérifiée : slot à démarrer
+    void (*abort)(void *ctx);                                                            ///< Image rejetée (NULL : rien à faire)
+    void *ctx;                                                                           ///< Contexte du backend
+} esp01_ota_flash_t;
+
+/**
+ * @brief État de la mise à jour OTA.
+ */
+typedef enum
+{
+    ESP01_OTA_IDLE = 0,  ///< Aucune image reçue
+    ESP01_OTA_RECEIVING, ///< Image en cours de réception
+    ESP01_OTA_DONE,      ///< Image vérifiée et validée : redémarrer pour l'exécuter
+    ESP01_OTA_FAILED     ///< Dernière image refusée (slot courant conservé)
+} esp01_ota_state_t;
+
+/**
+ * @brief Callback d'en-tête de réponse du client HTTP (nom et valeur sans espaces).
+ */
+typedef void (*esp01_http_client_header_cb_t)(const char *name, size_t name_len, const char *value, size_t value_len, void *ctx);
+
+/**
+ * @brief Callback de corps de réponse du client HTTP (morceaux dans l'ordre, chunks décodés).
+ */
+typedef void (*esp01_http_client_body_cb_t)(const uint8_t *data, size_t len, void *ctx);
+
+/**
+ * @brief Écrivain du corps d'une requête du client HTTP (envoyé en chunked).
+ * @param out Flux du corps (esp01_http_stream_write/printf, esp01_http_json_init).
+ * @param ctx Contexte applicatif.
+ */
+typedef ESP01_Status_t (*esp01_http_client_writer_t)(esp01_http_stream_t *out, void *ctx);
+
+/**
+ * @brief Requête du client HTTP.
+ */
+typedef struct
+{
+    const char *method;                     ///< "GET", "POST"... (NULL : GET)
+    const char *url;                        ///< "http://hote[:port]/chemin?query"
+    const char *headers;                    ///< En-têtes supplémentaires "Nom: valeur\r\n" (NULL : aucun)
+    const char *content_type;               ///< Type MIME du corps (NULL : aucun en-tête)
+    const void *body;                       ///< Corps en mémoire (Content-Length)
+    size_t body_len;                        ///< Taille du corps en mémoire
+    esp01_http_client_writer_t body_writer; ///< Corps écrit en flux (prioritaire sur body)
+    esp01_http_client_header_cb_t on_header; ///< En-têtes de la réponse (optionnel)
+    esp01_http_client_body_cb_t on_body;    ///< Corps de la réponse (optionnel)
+    void *ctx;                              ///< Contexte passé aux callbacks
+    uint32_t timeout_ms;                    ///< Silence max du serveur (0 : ESP01_HTTP_CLIENT_TIMEOUT_MS)
+} esp01_http_client_req_t;
+
+/**
+ * @brief Résultat d'une requête du client HTTP.
+ */
+typedef struct
+{
+    int status_code;        ///< Code HTTP de la réponse
+    int32_t content_length; ///< Content-Length annoncé (-1 : absent)
+    uint32_t body_len;      ///< Octets de corps reçus
+    bool reused;            ///< Requête envoyée sur la connexion persistante
+    bool keep_alive;        ///< Connexion conservée pour la requête suivante
+} esp01_http_client_resp_t;
+
+/**
+ * @brief Types d'opérations d'un template HTML précompilé.
+ */
+typedef enum
+{
+    ESP01_TPL_OP_END = 0, ///< Fin du template
+    ESP01_TPL_OP_LIT,     ///< Segment littéral (longueur connue à la compilation)
+    ESP01_TPL_OP_VAR,     ///< Valeur dynamique ({{variable}})
+    ESP01_TPL_OP_LOOP,    ///< Début de boucle ({{#liste}})
+    ESP01_TPL_OP_ENDLOOP, ///< Fin de boucle ({{/liste}})
+    ESP01_TPL_OP_INCLUDE  ///< Sous-template (en-tête/pied communs)
+} esp01_tpl_op_type_t;
+
+/**
+ * @brief Opération d'un template précompilé (tableau const, en flash).
+ */
+typedef struct
+{
+    uint8_t type;     ///< Type d'opération (esp01_tpl_op_type_t)
+    uint8_t id;       ///< Identifiant de variable ou de boucle
+    uint16_t len;     ///< Longueur du littéral
+    const void *data; ///< Littéral ou sous-template
+} esp01_tpl_op_t;
+
+/**
+ * @brief Macros de construction d'un template : "<p>{{ip}}</p>" s'écrit
+ *        ESP01_TPL_LIT("<p>"), ESP01_TPL_VAR(VAR_IP), ESP01_TPL_LIT("</p>").
+ *        La longueur des littéraux est calculée par le compilateur (sizeof).
+ */
+#define ESP01_TPL_LIT(str) {ESP01_TPL_OP_LIT, 0, (uint16_t)(sizeof(str) - 1), (str)}
+#define ESP01_TPL_VAR(var_id) {ESP01_TPL_OP_VAR, (var_id), 0, NULL}
+#define ESP01_TPL_LOOP(loop_id) {ESP01_TPL_OP_LOOP, (loop_id), 0, NULL}
+#define ESP01_TPL_ENDLOOP() {ESP01_TPL_OP_ENDLOOP, 0, 0, NULL}
+#define ESP01_TPL_INCLUDE(tpl) {ESP01_TPL_OP_INCLUDE, 0, 0, (tpl)}
+#define ESP01_TPL_END() {ESP01_TPL_OP_END, 0, 0, NULL}
+
+/**
+ * @brief Callback d'écriture d'une variable de template dans le flux.
+ * @param out    Flux de réponse (esp01_http_stream_printf / esp01_http_stream_write).
+ * @param var_id Identifiant de la variable.
+ * @param index  Indice de l'itération de la boucle englobante (0 hors boucle).
+ * @param ctx    Contexte utilisateur.
+ */
+typedef void (*esp01_tpl_var_cb_t)(esp01_http_stream_t *out, uint8_t var_id, uint16_t index, void *ctx);
+
+/**
+ * @brief Callback d'itération d'une boucle de template.
+ * @param loop_id Identifiant de la boucle.
+ * @param index   Indice de l'itération demandée.
+ * @param ctx     Contexte utilisateur.
+ * @return true si l'itération existe (le corps de boucle est rendu), false pour sortir.
+ */
+typedef bool (*esp01_tpl_loop_cb_t)(uint8_t loop_id, uint16_t index, void *ctx);
+
 /* ========================= VARIABLES GLOBALES EXTERNES ========================= */
 extern esp01_route_t g_routes[ESP01_MAX_ROUTES];               ///< Tableau des routes HTTP
 extern int g_route_count;                                      ///< Nombre de routes enregistrées
 extern connection_info_t g_connections[ESP01_MAX_CONNECTIONS]; ///< Tableau des connexions actives
-extern int g_connection_count;                                 ///< Nombre de connexions actives
-extern volatile int g_acc_len;                                 ///< Longueur du buffer accumulateur
-extern char g_accumulator[ESP01_MAX_TOTAL_HTTP];               ///< Buffer accumulateur pour les requêtes
+extern int g_connection_count;                                 ///< Taille de g_connections (ESP01_MAX_CONNECTIONS, pas le nombre de liens actifs)
+extern volatile int g_acc_len;                                 ///< Octets occupés dans l'accumulateur circulaire
+extern char g_accumulator[ESP01_MAX_TOTAL_HTTP];               ///< Accumulateur circulaire du flux RX (trames +IPD, lignes AT)
 extern volatile int g_processing_request;                      ///< Flag de traitement de requête en cours
 extern esp01_stats_t g_stats;                                  ///< Statistiques HTTP
 
@@ -132,9 +573,12 @@ extern esp01_stats_t g_stats;                                  ///< Statistiques
  * | AT+CIPMUX           | esp01_set_multiple_connections      | INUTILE                         | Active/désactive multi-connexion    |
  * | AT+CIPSTATUS        | esp01_http_get_server_status        | INUTILE                         | Statut du serveur HTTP              |
  * | AT+CIPCLOSE         | esp01_http_close_connection         | INUTILE                         | Ferme une connexion HTTP            |
- * | AT+CIPSTART         | (non exposé ici, voir WiFi)         | INUTILE                         | Démarre une connexion TCP           |
+ * | AT+CIPSTART         | esp01_http_client_request           | INUTILE                         | Ouvre le lien sortant du client     |
+ * | AT+CIPSTART="UDP"   | esp01_udp_open                      | INUTILE                         | Ouvre un lien UDP                   |
  * | AT+CIPSEND          | esp01_send_http_response            | INUTILE                         | Envoie une réponse HTTP             |
- * | AT+CIPRECVDATA      | (interne)                           | INUTILE                         | Réception de données HTTP           |
+ * | AT+CIPRECVMODE      | esp01_http_set_passive_recv         | INUTILE                         | Mode de réception actif/passif      |
+ * | AT+CIPRECVDATA      | (interne, mode passif)              | INUTILE                         | Lecture des données reçues          |
+ * | AT+CIPRECVLEN       | (interne, mode passif)              | INUTILE                         | Octets en attente par lien          |
  */
 
 /* ========================= FONCTIONS PRINCIPALES (API HTTP) ========================= */
@@ -179,6 +623,15 @@ ESP01_Status_t esp01_start_server_config(bool multi_conn, uint16_t port, bool ip
  */
 ESP01_Status_t esp01_http_get_server_status(uint8_t *is_server, uint16_t *port);
 
+/**
+ * @brief Active ou désactive le mode de réception passif (AT+CIPRECVMODE).
+ * @param enable true : l'ESP conserve les données reçues, lues par AT+CIPRECVDATA
+ *               au rythme du traitement (contrôle de flux TCP) ; false : mode +IPD classique.
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ * @note  À appeler en mode multi-connexion, avant le démarrage du serveur.
+ */
+ESP01_Status_t esp01_http_set_passive_recv(bool enable);
+
 /* ========================= GESTION DES ROUTES HTTP ========================= */
 /**
  * @brief Efface toutes les routes HTTP.
@@ -193,6 +646,15 @@ void esp01_clear_routes(void);
  */
 ESP01_Status_t esp01_add_route(const char *path, esp01_route_handler_t handler);
 
+/**
+ * @brief Ajoute une route HTTP recevant le corps de la requête par morceaux.
+ * @param path    Chemin de la route.
+ * @param handler Handler appelé une fois le corps entièrement reçu (réponse).
+ * @param on_body Callback appelé pour chaque morceau du corps, au fil des trames reçues.
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ */
+ESP01_Status_t esp01_add_route_stream(const char *path, esp01_route_handler_t handler, esp01_http_body_cb_t on_body);
+
 /**
  * @brief Trouve le handler associé à une route.
  * @param path Chemin de la route.
@@ -200,7 +662,271 @@ ESP01_Status_t esp01_add_route(const char *path, esp01_route_handler_t handler);
  */
 esp01_route_handler_t esp01_find_route_handler(const char *path);
 
+/* ========================= CACHE DE RÉPONSES ========================= */
+/**
+ * @brief Active (ou désactive) le cache des réponses d'une route.
+ * @param path   Chemin de la route (déjà ajoutée).
+ * @param ttl_ms Durée de vie d'une réponse en cache (0 : désactive le cache).
+ * @return ESP01_OK si succès, ESP01_FAIL si la route est inconnue.
+ * @note  Seules les réponses 200 à une requête GET sont conservées, par couple
+ *        chemin + query string. Un cache valide sert la réponse sans appeler le handler.
+ */
+ESP01_Status_t esp01_http_route_set_cache(const char *path, uint32_t ttl_ms);
+
+/**
+ * @brief Invalide les réponses en cache d'une route (toutes query strings).
+ * @param path Chemin de la route, ou NULL pour vider tout le cache.
+ * @note  À appeler quand l'état affiché par la route change (ex: commande reçue).
+ */
+void esp01_http_cache_invalidate(const char *path);
+
+/* ========================= MÉTRIQUES ========================= */
+/**
+ * @brief Ajoute la route de métriques (format texte Prometheus).
+ * @param path Chemin de la route (NULL : "/metrics").
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ * @note  Compteurs et histogrammes de latence par route, compteurs de liens,
+ *        de cache et du pipeline AT+CIPSEND. Rendu en flux, sans tampon intermédiaire.
+ */
+ESP01_Status_t esp01_http_enable_metrics(const char *path);
+
+/* ========================= WEBSOCKET ========================= */
+/**
+ * @brief Ajoute une route WebSocket (poignée de main RFC 6455 sur GET + Upgrade).
+ * @param path     Chemin de la route.
+ * @param on_event Callback des évènements du lien (ouverture, messages, fermeture).
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ * @note  Une requête sans en-têtes Upgrade reçoit une 400.
+ */
+ESP01_Status_t esp01_add_route_ws(const char *path, esp01_ws_cb_t on_event);
+
+/**
+ * @brief Envoie une trame WebSocket (non masquée, non fragmentée) sur un lien.
+ * @param conn_id Lien WebSocket.
+ * @param opcode  ESP01_WS_OP_TEXT, ESP01_WS_OP_BINARY, ESP01_WS_OP_PING...
+ * @param data    Payload.
+ * @param len     Taille (65535 octets max).
+ * @return ESP01_OK si la trame est en file, ESP01_NOT_CONNECTED si le lien n'est pas WebSocket.
+ * @note  La trame part au prochain tour de l'ordonnanceur (esp01_http_loop).
+ */
+ESP01_Status_t esp01_ws_send(int conn_id, uint8_t opcode, const void *data, size_t len);
+
+/**
+ * @brief Envoie un message texte sur un lien WebSocket.
+ * @param conn_id Lien WebSocket.
+ * @param text    Texte terminé par '\0'.
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ */
+ESP01_Status_t esp01_ws_send_text(int conn_id, const char *text);
+
+/**
+ * @brief Envoie un message texte à tous les liens WebSocket ouverts.
+ * @param text Texte terminé par '\0'.
+ * @return Nombre de liens auxquels le message a été confié.
+ */
+int esp01_ws_broadcast_text(const char *text);
+
+/**
+ * @brief Ferme un lien WebSocket (trame Close puis AT+CIPCLOSE).
+ * @param conn_id Lien WebSocket.
+ * @param code    Code de fermeture (1000 : fermeture normale).
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ */
+ESP01_Status_t esp01_ws_close(int conn_id, uint16_t code);
+
+/**
+ * @brief Indique si un lien est un WebSocket ouvert.
+ * @param conn_id Identifiant de connexion.
+ * @return true si le lien est WebSocket et actif.
+ */
+bool esp01_ws_is_open(int conn_id);
+
+/* ========================= SERVER-SENT EVENTS ========================= */
+/**
+ * @brief Ajoute une route Server-Sent Events (flux text/event-stream sur GET).
+ * @param path     Chemin de la route.
+ * @param on_event Callback d'ouverture/fermeture des liens (optionnel).
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ * @note  Le lien reste ouvert : les évènements sont poussés par esp01_sse_send()
+ *        ou esp01_sse_broadcast(), sans nouvelle requête.
+ */
+ESP01_Status_t esp01_add_route_sse(const char *path, esp01_sse_cb_t on_event);
+
+/**
+ * @brief Met un évènement en file sur un lien SSE (sans attente).
+ * @param conn_id Lien SSE.
+ * @param event   Nom de l'évènement ("event:"), NULL pour "message".
+ * @param data    Données (une ligne "data:" par ligne du texte).
+ * @return ESP01_OK si l'évènement est en file, ESP01_BUFFER_OVERFLOW si la file
+ *         du lien est pleine (évènement abandonné), ESP01_NOT_CONNECTED si le
+ *         lien n'est pas SSE.
+ * @note  Chaque évènement reçoit l'identifiant suivant ("id:"), renvoyé par le
+ *        navigateur dans Last-Event-ID à sa reconnexion.
+ */
+ESP01_Status_t esp01_sse_send(int conn_id, const char *event, const char *data);
+
+/**
+ * @brief Met un évènement en file sur tous les liens SSE ouverts (même identifiant).
+ * @param event Nom de l'évènement, NULL pour "message".
+ * @param data  Données.
+ * @return Nombre de liens auxquels l'évènement a été confié.
+ */
+int esp01_sse_broadcast(const char *event, const char *data);
+
+/**
+ * @brief Retourne l'identifiant du dernier évènement SSE émis.
+ * @return Identifiant (0 : aucun évènement depuis le démarrage).
+ */
+uint32_t esp01_sse_last_id(void);
+
+/**
+ * @brief Indique si un lien est un flux SSE ouvert.
+ * @param conn_id Identifiant de connexion.
+ * @return true si le lien est SSE et actif.
+ */
+bool esp01_sse_is_open(int conn_id);
+
+/* ========================= LIMITATION DE DÉBIT ========================= */
+/**
+ * @brief Configure la limitation de débit des requêtes HTTP (seaux à jetons).
+ * @param client_rate  Requêtes par seconde et par adresse IP (0 : pas de limite par client).
+ * @param client_burst Rafale autorisée par client (requêtes).
+ * @param global_rate  Requêtes par seconde, tous clients confondus (0 : pas de limite globale).
+ * @param global_burst Rafale autorisée, tous clients confondus.
+ * @param action       ESP01_HTTP_RL_REPLY (429/503 constante) ou ESP01_HTTP_RL_CLOSE.
+ * @return ESP01_OK si succès, ESP01_INVALID_PARAM si une rafale est nulle.
+ * @note  Vérifiée avant le routage : une requête refusée n'appelle aucun handler et
+ *        coûte au plus un AT+CIPSEND. La limite par client nécessite AT+CIPDINFO=1 ;
+ *        les trames WebSocket et les évènements SSE ne sont pas comptés.
+ */
+ESP01_Status_t esp01_http_set_rate_limit(uint16_t client_rate, uint16_t client_burst, uint16_t global_rate, uint16_t global_burst,
+                                         esp01_http_rl_action_t action);
+
+/* ========================= MISE À JOUR OTA ========================= */
+/**
+ * @brief Ajoute la route de mise à jour OTA (POST ou PUT du binaire de l'image).
+ * @param path  Chemin de la route (NULL : "/ota").
+ * @param flash Backend du slot inactif (doit rester valide).
+ * @return ESP01_OK si succès, ESP01_INVALID_PARAM si le backend est incomplet.
+ * @note  L'en-tête X-Firmware-CRC32 (hexadécimal) est obligatoire, ex :
+ *        curl --data-binary @fw.bin -H "X-Firmware-CRC32: $(crc32 fw.bin)" http://carte/ota
+ *        Le corps est écrit au fil des trames : le mode de réception passif
+ *        (AT+CIPRECVMODE=1) évite de perdre des octets pendant un effacement.
+ *        Réponse JSON : 200, 400 (CRC), 409 (autre image en cours), 413 (trop grande).
+ */
+ESP01_Status_t esp01_http_enable_ota(const char *path, const esp01_ota_flash_t *flash);
+
+/**
+ * @brief Retourne l'état de la mise à jour OTA.
+ * @param received Octets reçus de l'image (NULL : ignoré).
+ * @param total    Taille annoncée (NULL : ignoré).
+ * @return État courant ; ESP01_OTA_DONE : redémarrer après l'envoi de la réponse.
+ */
+esp01_ota_state_t esp01_http_ota_state(uint32_t *received, uint32_t *total);
+
+/* ========================= FICHIERS (STOCKAGE EXTERNE) ========================= */
+/**
+ * @brief Sert les fichiers d'un stockage externe sous un préfixe de chemin.
+ * @param prefix  Préfixe sans '/' final (ex: "/files" sert "/files/log.csv" comme "log.csv").
+ * @param storage Backend de stockage (doit rester valide).
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ * @note  GET et HEAD ; un en-tête Range à intervalle unique donne une 206
+ *        (hors du fichier : 416), plusieurs intervalles le fichier entier. Le
+ *        fichier est lu par blocs de ESP01_HTTP_FILE_CHUNK au rythme de la file
+ *        d'émission : sa taille n'est pas limitée par ESP01_MAX_TOTAL_HTTP.
+ */
+ESP01_Status_t esp01_http_add_route_files(const char *prefix, const esp01_http_storage_t *storage);
+
+/* ========================= CLIENT HTTP ========================= */
+/**
+ * @brief Envoie une requête HTTP/1.1 et reçoit la réponse (bloquant).
+ * @param req  Requête (méthode, URL, en-têtes, corps ou écrivain de corps, callbacks).
+ * @param resp Résultat (code, taille, réutilisation de la connexion).
+ * @return ESP01_OK si une réponse complète a été reçue (quel que soit son code HTTP),
+ *         ESP01_CONNECTION_ERROR si AT+CIPSTART échoue, ESP01_TIMEOUT, ESP01_NOT_CONNECTED
+ *         si le serveur ferme avant la fin, ESP01_PARSE_ERROR si la réponse est invalide.
+ * @note  Nécessite le mode multi-connexion (AT+CIPMUX=1) : le client occupe un lien libre,
+ *        en partant du dernier. La connexion est conservée (keep-alive) et réutilisée par
+ *        la requête suivante vers le même hôte ; si le serveur l'a fermée entre-temps, la
+ *        requête est renvoyée une fois sur une nouvelle connexion (l'écrivain de corps est
+ *        alors rappelé). Les liens du serveur continuent d'être servis pendant l'attente.
+ *        Les callbacks sont appelés pendant la lecture RX : ils ne doivent pas envoyer.
+ *        HTTP seulement (pas de TLS).
+ */
+ESP01_Status_t esp01_http_client_request(const esp01_http_client_req_t *req, esp01_http_client_resp_t *resp);
+
+/**
+ * @brief Ferme la connexion persistante du client HTTP.
+ * @return ESP01_OK si succès (ou aucune connexion), code d'erreur sinon.
+ */
+ESP01_Status_t esp01_http_client_close(void);
+
+/* ========================= SOCKETS UDP ========================= */
+/**
+ * @brief Ouvre un lien UDP (AT+CIPSTART=<lien>,"UDP",...).
+ * @param remote_host Destination par défaut (adresse ou nom ; "0.0.0.0" pour seulement écouter).
+ * @param remote_port Port de destination par défaut.
+ * @param local_port  Port local d'écoute (0 : choisi par l'ESP01, mode ignoré).
+ * @param mode        Filtrage de l'émetteur (ESP01_UDP_PEER_ANY pour recevoir de plusieurs émetteurs).
+ * @param on_datagram Callback de réception (NULL : datagrammes ignorés).
+ * @param link        Lien attribué (sortie).
+ * @return ESP01_OK si succès, ESP01_CONNECTION_ERROR si AT+CIPSTART échoue.
+ * @note  Nécessite le mode multi-connexion (AT+CIPMUX=1) et la réception active ; le lien
+ *        est pris en partant du dernier, comme le client HTTP, et n'expire jamais. Chaque
+ *        trame +IPD du lien est un datagramme, livré entier par esp01_http_loop.
+ */
+ESP01_Status_t esp01_udp_open(const char *remote_host, uint16_t remote_port, uint16_t local_port, esp01_udp_mode_t mode,
+                              esp01_udp_cb_t on_datagram, int *link);
+
+/**
+ * @brief Émet un datagramme vers la destination du lien (sans attendre "SEND OK").
+ * @param link Lien UDP.
+ * @param data Contenu.
+ * @param len  Taille (1..ESP01_MAX_SEND_LEN).
+ * @return ESP01_OK dès que le datagramme est transmis à l'ESP01.
+ */
+ESP01_Status_t esp01_udp_send(int link, const void *data, size_t len);
+
+/**
+ * @brief Émet un datagramme vers une destination donnée (réponse à un émetteur, diffusion).
+ * @param link        Lien UDP.
+ * @param remote_ip   Adresse de destination.
+ * @param remote_port Port de destination.
+ * @param data        Contenu.
+ * @param len         Taille (1..ESP01_MAX_SEND_LEN).
+ * @return ESP01_OK dès que le datagramme est transmis à l'ESP01.
+ */
+ESP01_Status_t esp01_udp_send_to(int link, const char *remote_ip, uint16_t remote_port, const void *data, size_t len);
+
+/**
+ * @brief Ferme un lien UDP (les datagrammes reçus non livrés sont abandonnés).
+ * @param link Lien UDP.
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ */
+ESP01_Status_t esp01_udp_close(int link);
+
+/**
+ * @brief Indique si un lien UDP est ouvert.
+ * @param link Lien.
+ * @return true si le lien est un lien UDP ouvert.
+ */
+bool esp01_udp_is_open(int link);
+
 /* ========================= GESTION DES CONNEXIONS HTTP ========================= */
+/**
+ * @brief Configure la durée de vie des liens (appliquée par esp01_http_loop()).
+ * @param idle_timeout_ms      Silence max d'un lien (défaut 30000, 0 : pas de limite).
+ * @param keepalive_timeout_ms Attente max de la requête suivante après une réponse (0 : pas de limite).
+ * @param reserve              Liens à garder libres : au-delà, le lien inactif le moins
+ *                             récemment utilisé est fermé (0 : pas d'éviction).
+ * @return ESP01_OK si succès, ESP01_INVALID_PARAM si reserve >= ESP01_MAX_CONNECTIONS.
+ * @note  Seuls les liens sans requête, réponse ni trame en cours sont évincés ou fermés
+ *        en keep-alive ; les liens WebSocket, SSE et le lien du client HTTP ne le sont
+ *        jamais. Un idle_timeout_ms inférieur à ESP01_WS_PING_INTERVAL_MS ferme les
+ *        WebSocket silencieux avant leur ping.
+ */
+ESP01_Status_t esp01_http_set_link_policy(uint32_t idle_timeout_ms, uint32_t keepalive_timeout_ms, uint8_t reserve);
+
 /**
  * @brief Retourne le nombre de connexions actives.
  * @return Nombre de connexions actives.
@@ -247,8 +973,129 @@ void esp01_print_connection_status(void);
  */
 ESP01_Status_t esp01_parse_http_request(const char *raw_request, http_parsed_request_t *parsed);
 
+/**
+ * @brief Initialise (ou réinitialise) un parseur HTTP incrémental.
+ * @param parser  Parseur à initialiser.
+ * @param conn_id Identifiant de connexion associé.
+ * @param on_body Callback de réception du corps (NULL pour ignorer le corps).
+ */
+void esp01_http_parser_init(esp01_http_parser_t *parser, int conn_id, esp01_http_body_cb_t on_body);
+
+/**
+ * @brief Prépare le parseur pour la requête suivante (conserve conn_id et on_body).
+ * @param parser Parseur à réarmer.
+ */
+void esp01_http_parser_reset(esp01_http_parser_t *parser);
+
+/**
+ * @brief Alimente le parseur avec de nouveaux octets.
+ * @param parser Parseur.
+ * @param data   Octets reçus (payload +IPD).
+ * @param len    Nombre d'octets.
+ * @return Nombre d'octets consommés. S'arrête à la fin des en-têtes (état
+ *         HTTP_PARSER_BODY, pour choisir le callback du corps) et à la fin de la
+ *         requête (état HTTP_PARSER_COMPLETE) : les octets restants appartiennent
+ *         à la requête suivante.
+ */
+size_t esp01_http_parser_feed(esp01_http_parser_t *parser, const uint8_t *data, size_t len);
+
+/**
+ * @brief Recherche un en-tête dans une requête parsée (lecture à la demande).
+ * @param req       Requête parsée.
+ * @param name      Nom de l'en-tête (insensible à la casse, ex: "Host").
+ * @param value_len Longueur de la valeur trouvée (optionnel).
+ * @return Pointeur vers la valeur (non terminée par '\0'), ou NULL si absent.
+ */
+const char *esp01_http_get_header(const http_parsed_request_t *req, const char *name, size_t *value_len);
+
+/**
+ * @brief Copie la valeur d'un en-tête dans un buffer terminé par '\0'.
+ * @param req      Requête parsée.
+ * @param name     Nom de l'en-tête.
+ * @param out      Buffer de sortie.
+ * @param out_size Taille du buffer.
+ * @return ESP01_OK si trouvé, ESP01_FAIL si absent, ESP01_BUFFER_OVERFLOW si trop long.
+ */
+ESP01_Status_t esp01_http_copy_header(const http_parsed_request_t *req, const char *name, char *out, size_t out_size);
+
+/**
+ * @brief Initialise un itérateur clé/valeur (query string ou corps urlencodé).
+ * @param it   Itérateur.
+ * @param data Données (clé=valeur&...), non modifiées.
+ * @param len  Taille des données.
+ */
+void esp01_http_kv_iter_init(esp01_http_kv_iter_t *it, const char *data, size_t len);
+
+/**
+ * @brief Avance sur la paire suivante (sans copie ni allocation).
+ * @param it Itérateur.
+ * @param kv Paire de sortie (vues dans les données).
+ * @return true si une paire a été trouvée, false en fin de données.
+ */
+bool esp01_http_kv_next(esp01_http_kv_iter_t *it, esp01_http_kv_t *kv);
+
+/**
+ * @brief Recherche une clé (comparaison après décodage, sans copie).
+ * @param data Données (clé=valeur&...).
+ * @param len  Taille des données.
+ * @param key  Clé recherchée, en clair.
+ * @param kv   Paire trouvée (optionnel).
+ * @return true si la clé est présente.
+ */
+bool esp01_http_kv_find(const char *data, size_t len, const char *key, esp01_http_kv_t *kv);
+
+/**
+ * @brief Compare une portion urlencodée à une chaîne en clair (décodage à la volée).
+ * @param src   Portion encodée (clé ou valeur).
+ * @param len   Taille de la portion.
+ * @param plain Chaîne en clair.
+ * @return true si égales.
+ */
+bool esp01_http_kv_equals(const char *src, size_t len, const char *plain);
+
+/**
+ * @brief Décode une portion urlencodée (%XX, '+') dans un buffer terminé par '\0'.
+ * @param src      Portion encodée.
+ * @param len      Taille de la portion.
+ * @param out      Buffer de sortie.
+ * @param out_size Taille du buffer.
+ * @return ESP01_OK si succès, ESP01_BUFFER_OVERFLOW si tronqué.
+ */
+ESP01_Status_t esp01_http_kv_decode(const char *src, size_t len, char *out, size_t out_size);
+
+/**
+ * @brief Extrait un champ d'un corps application/x-www-form-urlencoded.
+ * @param data     Données (clé=valeur&...), non nécessairement terminées par '\0'.
+ * @param len      Taille des données.
+ * @param key      Clé recherchée.
+ * @param out      Buffer de sortie (valeur décodée, terminée par '\0').
+ * @param out_size Taille du buffer.
+ * @return ESP01_OK si trouvé, ESP01_FAIL si absent, ESP01_BUFFER_OVERFLOW si trop long.
+ */
+ESP01_Status_t esp01_http_form_get(const char *data, size_t len, const char *key, char *out, size_t out_size);
+
+/**
+ * @brief Extrait un champ de premier niveau d'un objet JSON.
+ * @param json     Texte JSON, non nécessairement terminé par '\0'.
+ * @param len      Taille du texte.
+ * @param key      Clé recherchée.
+ * @param out      Buffer de sortie : chaîne désescapée, ou texte brut du nombre/booléen/objet.
+ * @param out_size Taille du buffer.
+ * @return ESP01_OK si trouvé, ESP01_FAIL si absent, ESP01_PARSE_ERROR si JSON invalide,
+ *         ESP01_BUFFER_OVERFLOW si trop long.
+ */
+ESP01_Status_t esp01_http_json_get(const char *json, size_t len, const char *key, char *out, size_t out_size);
+
 /**
  * @brief Traite automatiquement les requêtes HTTP reçues.
+ *
+ * @details
+ * Un tour de l'ordonnanceur : lecture du flux RX (trames +IPD, SEND OK,
+ * n,CONNECT/n,CLOSED), puis pour chaque lien à tour de rôle au plus une
+ * requête routée et un segment de sa file d'émission envoyé. Les handlers
+ * écrivent leurs réponses dans la file du lien ; pendant l'envoi d'une grosse
+ * page, les files des autres liens continuent de partir. Les handlers ne sont
+ * jamais imbriqués : une requête prête attend le retour du handler en cours.
  */
 void esp01_process_requests(void);
 
@@ -265,6 +1112,84 @@ void esp01_process_requests(void);
 ESP01_Status_t esp01_send_http_response(int conn_id, int status_code, const char *content_type,
                                         const char *body, size_t body_len);
 
+/**
+ * @brief Attend que la file d'émission d'un lien soit entièrement envoyée.
+ * @param conn_id Identifiant de connexion.
+ * @return ESP01_OK si la file est vide, code d'erreur sinon (lien fermé, timeout).
+ * @note  Les files des autres liens continuent de partir pendant l'attente
+ *        (aucun autre handler n'est appelé).
+ */
+ESP01_Status_t esp01_http_flush(int conn_id);
+
+/* ========================= RÉPONSES EN FLUX & TEMPLATES ========================= */
+/**
+ * @brief Démarre une réponse en flux (Transfer-Encoding: chunked).
+ * @param stream       Flux à initialiser.
+ * @param conn_id      Identifiant de connexion.
+ * @param status_code  Code HTTP.
+ * @param content_type Type MIME.
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ */
+ESP01_Status_t esp01_http_stream_begin(esp01_http_stream_t *stream, int conn_id, int status_code, const char *content_type);
+
+/**
+ * @brief Écrit des octets dans le flux (copiés s'ils tiennent, envoyés directement sinon).
+ * @param stream Flux.
+ * @param data   Données.
+ * @param len    Taille.
+ * @return ESP01_OK si succès, première erreur du flux sinon.
+ */
+ESP01_Status_t esp01_http_stream_write(esp01_http_stream_t *stream, const char *data, size_t len);
+
+/**
+ * @brief Écrit une valeur formatée dans le flux (taille max ESP01_HTTP_STREAM_BUF_SIZE).
+ * @param stream Flux.
+ * @param fmt    Format printf.
+ * @return ESP01_OK si succès, première erreur du flux sinon.
+ */
+ESP01_Status_t esp01_http_stream_printf(esp01_http_stream_t *stream, const char *fmt, ...);
+
+/**
+ * @brief Termine la réponse en flux (dernier segment et chunk final).
+ * @param stream Flux.
+ * @return ESP01_OK si succès, première erreur du flux sinon.
+ */
+ESP01_Status_t esp01_http_stream_end(esp01_http_stream_t *stream);
+
+/**
+ * @brief Initialise un écrivain JSON qui écrit directement dans une réponse en flux.
+ * @param w      Écrivain JSON.
+ * @param stream Flux démarré (esp01_http_stream_begin, type "application/json").
+ * @note  Terminer par esp01_json_finish() puis esp01_http_stream_end().
+ */
+void esp01_http_json_init(esp01_json_writer_t *w, esp01_http_stream_t *stream);
+
+/**
+ * @brief Rend un template précompilé dans un flux.
+ * @param stream  Flux de réponse démarré.
+ * @param tpl     Template (tableau terminé par ESP01_TPL_END()).
+ * @param var_cb  Callback des variables (NULL si aucune).
+ * @param loop_cb Callback des boucles (NULL si aucune).
+ * @param ctx     Contexte utilisateur transmis aux callbacks.
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ */
+ESP01_Status_t esp01_tpl_render(esp01_http_stream_t *stream, const esp01_tpl_op_t *tpl,
+                                esp01_tpl_var_cb_t var_cb, esp01_tpl_loop_cb_t loop_cb, void *ctx);
+
+/**
+ * @brief Envoie une page rendue depuis un template (begin + render + end).
+ * @param conn_id      Identifiant de connexion.
+ * @param status_code  Code HTTP.
+ * @param content_type Type MIME.
+ * @param tpl          Template précompilé.
+ * @param var_cb       Callback des variables (NULL si aucune).
+ * @param loop_cb      Callback des boucles (NULL si aucune).
+ * @param ctx          Contexte utilisateur.
+ * @return ESP01_OK si succès, code d'erreur sinon.
+ */
+ESP01_Status_t esp01_http_send_template(int conn_id, int status_code, const char *content_type, const esp01_tpl_op_t *tpl,
+                                        esp01_tpl_var_cb_t var_cb, esp01_tpl_loop_cb_t loop_cb, void *ctx);
+
 /**
  * @brief Envoie une réponse JSON.
  * @param conn_id   Identifiant de connexion.
@@ -40,6 +40,9 @@
 #define MQTT_HEADER_CONNACK 0x20     // Paquet MQTT CONNACK
 #define MQTT_HEADER_PUBLISH 0x30     // Paquet MQTT PUBLISH
 #define MQTT_HEADER_PUBACK 0x40      // Paquet MQTT PUBACK
+#define MQTT_HEADER_PUBREC 0x50      // Paquet MQTT PUBREC (QoS 2, étape 1)
+#define MQTT_HEADER_PUBREL 0x62      // Paquet MQTT PUBREL (QoS 2, étape 2)
+#define MQTT_HEADER_PUBCOMP 0x70     // Paquet MQTT PUBCOMP (QoS 2, étape 3)
 #define MQTT_HEADER_SUBSCRIBE 0x82   // Paquet MQTT SUBSCRIBE
 #define MQTT_HEADER_SUBACK 0x90      // Paquet MQTT SUBACK
 #define MQTT_HEADER_UNSUBSCRIBE 0xA2 // Paquet MQTT UNSUBSCRIBE
@@ -53,12 +56,187 @@
 #define MQTT_FLAG_WILL_RETAIN 0x20   // Flag will retain
 #define MQTT_FLAG_USERNAME 0x80      // Flag username
 #define MQTT_FLAG_PASSWORD 0x40      // Flag password
+#define MQTT_FLAG_DUP 0x08           // Flag DUP d'un PUBLISH renvoyé
 #define ESP01_MQTT_MAX_PACKET_SIZE 2048
+#define MQTT_FIXED_HEADER_MAX 5            // Type + longueur restante sur 4 octets max
+#define MQTT_MAX_REMAINING_LEN 268435455UL // Longueur restante max (4 octets de 7 bits)
+#define MQTT_PUBLISH_MAX_PARTS 4           // En-tête, topic, packet ID, payload
+#define MQTT_CTRL_QUEUE_SIZE (ESP01_MQTT_MAX_INFLIGHT + ESP01_MQTT_QOS2_RX_SLOTS) // Acquittements en attente d'émission
+#define MQTT_Q_REC_HDR 5                   // Enregistrement de file : longueur (2), flags (1), taille du topic (2)
+#define MQTT_Q_FLAG_DEAD 0x80              // Enregistrement remplacé par un plus récent (coalescence)
+#define MQTT_IPD_HEADER_MAX 16             // "\r\n+IPD,<lien>,<taille>:" max
+#define MQTT_IPD_PAYLOAD_MAX 1460          // Payload max d'une trame +IPD (un segment TCP, MSS de l'ESP01)
+#define MQTT_ACC_SIZE (MQTT_IPD_HEADER_MAX + MQTT_IPD_PAYLOAD_MAX + ESP01_MAX_LINE_BUF) // Trame complète + ligne AT qui la suit
 // ==================== VARIABLES GLOBALES ====================
 mqtt_client_t g_mqtt_client = {0};                    // Instance globale du client MQTT
+esp01_mqtt_stats_t g_mqtt_stats = {0};                // Statistiques de publication
 static mqtt_message_callback_t g_mqtt_cb = NULL;      // Callback utilisateur pour réception de messages
-static uint8_t g_mqtt_accumulator[ESP01_MAX_CMD_BUF]; // Buffer d'accumulation pour messages MQTT
+static uint8_t g_mqtt_accumulator[MQTT_ACC_SIZE + 1]; // Buffer d'accumulation pour messages MQTT (+ '\0')
 static uint16_t g_mqtt_acc_len = 0;                   // Longueur actuelle de l'accumulateur MQTT
+static uint32_t g_mqtt_acc_skip = 0;                  // Octets restants d'une trame +IPD trop grande, ignorés
+
+/**
+ * @brief  Message QoS 1/2 en attente d'acquittement (topic et payload copiés dans g_mqtt_pool).
+ */
+typedef struct
+{
+    uint16_t packet_id; // Packet ID (0 : acquitté, place libérée dans l'ordre)
+    uint16_t off;       // Index du topic dans g_mqtt_pool (payload à la suite)
+    uint16_t topic_len; // Longueur du topic
+    uint16_t len;       // Taille du payload
+    uint8_t header;     // Premier octet du PUBLISH (DUP ajouté aux renvois)
+    uint8_t retries;    // Renvois effectués
+    bool released;      // QoS 2 : PUBREC reçu, PUBREL émis, PUBCOMP attendu
+    uint32_t sent_at;   // HAL_GetTick() du dernier envoi
+} _mqtt_inflight_t;
+
+/**
+ * @brief  Acquittement à émettre hors du traitement des trames (PUBACK, PUBREC, PUBREL, PUBCOMP).
+ */
+typedef struct
+{
+    uint8_t type;       // Premier octet du paquet
+    uint16_t packet_id; // Packet ID acquitté
+} _mqtt_ctrl_t;
+
+static uint8_t g_mqtt_pool[ESP01_MQTT_INFLIGHT_POOL_SIZE];        // Topics et payloads non acquittés, pool circulaire
+static _mqtt_inflight_t g_mqtt_inflight[ESP01_MQTT_MAX_INFLIGHT]; // Messages, du plus ancien au plus récent
+static uint8_t g_mqtt_if_first = 0;                               // Message le plus ancien
+static uint8_t g_mqtt_if_count = 0;                               // Entrées utilisées (acquittées comprises)
+static uint8_t g_mqtt_if_pending = 0;                             // Messages non acquittés
+static uint8_t g_mqtt_window = ESP01_MQTT_MAX_INFLIGHT;           // Messages non acquittés max
+static uint32_t g_mqtt_retry_ms = ESP01_MQTT_RETRY_MS;            // Délai avant renvoi (0 : à la reconnexion seulement)
+static uint16_t g_mqtt_rx_qos2[ESP01_MQTT_QOS2_RX_SLOTS];         // Packet IDs QoS 2 reçus, PUBREL attendu (0 : libre)
+static _mqtt_ctrl_t g_mqtt_ctrl[MQTT_CTRL_QUEUE_SIZE];            // Acquittements à émettre, file circulaire
+static uint8_t g_mqtt_ctrl_first = 0;                             // Acquittement le plus ancien
+static uint8_t g_mqtt_ctrl_count = 0;                             // Acquittements en attente
+static uint8_t g_mqtt_q_buf[ESP01_MQTT_OFFLINE_QUEUE_SIZE];       // File hors ligne en RAM, enregistrements circulaires
+static uint32_t g_mqtt_q_head = 0;                                // Premier octet de l'enregistrement le plus ancien
+static uint32_t g_mqtt_q_used = 0;                                // Octets occupés (enregistrements remplacés compris)
+static uint32_t g_mqtt_q_depth = 0;                               // Messages en file
+static uint8_t g_mqtt_q_out[ESP01_MQTT_OFFLINE_CHUNK];            // Partie de l'enregistrement en cours de republication
+static esp01_mqtt_queue_policy_t g_mqtt_q_policy = ESP01_MQTT_QUEUE_DROP_OLDEST; // Politique de la file hors ligne
+static const esp01_mqtt_queue_backend_t *g_mqtt_q_backend = NULL;              // Stockage externe (NULL : RAM)
+static uint8_t g_mqtt_rx_pkt[ESP01_MQTT_RX_PACKET_MAX]; // Paquet reçu à cheval sur plusieurs trames +IPD
+static uint32_t g_mqtt_rx_pkt_len = 0;                  // Octets déjà reçus de ce paquet
+static uint32_t g_mqtt_rx_skip = 0;                     // Octets restants d'un paquet trop grand, ignorés
+
+static void _mqtt_rx_pump(void);             // Lecture RX (accumulateur + lignes AT)
+static void _mqtt_process_frames(void);      // Traitement des trames +IPD complètes (PUBACK, PUBLISH)
+static void _mqtt_inflight_resend(bool all); // Renvoi des messages QoS 1/2 non acquittés
+
+// ==================== ENCODAGE DES PAQUETS ====================
+/**
+ * @brief  Encode la longueur restante d'un paquet MQTT (7 bits par octet, bit 7 : octet suivant).
+ * @param  len Longueur restante (max MQTT_MAX_REMAINING_LEN).
+ * @param  out Buffer de sortie (4 octets).
+ * @return Nombre d'octets écrits (1 à 4).
+ */
+static uint8_t _mqtt_encode_remaining(uint32_t len, uint8_t *out)
+{
+    uint8_t n = 0;
+    do
+    {
+        uint8_t byte = len & 0x7F;
+        len >>= 7;
+        out[n++] = len ? (byte | 0x80) : byte;
+    } while (len && n < 4);
+    return n;
+}
+
+/**
+ * @brief  Décode l'en-tête fixe d'un paquet MQTT reçu.
+ * @param  data      Début du paquet.
+ * @param  avail     Octets disponibles.
+ * @param  remaining Longueur restante (sortie).
+ * @return Taille de l'en-tête fixe (2 à 5), 0 si incomplet, -1 si la longueur est invalide.
+ */
+static int _mqtt_decode_header(const uint8_t *data, uint32_t avail, uint32_t *remaining)
+{
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        if (1u + i >= avail) // Longueur incomplète
+        {
+            return 0;
+        }
+        uint8_t byte = data[1 + i];
+        value |= (uint32_t)(byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80))
+        {
+            *remaining = value;
+            return 2 + i;
+        }
+    }
+    return -1; // Plus de 4 octets de longueur
+}
+
+/**
+ * @brief  Écrit l'en-tête fixe juste avant un corps construit à partir de MQTT_FIXED_HEADER_MAX.
+ * @param  buf  Buffer du paquet (corps à partir de l'index MQTT_FIXED_HEADER_MAX).
+ * @param  type Premier octet (type et flags).
+ * @param  end  Fin du corps dans buf.
+ * @return Index du premier octet du paquet dans buf.
+ */
+static uint16_t _mqtt_prepend_header(uint8_t *buf, uint8_t type, uint16_t end)
+{
+    uint8_t len_bytes[4];
+    uint8_t n = _mqtt_encode_remaining(end - MQTT_FIXED_HEADER_MAX, len_bytes);
+    uint16_t start = MQTT_FIXED_HEADER_MAX - 1 - n;
+    buf[start] = type;
+    memcpy(buf + start + 1, len_bytes, n);
+    return start;
+}
+
+/**
+ * @brief  Émet un paquet MQTT à partir de segments, sans recopie.
+ * @param  parts Segments du paquet dans l'ordre (MQTT_PUBLISH_MAX_PARTS max).
+ * @param  count Nombre de segments.
+ * @return ESP01_Status_t Code de retour.
+ * @note   Le flux TCP ignore les limites des paquets : au-delà de ESP01_MAX_SEND_LEN,
+ *         le paquet continue dans l'AT+CIPSEND suivant (pipeline, sans attendre "SEND OK").
+ */
+static ESP01_Status_t _mqtt_send_parts(const esp01_tx_part_t *parts, int count)
+{
+    esp01_tx_part_t seg[MQTT_PUBLISH_MAX_PARTS]; // Segments d'un AT+CIPSEND
+    int part = 0;                                // Segment source en cours
+    size_t off = 0;                              // Octets déjà émis de ce segment
+    while (part < count)
+    {
+        int n = 0;
+        size_t room = ESP01_MAX_SEND_LEN; // Place dans cet AT+CIPSEND
+        while (part < count && room > 0 && n < MQTT_PUBLISH_MAX_PARTS)
+        {
+            size_t take = parts[part].len - off;
+            if (take > room)
+            {
+                take = room;
+            }
+            if (take > 0)
+            {
+                seg[n].data = (const uint8_t *)parts[part].data + off;
+                seg[n++].len = take;
+                room -= take;
+                off += take;
+            }
+            if (off == parts[part].len) // Segment source terminé
+            {
+                part++;
+                off = 0;
+            }
+        }
+        if (n == 0) // Segments restants vides
+        {
+            break;
+        }
+        ESP01_Status_t status = esp01_send_submit(-1, seg, n, _mqtt_rx_pump); // N'attend pas "SEND OK" : confirmé pendant les appels suivants
+        if (status != ESP01_OK)
+        {
+            return status;
+        }
+    }
+    return ESP01_OK;
+}
 
 // ==================== CONNEXION MQTT ====================
 /**
@@ -78,6 +256,9 @@ ESP01_Status_t esp01_mqtt_connect(const char *broker_ip, uint16_t port, const ch
     char cmd[ESP01_MAX_CMD_BUF], resp[ESP01_MAX_RESP_BUF]; // Buffers pour commandes et réponses
     ESP01_Status_t status;                                 // Statut de retour
 
+    g_mqtt_rx_pkt_len = 0; // Nouveau flux TCP : paquet partiel de l'ancienne connexion abandonné
+    g_mqtt_rx_skip = 0;
+
     // Ouvre une connexion TCP vers le broker MQTT
     snprintf(cmd, sizeof(cmd), "AT+CIPSTART=\"TCP\",\"%s\",%u", broker_ip, port);             // Prépare la commande AT+CIPSTART
     status = esp01_send_raw_command_dma(cmd, resp, sizeof(resp), "OK", ESP01_TIMEOUT_MEDIUM); // Envoie la commande
@@ -89,13 +270,13 @@ ESP01_Status_t esp01_mqtt_connect(const char *broker_ip, uint16_t port, const ch
 
     // Construction du paquet MQTT CONNECT
     uint8_t mqtt_packet[ESP01_MAX_CMD_BUF]; // Buffer pour le paquet CONNECT
-    uint16_t mqtt_len = 0;                  // Taille du paquet MQTT
+    uint16_t mqtt_len = MQTT_FIXED_HEADER_MAX; // Corps après la place de l'en-tête fixe
 
-    // En-tête
-    mqtt_packet[mqtt_len++] = MQTT_HEADER_CONNECT;
-
-    // Position pour la longueur variable (à remplir plus tard)
-    uint16_t len_pos = mqtt_len++;
+    size_t need = MQTT_FIXED_HEADER_MAX + 10 + 2 + strlen(client_id) + (username ? 2 + strlen(username) : 0) + (password ? 2 + strlen(password) : 0);
+    if (need > sizeof(mqtt_packet)) // Identifiants trop longs
+    {
+        ESP01_RETURN_ERROR("MQTT_CONNECT", ESP01_BUFFER_OVERFLOW);
+    }
 
     // Protocole "MQTT"
     mqtt_packet[mqtt_len++] = 0x00;
@@ -107,7 +288,7 @@ ESP01_Status_t esp01_mqtt_connect(const char *broker_ip, uint16_t port, const ch
     mqtt_packet[mqtt_len++] = MQTT_PROTOCOL_VERSION;
 
     // Flags
-    uint8_t connect_flags = MQTT_FLAG_CLEAN_SESSION;
+    uint8_t connect_flags = g_mqtt_client.persistent_session ? 0 : MQTT_FLAG_CLEAN_SESSION; // Session persistante : état QoS 2 repris par le broker
     if (username != NULL && strlen(username) > 0)
         connect_flags |= MQTT_FLAG_USERNAME;
     if (password != NULL && strlen(password) > 0)
@@ -145,8 +326,9 @@ ESP01_Status_t esp01_mqtt_connect(const char *broker_ip, uint16_t port, const ch
         mqtt_len += password_len;
     }
 
-    // Longueur restante
-    mqtt_packet[len_pos] = mqtt_len - 2;
+    // En-tête fixe (longueur restante multi-octets)
+    uint16_t pkt_start = _mqtt_prepend_header(mqtt_packet, MQTT_HEADER_CONNECT, mqtt_len);
+    mqtt_len -= pkt_start;
 
     // Préparation de l'envoi CIPSEND
     snprintf(cmd, sizeof(cmd), "AT+CIPSEND=%u", mqtt_len);                                  // Prépare la commande AT+CIPSEND
@@ -157,10 +339,10 @@ ESP01_Status_t esp01_mqtt_connect(const char *broker_ip, uint16_t port, const ch
     ESP01_LOG_DEBUG("MQTT", "Envoi du paquet CONNECT (%d octets)", mqtt_len); // Log l'envoi du paquet
     for (int i = 0; i < mqtt_len; i++)
     {
-        ESP01_LOG_DEBUG("MQTT", ">>> TX[%03d]: %02X", i, mqtt_packet[i]); // Log chaque octet envoyé
+        ESP01_LOG_DEBUG("MQTT", ">>> TX[%03d]: %02X", i, mqtt_packet[pkt_start + i]); // Log chaque octet envoyé
     }
 
-    HAL_UART_Transmit(g_esp_uart, mqtt_packet, mqtt_len, HAL_MAX_DELAY); // Envoie le paquet CONNECT
+    esp01_uart_write(mqtt_packet + pkt_start, mqtt_len); // Envoie le paquet CONNECT
 
     status = esp01_wait_for_pattern("SEND OK", ESP01_TIMEOUT_SHORT); // Attend l'accusé d'envoi
     if (status != ESP01_OK)
@@ -255,8 +437,17 @@ ESP01_Status_t esp01_mqtt_connect(const char *broker_ip, uint16_t port, const ch
         g_mqtt_client.broker_port = port;                                                       // Sauvegarde le port
         esp01_safe_strcpy(g_mqtt_client.client_id, sizeof(g_mqtt_client.client_id), client_id); // Sauvegarde le client ID (sécurisé)
         g_mqtt_client.keep_alive = ESP01_MQTT_KEEPALIVE_DEFAULT;                                // Keepalive par défaut
-        g_mqtt_client.packet_id = 1;                                                            // Réinitialise le packet ID
+        if (g_mqtt_if_pending == 0)                                                             // Packet IDs des messages non acquittés conservés
+        {
+            g_mqtt_client.packet_id = 1;                                                        // Réinitialise le packet ID
+        }
         ESP01_LOG_DEBUG("MQTT", "=== Connexion établie avec succès ===");                       // Log succès
+        g_mqtt_ctrl_count = 0;                                                                  // Acquittements de l'ancienne connexion : redemandés par le broker
+        if (!g_mqtt_client.persistent_session)                                                  // Session propre : le broker ne renverra pas de PUBREL
+        {
+            memset(g_mqtt_rx_qos2, 0, sizeof(g_mqtt_rx_qos2));
+        }
+        _mqtt_inflight_resend(true);                                                            // Messages non acquittés : PUBLISH (DUP) ou PUBREL renvoyés
     }
     else
     {
@@ -268,304 +459,1236 @@ ESP01_Status_t esp01_mqtt_connect(const char *broker_ip, uint16_t port, const ch
 
 // ==================== PUBLISH MQTT ====================
 /**
- * @brief  Publication d'un message sur un topic.
+ * @brief  Publication d'un message texte sur un topic.
  * @param  topic   Sujet (topic) du message.
- * @param  message Message à publier.
+ * @param  message Message à publier (chaîne terminée par '\0').
  * @param  qos     Qualité de service (0, 1 ou 2).
  * @param  retain  true pour conserver le message sur le broker, false sinon.
  * @return ESP01_Status_t Code de retour.
  */
 ESP01_Status_t esp01_mqtt_publish(const char *topic, const char *message, uint8_t qos, bool retain)
 {
-    ESP01_LOG_DEBUG("MQTT", "Publication sur topic '%s', QoS=%d, retain=%d", topic, qos, retain); // Log la publication
-    VALIDATE_PARAM(topic && message && qos <= 2, ESP01_INVALID_PARAM);                            // Vérifie les paramètres
-    VALIDATE_PARAM(g_mqtt_client.connected, ESP01_FAIL);                                          // Vérifie la connexion
-
-    char cmd[ESP01_MAX_CMD_BUF], resp[ESP01_MAX_RESP_BUF]; // Buffers pour commandes et réponses
-    ESP01_Status_t status;                                 // Statut de retour
-
-    ESP01_LOG_DEBUG("MQTT", "=== Préparation publication ==="); // Log la préparation
-
-    uint8_t mqtt_publish[ESP01_MQTT_MAX_PAYLOAD_LEN]; // Buffer pour le paquet MQTT PUBLISH
-    uint16_t mqtt_len = 0;                            // Taille du paquet MQTT
-
-    mqtt_publish[mqtt_len++] = MQTT_HEADER_PUBLISH | (qos << 1) | (retain ? 1 : 0); // Header PUBLISH
-
-    uint16_t topic_len = strlen(topic);     // Longueur du topic
-    uint16_t message_len = strlen(message); // Longueur du message
-
-    uint16_t var_len = 2 + topic_len; // Longueur variable (topic)
-    if (qos > 0)
-        var_len += 2;       // Ajoute Packet ID si QoS > 0
-    var_len += message_len; // Ajoute la longueur du message
-
-    // Encodage de la longueur variable
-    mqtt_publish[mqtt_len++] = var_len; // Longueur variable
+    VALIDATE_PARAM(message, ESP01_INVALID_PARAM); // Vérifie le message
+    return esp01_mqtt_publish_raw(topic, message, strlen(message), qos, retain);
+}
 
-    // Topic
-    mqtt_publish[mqtt_len++] = (topic_len >> 8) & 0xFF; // Taille topic MSB
-    mqtt_publish[mqtt_len++] = topic_len & 0xFF;        // Taille topic LSB
-    memcpy(&mqtt_publish[mqtt_len], topic, topic_len);  // Copie le topic
-    mqtt_len += topic_len;
+/**
+ * @brief  Émet un paquet PUBLISH (en-tête, topic, packet ID et payload en segments).
+ * @param  header    Premier octet (QoS, retain, DUP).
+ * @param  topic     Topic.
+ * @param  topic_len Longueur du topic.
+ * @param  packet_id Packet ID (ignoré en QoS 0).
+ * @param  payload   Contenu.
+ * @param  len       Taille du contenu.
+ * @return ESP01_Status_t Code de retour.
+ */
+static ESP01_Status_t _mqtt_send_publish(uint8_t header, const char *topic, size_t topic_len, uint16_t packet_id, const void *payload, size_t len)
+{
+    bool has_id = (header & 0x06) != 0;                        // QoS > 0
+    size_t remaining = 2 + topic_len + (has_id ? 2 : 0) + len; // Longueur restante : topic, packet ID, message
+
+    uint8_t head[MQTT_FIXED_HEADER_MAX + 2]; // En-tête fixe + longueur du topic
+    uint8_t head_len = 0;
+    head[head_len++] = header;                                                 // Header PUBLISH
+    head_len += _mqtt_encode_remaining((uint32_t)remaining, head + head_len); // Longueur restante (1 à 4 octets)
+    head[head_len++] = (topic_len >> 8) & 0xFF;                                // Taille topic MSB
+    head[head_len++] = topic_len & 0xFF;                                       // Taille topic LSB
+    uint8_t id[2] = {(packet_id >> 8) & 0xFF, packet_id & 0xFF};               // Packet ID MSB/LSB
+
+    esp01_tx_part_t parts[MQTT_PUBLISH_MAX_PARTS] = {
+        {head, head_len},           // En-tête fixe + longueur du topic
+        {topic, topic_len},         // Topic (buffer de l'appelant ou de la fenêtre)
+        {id, has_id ? 2u : 0u},     // Packet ID
+        {payload, len}};            // Message
+    return _mqtt_send_parts(parts, MQTT_PUBLISH_MAX_PARTS);
+}
 
-    // Packet ID si QoS > 0
-    if (qos > 0)
+// ==================== FENÊTRE DE PUBLICATION QoS 1 / QoS 2 ====================
+/**
+ * @brief  Cherche un message non acquitté par packet ID.
+ * @param  packet_id Packet ID.
+ * @return Entrée, ou NULL.
+ */
+static _mqtt_inflight_t *_mqtt_inflight_find(uint16_t packet_id)
+{
+    for (uint8_t i = 0; i < g_mqtt_if_count; i++)
     {
-        mqtt_publish[mqtt_len++] = (g_mqtt_client.packet_id >> 8) & 0xFF; // Packet ID MSB
-        mqtt_publish[mqtt_len++] = g_mqtt_client.packet_id & 0xFF;        // Packet ID LSB
-        g_mqtt_client.packet_id++;                                        // Incrémente le packet ID
+        _mqtt_inflight_t *m = &g_mqtt_inflight[(g_mqtt_if_first + i) % ESP01_MQTT_MAX_INFLIGHT];
+        if (packet_id && m->packet_id == packet_id)
+        {
+            return m;
+        }
     }
+    return NULL;
+}
 
-    // Message
-    memcpy(&mqtt_publish[mqtt_len], message, message_len); // Copie le message
-    mqtt_len += message_len;
-
-    ESP01_LOG_DEBUG("MQTT", "=== Envoi paquet PUBLISH ==="); // Log l'envoi
-    for (int i = 0; i < mqtt_len && i < 32; i++)
+/**
+ * @brief  Packet ID suivant (jamais 0, jamais celui d'un message non acquitté).
+ * @return Packet ID.
+ */
+static uint16_t _mqtt_next_packet_id(void)
+{
+    for (;;)
     {
-        ESP01_LOG_DEBUG("MQTT", ">>> Byte %02X", mqtt_publish[i]); // Log chaque octet
+        uint16_t id = g_mqtt_client.packet_id++;
+        if (id != 0 && !_mqtt_inflight_find(id))
+        {
+            return id;
+        }
     }
+}
 
-    snprintf(cmd, sizeof(cmd), "AT+CIPSEND=%u", mqtt_len);                                  // Prépare la commande AT+CIPSEND
-    status = esp01_send_raw_command_dma(cmd, resp, sizeof(resp), ">", ESP01_TIMEOUT_SHORT); // Envoie la commande
-    if (status != ESP01_OK)
+/**
+ * @brief  Réserve une zone contiguë du pool pour un message.
+ * @param  len Taille (topic + payload).
+ * @return Index dans g_mqtt_pool, ou -1 si la place manque.
+ */
+static int _mqtt_pool_alloc(size_t len)
+{
+    if (g_mqtt_if_count == 0)
     {
-        ESP01_LOG_WARN("MQTT", ">>> Échec préparation envoi"); // Log échec
-        return status;
+        return 0;
     }
-
-    HAL_UART_Transmit(g_esp_uart, mqtt_publish, mqtt_len, HAL_MAX_DELAY); // Envoie le paquet MQTT
-
-    status = esp01_wait_for_pattern("SEND OK", ESP01_TIMEOUT_MEDIUM); // Attend l'accusé d'envoi
-
-    if (status == ESP01_OK)
+    const _mqtt_inflight_t *first = &g_mqtt_inflight[g_mqtt_if_first];
+    const _mqtt_inflight_t *last = &g_mqtt_inflight[(g_mqtt_if_first + g_mqtt_if_count - 1) % ESP01_MQTT_MAX_INFLIGHT];
+    size_t tail = (size_t)last->off + last->topic_len + last->len; // Fin du message le plus récent
+    if (last->off >= first->off)                                   // Zone occupée d'un seul tenant : fin du pool, puis début
     {
-        ESP01_LOG_DEBUG("MQTT", "Message publié sur %s: %s", topic, message); // Log succès
-
-        // Attente du PUBACK si QoS 1
-        if (qos == 1)
+        if (ESP01_MQTT_INFLIGHT_POOL_SIZE - tail >= len)
         {
-            uint8_t rx_buf[ESP01_SMALL_BUF_SIZE];
-            bool found_puback = false;
-            uint32_t start = HAL_GetTick();
-
-            ESP01_LOG_DEBUG("MQTT", "=== Attente du PUBACK ==="); // Log attente PUBACK
-
-            while ((HAL_GetTick() - start) < ESP01_MQTT_PUBLISH_TIMEOUT && !found_puback)
-            {
-                uint16_t rx_len = esp01_get_new_data(rx_buf, sizeof(rx_buf));
-                if (rx_len > 0)
-                {
-                    for (uint16_t i = 0; i + 1 < rx_len; ++i)
-                    {
-                        if (rx_buf[i] == MQTT_HEADER_PUBACK)
-                        {
-                            ESP01_LOG_DEBUG("MQTT", ">>> PUBACK reçu"); // Log succès PUBACK
-                            found_puback = true;
-                            break;
-                        }
-                    }
-                }
-                HAL_Delay(50);
-            }
-
-            if (!found_puback)
-            {
-                ESP01_LOG_WARN("MQTT", ">>> Pas de PUBACK reçu"); // Log absence PUBACK
-            }
+            return (int)tail;
         }
+        return first->off >= len ? 0 : -1;
     }
-    else
-    {
-        ESP01_LOG_ERROR("MQTT", "Échec de la publication"); // Log échec
-    }
-
-    return status; // Retourne le statut
+    return first->off - tail >= len ? (int)tail : -1; // Zone occupée à cheval : place entre les deux
 }
 
-// ==================== SUBSCRIBE MQTT ====================
 /**
- * @brief  Souscription à un topic.
- * @param  topic Sujet (topic) à souscrire.
- * @param  qos   Qualité de service souhaitée.
- * @return ESP01_Status_t Code de retour.
+ * @brief  Place pour un message dans la fenêtre (nombre de messages et pool).
+ * @param  len Taille (topic + payload).
+ * @return Index dans g_mqtt_pool, ou -1 si la fenêtre est pleine.
  */
-ESP01_Status_t esp01_mqtt_subscribe(const char *topic, uint8_t qos)
+static int _mqtt_window_alloc(size_t len)
 {
-    ESP01_LOG_DEBUG("MQTT", "Souscription au topic '%s', QoS=%d", topic, qos); // Log la souscription
-    VALIDATE_PARAM(topic && qos <= 2, ESP01_INVALID_PARAM);                    // Vérifie les paramètres
-    VALIDATE_PARAM(g_mqtt_client.connected, ESP01_FAIL);                       // Vérifie la connexion
-
-    char cmd[ESP01_MAX_CMD_BUF], resp[ESP01_MAX_RESP_BUF]; // Buffers pour commandes et réponses
-    ESP01_Status_t status;                                 // Statut de retour
-
-    uint8_t mqtt_subscribe[ESP01_MQTT_MAX_PACKET_SIZE]; // Buffer pour le paquet MQTT SUBSCRIBE
-    uint16_t mqtt_len = 0;                              // Taille du paquet
-
-    mqtt_subscribe[mqtt_len++] = MQTT_HEADER_SUBSCRIBE; // Header SUBSCRIBE (0x82)
-
-    uint16_t len_pos = mqtt_len++; // Position du champ "remaining length"
-
-    // Packet ID
-    mqtt_subscribe[mqtt_len++] = g_mqtt_client.packet_id >> 8;   // Packet ID MSB
-    mqtt_subscribe[mqtt_len++] = g_mqtt_client.packet_id & 0xFF; // Packet ID LSB
-    g_mqtt_client.packet_id++;                                   // Incrémente le packet ID
-
-    // Topic
-    uint16_t topic_len = strlen(topic);                  // Longueur du topic
-    mqtt_subscribe[mqtt_len++] = topic_len >> 8;         // Taille topic MSB
-    mqtt_subscribe[mqtt_len++] = topic_len & 0xFF;       // Taille topic LSB
-    memcpy(&mqtt_subscribe[mqtt_len], topic, topic_len); // Copie le topic
-    mqtt_len += topic_len;
-
-    mqtt_subscribe[mqtt_len++] = qos; // QoS
-
-    mqtt_subscribe[len_pos] = mqtt_len - 2; // Encode la longueur variable
-
-    snprintf(cmd, sizeof(cmd), "AT+CIPSEND=%u", mqtt_len);                                  // Prépare la commande AT+CIPSEND
-    status = esp01_send_raw_command_dma(cmd, resp, sizeof(resp), ">", ESP01_TIMEOUT_SHORT); // Envoie la commande
-    if (status != ESP01_OK)
-        return status; // Retourne en cas d'échec
-
-    HAL_UART_Transmit(g_esp_uart, mqtt_subscribe, mqtt_len, HAL_MAX_DELAY); // Envoie le paquet MQTT
-
-    status = esp01_wait_for_pattern("SEND OK", ESP01_TIMEOUT_SHORT); // Attend l'accusé d'envoi
-
-    if (status == ESP01_OK)
-    {
-        ESP01_LOG_DEBUG("MQTT", "Abonnement au topic %s réussi", topic); // Log succès
-    }
-    else
+    if (g_mqtt_if_pending >= g_mqtt_window || g_mqtt_if_count >= ESP01_MQTT_MAX_INFLIGHT)
     {
-        ESP01_LOG_ERROR("MQTT", "Échec de l'abonnement"); // Log échec
+        return -1;
     }
-
-    return status; // Retourne le statut
+    return _mqtt_pool_alloc(len);
 }
 
-// ==================== PING MQTT ====================
 /**
- * @brief  Envoie un ping MQTT (PINGREQ).
+ * @brief  Émet un acquittement de 4 octets (PUBACK, PUBREC, PUBREL ou PUBCOMP).
+ * @param  type      Premier octet du paquet.
+ * @param  packet_id Packet ID acquitté.
  * @return ESP01_Status_t Code de retour.
  */
-ESP01_Status_t esp01_mqtt_ping(void)
+static ESP01_Status_t _mqtt_send_ack(uint8_t type, uint16_t packet_id)
 {
-    ESP01_LOG_DEBUG("MQTT", "Envoi PINGREQ");            // Log l'envoi du ping
-    VALIDATE_PARAM(g_mqtt_client.connected, ESP01_FAIL); // Vérifie la connexion
-
-    char cmd[ESP01_MAX_CMD_BUF], resp[ESP01_MAX_RESP_BUF]; // Buffers pour commandes et réponses
-    ESP01_Status_t status;                                 // Statut de retour
-
-    ESP01_LOG_DEBUG("MQTT", "=== Envoi PINGREQ (keepalive) ==="); // Log la préparation
-
-    uint8_t mqtt_pingreq[2];
-    mqtt_pingreq[0] = MQTT_HEADER_PINGREQ; // Header PINGREQ (0xC0)
-    mqtt_pingreq[1] = 0x00;                // Longueur
+    uint8_t pkt[4] = {type, 0x02, (packet_id >> 8) & 0xFF, packet_id & 0xFF}; // En-tête fixe + packet ID
+    esp01_tx_part_t part = {pkt, sizeof(pkt)};
+    return _mqtt_send_parts(&part, 1);
+}
 
-    snprintf(cmd, sizeof(cmd), "AT+CIPSEND=%u", 2);                                         // Prépare la commande AT+CIPSEND
-    status = esp01_send_raw_command_dma(cmd, resp, sizeof(resp), ">", ESP01_TIMEOUT_SHORT); // Envoie la commande
-    if (status != ESP01_OK)
+/**
+ * @brief  Met un acquittement en file ; il sera émis par _mqtt_ctrl_flush().
+ * @param  type      Premier octet du paquet.
+ * @param  packet_id Packet ID acquitté.
+ * @note   Appelé pendant le traitement des trames, où l'émission (qui relit le flux RX)
+ *         est interdite. File pleine : l'acquittement est perdu, le broker renverra.
+ */
+static void _mqtt_ctrl_queue(uint8_t type, uint16_t packet_id)
+{
+    if (g_mqtt_ctrl_count >= MQTT_CTRL_QUEUE_SIZE)
     {
-        ESP01_LOG_WARN("MQTT", ">>> Échec préparation envoi PINGREQ"); // Log échec
-        return status;
+        ESP01_LOG_WARN("MQTT", "File d'acquittements pleine (packet ID %u)", packet_id);
+        return;
     }
+    _mqtt_ctrl_t *c = &g_mqtt_ctrl[(g_mqtt_ctrl_first + g_mqtt_ctrl_count) % MQTT_CTRL_QUEUE_SIZE];
+    c->type = type;
+    c->packet_id = packet_id;
+    g_mqtt_ctrl_count++;
+}
 
-    HAL_UART_Transmit(g_esp_uart, mqtt_pingreq, 2, HAL_MAX_DELAY); // Envoie le paquet PINGREQ
-
-    status = esp01_wait_for_pattern("SEND OK", ESP01_TIMEOUT_SHORT); // Attend l'accusé d'envoi
-
-    if (status == ESP01_OK)
+/**
+ * @brief  Émet les acquittements en file, dans l'ordre de réception.
+ */
+static void _mqtt_ctrl_flush(void)
+{
+    while (g_mqtt_ctrl_count > 0 && g_mqtt_client.connected)
     {
-        ESP01_LOG_DEBUG("MQTT", "=== PINGREQ envoyé avec succès ==="); // Log succès
-
-        uint8_t rx_buf[ESP01_SMALL_BUF_SIZE];
-        bool found_pingresp = false;
-        uint32_t start = HAL_GetTick();
-
-        while ((HAL_GetTick() - start) < ESP01_MQTT_PUBLISH_TIMEOUT && !found_pingresp)
-        {
-            uint16_t rx_len = esp01_get_new_data(rx_buf, sizeof(rx_buf));
-            if (rx_len > 0)
-            {
-                for (uint16_t i = 0; i + 1 < rx_len; ++i)
-                {
-                    if (rx_buf[i] == MQTT_HEADER_PINGRESP && rx_buf[i + 1] == 0x00)
-                    {
-                        ESP01_LOG_DEBUG("MQTT", "PINGRESP reçu"); // Log succès PINGRESP
-                        found_pingresp = true;
-                        break;
-                    }
-                }
-            }
-            HAL_Delay(50);
-        }
-
-        if (!found_pingresp)
+        const _mqtt_ctrl_t *c = &g_mqtt_ctrl[g_mqtt_ctrl_first];
+        if (_mqtt_send_ack(c->type, c->packet_id) != ESP01_OK) // Lien perdu : redemandé par le broker
         {
-            ESP01_LOG_ERROR("MQTT", "Pas de PINGRESP reçu"); // Log absence PINGRESP
+            break;
         }
+        g_mqtt_ctrl_first = (g_mqtt_ctrl_first + 1) % MQTT_CTRL_QUEUE_SIZE;
+        g_mqtt_ctrl_count--;
     }
-    else
-    {
-        ESP01_LOG_WARN("MQTT", ">>> Échec de l'envoi du PINGREQ"); // Log échec
-    }
-
-    return status; // Retourne le statut
 }
 
-// ==================== DECONNEXION MQTT ====================
 /**
- * @brief  Déconnexion du broker MQTT.
+ * @brief  Émet (ou renvoie) un message de la fenêtre.
+ * @param  m   Message.
+ * @param  dup true pour un renvoi (flag DUP).
  * @return ESP01_Status_t Code de retour.
  */
-ESP01_Status_t esp01_mqtt_disconnect(void)
+static ESP01_Status_t _mqtt_inflight_send(_mqtt_inflight_t *m, bool dup)
 {
-    ESP01_LOG_DEBUG("MQTT", "Déconnexion du broker MQTT"); // Log la déconnexion
-    char resp[ESP01_MAX_RESP_BUF];                         // Buffer pour la réponse
-    if (esp01_send_raw_command_dma("AT+CIPCLOSE", resp, sizeof(resp), "OK", ESP01_AT_COMMAND_TIMEOUT) == ESP01_OK || strstr(resp, "CLOSED"))
+    m->sent_at = HAL_GetTick();
+    return _mqtt_send_publish(m->header | (dup ? MQTT_FLAG_DUP : 0), (const char *)g_mqtt_pool + m->off, m->topic_len, m->packet_id,
+                              g_mqtt_pool + m->off + m->topic_len, m->len);
+}
+
+/**
+ * @brief  PUBACK (QoS 1) ou PUBCOMP (QoS 2) reçu : libère le message correspondant.
+ * @param  type      MQTT_HEADER_PUBACK ou MQTT_HEADER_PUBCOMP.
+ * @param  packet_id Packet ID acquitté.
+ * @note   Les acquittements peuvent arriver dans le désordre : la place d'un message
+ *         n'est rendue qu'une fois les messages plus anciens acquittés.
+ */
+static void _mqtt_inflight_ack(uint8_t type, uint16_t packet_id)
+{
+    _mqtt_inflight_t *m = _mqtt_inflight_find(packet_id);
+    bool qos2 = m && (m->header & 0x06) == (ESP01_MQTT_QOS2 << 1);
+    if (!m || (type == MQTT_HEADER_PUBACK ? qos2 : !qos2 || !m->released))
     {
-        g_mqtt_client.connected = false; // Marque comme déconnecté
-        return ESP01_OK;                 // Déconnexion réussie
+        ESP01_LOG_DEBUG("MQTT", "Acquittement 0x%02X inattendu (packet ID %u)", type, packet_id); // Doublon après renvoi
+        return;
+    }
+    m->packet_id = 0;
+    g_mqtt_if_pending--;
+    g_mqtt_stats.acks++;
+    while (g_mqtt_if_count > 0 && g_mqtt_inflight[g_mqtt_if_first].packet_id == 0) // Libère la tête
+    {
+        g_mqtt_if_first = (g_mqtt_if_first + 1) % ESP01_MQTT_MAX_INFLIGHT;
+        g_mqtt_if_count--;
     }
-    return ESP01_TIMEOUT; // Timeout ou erreur
 }
 
-// ==================== CALLBACK MESSAGE MQTT ====================
 /**
- * @brief  Définit le callback utilisateur pour la réception de messages MQTT.
- * @param  cb Fonction callback à appeler lors de la réception d'un message.
+ * @brief  PUBREC reçu : le broker détient le message QoS 2, PUBREL mis en file.
+ * @param  packet_id Packet ID.
+ * @note   Le topic et le payload ne seront plus renvoyés ; seul le PUBREL l'est, jusqu'au PUBCOMP.
  */
-void esp01_mqtt_set_message_callback(mqtt_message_callback_t cb)
+static void _mqtt_inflight_rec(uint16_t packet_id)
 {
-    ESP01_LOG_DEBUG("MQTT", "Callback message MQTT enregistré"); // Log l'enregistrement du callback
-    g_mqtt_cb = cb;                                              // Enregistre le callback utilisateur
+    _mqtt_inflight_t *m = _mqtt_inflight_find(packet_id);
+    if (m && (m->header & 0x06) == (ESP01_MQTT_QOS2 << 1))
+    {
+        m->released = true;
+        m->sent_at = HAL_GetTick();
+    }
+    _mqtt_ctrl_queue(MQTT_HEADER_PUBREL, packet_id); // Aussi pour un ID inconnu : le broker répond PUBCOMP
 }
 
-// ==================== POLLING MQTT ====================
 /**
- * @brief  Fonction de polling MQTT à appeler régulièrement pour traiter les messages entrants.
+ * @brief  Renvoie les messages non acquittés (PUBLISH avec flag DUP, ou PUBREL après PUBREC).
+ * @param  all true pour tout renvoyer (reconnexion), false pour les messages expirés.
  */
-void esp01_mqtt_poll(void)
+static void _mqtt_inflight_resend(bool all)
 {
-    uint8_t buffer[ESP01_MAX_RESP_BUF];                        // Buffer temporaire pour les nouvelles données
-    uint16_t len = esp01_get_new_data(buffer, sizeof(buffer)); // Récupère les nouvelles données UART
-
+    if (!g_mqtt_client.connected)
+    {
+        return;
+    }
+    uint32_t now = HAL_GetTick();
+    for (uint8_t i = 0; i < g_mqtt_if_count; i++)
+    {
+        _mqtt_inflight_t *m = &g_mqtt_inflight[(g_mqtt_if_first + i) % ESP01_MQTT_MAX_INFLIGHT];
+        if (!m->packet_id || (!all && (!g_mqtt_retry_ms || now - m->sent_at < g_mqtt_retry_ms)))
+        {
+            continue;
+        }
+        ESP01_LOG_DEBUG("MQTT", "Renvoi du packet ID %u (%s, essai %u)", m->packet_id, m->released ? "PUBREL" : "DUP", m->retries + 1);
+        ESP01_Status_t status;
+        if (m->released)
+        {
+            m->sent_at = HAL_GetTick();
+            status = _mqtt_send_ack(MQTT_HEADER_PUBREL, m->packet_id); // PUBCOMP attendu
+        }
+        else
+        {
+            status = _mqtt_inflight_send(m, true);
+        }
+        if (status != ESP01_OK) // Lien perdu : renvoi à la reconnexion
+        {
+            break;
+        }
+        m->retries++;
+        g_mqtt_stats.retransmits++;
+    }
+}
+
+/**
+ * @brief  Ajoute à la fenêtre un message déjà copié dans le pool, puis l'émet.
+ * @param  off       Index du message dans g_mqtt_pool (topic puis payload).
+ * @param  header    Premier octet du PUBLISH.
+ * @param  topic_len Longueur du topic.
+ * @param  len       Taille du contenu.
+ * @note   Le message est conservé même si l'émission échoue : la fenêtre le renvoie
+ *         (délai de renvoi ou reconnexion), l'appelant ne doit pas le republier.
+ */
+static void _mqtt_window_add(int off, uint8_t header, size_t topic_len, size_t len)
+{
+    _mqtt_inflight_t *m = &g_mqtt_inflight[(g_mqtt_if_first + g_mqtt_if_count) % ESP01_MQTT_MAX_INFLIGHT];
+    m->packet_id = _mqtt_next_packet_id();
+    m->off = (uint16_t)off;
+    m->topic_len = (uint16_t)topic_len;
+    m->len = (uint16_t)len;
+    m->header = header;
+    m->retries = 0;
+    m->released = false;
+    g_mqtt_if_count++;
+    g_mqtt_if_pending++;
+    if (g_mqtt_if_pending > g_mqtt_stats.inflight_peak)
+    {
+        g_mqtt_stats.inflight_peak = g_mqtt_if_pending;
+    }
+
+    if (_mqtt_inflight_send(m, false) != ESP01_OK)
+    {
+        ESP01_LOG_WARN("MQTT", "Packet ID %u conservé : renvoi à la reconnexion", m->packet_id);
+    }
+}
+
+/**
+ * @brief  Publie un message QoS 1/2 : copie dans la fenêtre puis envoi sans attendre l'acquittement.
+ * @param  header    Premier octet du PUBLISH.
+ * @param  topic     Topic.
+ * @param  topic_len Longueur du topic.
+ * @param  payload   Contenu.
+ * @param  len       Taille du contenu.
+ * @return ESP01_OK dès que le message est dans la fenêtre, même si son émission a échoué
+ *         (il sera renvoyé) ; ESP01_TIMEOUT ou ESP01_MQTT_NOT_CONNECTED si aucune place ne
+ *         s'est libérée (message non pris en charge).
+ * @note   Fenêtre pleine : les trames reçues sont traitées (PUBACK, PUBREC, PUBCOMP) jusqu'à
+ *         ce qu'une place se libère, dans la limite de ESP01_MQTT_PUBLISH_TIMEOUT.
+ */
+static ESP01_Status_t _mqtt_publish_window(uint8_t header, const char *topic, size_t topic_len, const void *payload, size_t len)
+{
+    VALIDATE_PARAM(topic_len + len <= ESP01_MQTT_INFLIGHT_POOL_SIZE, ESP01_BUFFER_OVERFLOW); // Doit rester disponible pour un renvoi
+
+    uint32_t start = HAL_GetTick();
+    bool waited = false;
+    int off = -1;
+    while ((off = _mqtt_window_alloc(topic_len + len)) < 0)
+    {
+        if (!waited)
+        {
+            g_mqtt_stats.window_full++;
+        }
+        waited = true;
+        if (!g_mqtt_client.connected || HAL_GetTick() - start >= ESP01_MQTT_PUBLISH_TIMEOUT)
+        {
+            ESP01_LOG_WARN("MQTT", "Fenêtre de publication pleine (%u messages non acquittés)", g_mqtt_if_pending);
+            return g_mqtt_client.connected ? ESP01_TIMEOUT : ESP01_MQTT_NOT_CONNECTED;
+        }
+        _mqtt_rx_pump();              // Lit le flux RX
+        _mqtt_process_frames();       // Acquittements reçus
+        _mqtt_ctrl_flush();           // PUBREL en réponse aux PUBREC
+        _mqtt_inflight_resend(false); // Messages expirés
+        HAL_Delay(1);
+    }
+
+    memcpy(g_mqtt_pool + off, topic, topic_len);         // Topic
+    memcpy(g_mqtt_pool + off + topic_len, payload, len); // Payload à la suite
+    _mqtt_window_add(off, header, topic_len, len);
+    return ESP01_OK; // Pris en charge : un échec d'émission est rattrapé par un renvoi, pas par l'appelant
+}
+
+/**
+ * @brief  Règle la fenêtre de publication QoS 1 et QoS 2.
+ * @param  window   Messages non acquittés max (1..ESP01_MQTT_MAX_INFLIGHT).
+ * @param  retry_ms Délai avant renvoi d'un message sans PUBACK (0 : à la reconnexion seulement).
+ * @return ESP01_Status_t Code de retour.
+ */
+ESP01_Status_t esp01_mqtt_set_inflight_window(uint8_t window, uint32_t retry_ms)
+{
+    VALIDATE_PARAM(window >= 1 && window <= ESP01_MQTT_MAX_INFLIGHT, ESP01_INVALID_PARAM);
+    g_mqtt_window = window;
+    g_mqtt_retry_ms = retry_ms;
+    return ESP01_OK;
+}
+
+/**
+ * @brief  Nombre de messages QoS 1/2 en attente de PUBACK ou PUBCOMP.
+ * @return Messages non acquittés.
+ */
+uint8_t esp01_mqtt_inflight_count(void)
+{
+    return g_mqtt_if_pending;
+}
+
+/**
+ * @brief  Session persistante (clean session à 0) aux prochaines connexions.
+ * @param  persistent true pour conserver la session, false pour une session propre.
+ */
+void esp01_mqtt_set_persistent_session(bool persistent)
+{
+    g_mqtt_client.persistent_session = persistent;
+}
+
+// ==================== FILE HORS LIGNE (STORE-AND-FORWARD) ====================
+/**
+ * @brief  Écrit des octets dans la file en RAM (circulaire).
+ * @param  pos Position de départ.
+ * @param  src Données.
+ * @param  n   Nombre d'octets.
+ */
+static void _mqtt_q_write(uint32_t pos, const uint8_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        g_mqtt_q_buf[(pos + i) % ESP01_MQTT_OFFLINE_QUEUE_SIZE] = src[i];
+    }
+}
+
+/**
+ * @brief  Lit des octets de la file en RAM (circulaire).
+ * @param  pos Position de départ.
+ * @param  dst Destination.
+ * @param  n   Nombre d'octets.
+ */
+static void _mqtt_q_read(uint32_t pos, uint8_t *dst, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        dst[i] = g_mqtt_q_buf[(pos + i) % ESP01_MQTT_OFFLINE_QUEUE_SIZE];
+    }
+}
+
+/**
+ * @brief  Longueur de l'enregistrement commençant à pos.
+ * @param  pos Position de l'enregistrement.
+ * @return Longueur totale (en-tête compris).
+ */
+static uint16_t _mqtt_q_rec_len(uint32_t pos)
+{
+    uint8_t h[2];
+    _mqtt_q_read(pos, h, 2);
+    return (uint16_t)((h[0] << 8) | h[1]);
+}
+
+/**
+ * @brief  Libère les enregistrements remplacés situés en tête de la file en RAM.
+ */
+static void _mqtt_ram_skip_dead(void)
+{
+    while (g_mqtt_q_used > 0 && (g_mqtt_q_buf[(g_mqtt_q_head + 2) % ESP01_MQTT_OFFLINE_QUEUE_SIZE] & MQTT_Q_FLAG_DEAD))
+    {
+        uint16_t n = _mqtt_q_rec_len(g_mqtt_q_head);
+        g_mqtt_q_head = (g_mqtt_q_head + n) % ESP01_MQTT_OFFLINE_QUEUE_SIZE;
+        g_mqtt_q_used -= n;
+    }
+}
+
+/**
+ * @brief  Compacte la file en RAM : les enregistrements remplacés sont retirés, les autres
+ *         rapprochés de la tête dans l'ordre.
+ */
+static void _mqtt_ram_compact(void)
+{
+    uint32_t rd = 0, wr = 0; // Positions de lecture et d'écriture, relatives à la tête
+    while (rd < g_mqtt_q_used)
+    {
+        uint32_t pos = (g_mqtt_q_head + rd) % ESP01_MQTT_OFFLINE_QUEUE_SIZE;
+        uint16_t n = _mqtt_q_rec_len(pos);
+        if (!(g_mqtt_q_buf[(pos + 2) % ESP01_MQTT_OFFLINE_QUEUE_SIZE] & MQTT_Q_FLAG_DEAD))
+        {
+            for (uint32_t i = 0; wr != rd && i < n; i++) // Copie vers l'avant : wr <= rd
+            {
+                g_mqtt_q_buf[(g_mqtt_q_head + wr + i) % ESP01_MQTT_OFFLINE_QUEUE_SIZE] = g_mqtt_q_buf[(pos + i) % ESP01_MQTT_OFFLINE_QUEUE_SIZE];
+            }
+            wr += n;
+        }
+        rd += n;
+    }
+    g_mqtt_q_used = wr;
+}
+
+/**
+ * @brief  File en RAM : écrit une partie d'un nouvel enregistrement, directement dans l'anneau.
+ * @param  rec_len Longueur totale de l'enregistrement.
+ * @param  off     Position de la partie dans l'enregistrement (0 : réserve la place).
+ * @param  data    Données.
+ * @param  len     Taille de la partie.
+ * @return false si la place manque.
+ */
+static bool _mqtt_ram_push(uint16_t rec_len, uint16_t off, const void *data, uint16_t len)
+{
+    if (off == 0)
+    {
+        _mqtt_ram_skip_dead();
+        if (ESP01_MQTT_OFFLINE_QUEUE_SIZE - g_mqtt_q_used < rec_len)
+        {
+            _mqtt_ram_compact(); // Place des messages remplacés (coalescence)
+        }
+        if (ESP01_MQTT_OFFLINE_QUEUE_SIZE - g_mqtt_q_used < rec_len)
+        {
+            return false;
+        }
+    }
+    _mqtt_q_write((g_mqtt_q_head + g_mqtt_q_used + off) % ESP01_MQTT_OFFLINE_QUEUE_SIZE, data, len);
+    if (off + len == rec_len) // Enregistrement complet
+    {
+        g_mqtt_q_used += rec_len;
+    }
+    return true;
+}
+
+/**
+ * @brief  File en RAM : copie une partie de l'enregistrement le plus ancien.
+ * @param  off  Position dans l'enregistrement.
+ * @param  data Destination.
+ * @param  max  Taille de la destination.
+ * @return Octets copiés (0 : file vide, ou fin de l'enregistrement).
+ */
+static uint16_t _mqtt_ram_peek(uint16_t off, void *data, uint16_t max)
+{
+    _mqtt_ram_skip_dead();
+    if (g_mqtt_q_used == 0)
+    {
+        return 0;
+    }
+    uint16_t n = _mqtt_q_rec_len(g_mqtt_q_head);
+    if (off >= n)
+    {
+        return 0;
+    }
+    if (max > n - off)
+    {
+        max = n - off;
+    }
+    _mqtt_q_read((g_mqtt_q_head + off) % ESP01_MQTT_OFFLINE_QUEUE_SIZE, data, max);
+    return max;
+}
+
+/**
+ * @brief  File en RAM : retire l'enregistrement le plus ancien.
+ */
+static void _mqtt_ram_pop(void)
+{
+    _mqtt_ram_skip_dead();
+    if (g_mqtt_q_used == 0)
+    {
+        return;
+    }
+    uint16_t n = _mqtt_q_rec_len(g_mqtt_q_head);
+    g_mqtt_q_head = (g_mqtt_q_head + n) % ESP01_MQTT_OFFLINE_QUEUE_SIZE;
+    g_mqtt_q_used -= n;
+}
+
+static const esp01_mqtt_queue_backend_t g_mqtt_q_ram = {_mqtt_ram_push, _mqtt_ram_peek, _mqtt_ram_pop, NULL}; // File en RAM par défaut
+
+/**
+ * @brief  Stockage actif de la file hors ligne.
+ * @return Stockage externe, ou file en RAM.
+ */
+static const esp01_mqtt_queue_backend_t *_mqtt_q_store(void)
+{
+    return g_mqtt_q_backend ? g_mqtt_q_backend : &g_mqtt_q_ram;
+}
+
+/**
+ * @brief  Met à jour la profondeur de la file et les statistiques.
+ * @param  delta +1 (ajout) ou -1 (retrait).
+ */
+static void _mqtt_q_depth_add(int delta)
+{
+    if (delta < 0 && g_mqtt_q_depth == 0) // Journal externe sans count(), repris après redémarrage
+    {
+        return;
+    }
+    g_mqtt_q_depth += delta;
+    g_mqtt_stats.queue_depth = g_mqtt_q_depth;
+    if (g_mqtt_q_depth > g_mqtt_stats.queue_peak)
+    {
+        g_mqtt_stats.queue_peak = g_mqtt_q_depth;
+    }
+}
+
+/**
+ * @brief  Coalescence : marque comme remplacés les messages en file sur le même topic.
+ * @param  topic     Topic.
+ * @param  topic_len Longueur du topic.
+ * @note   La place est rendue en tête de file, ou par compactage quand la file est pleine.
+ */
+static void _mqtt_ram_coalesce(const char *topic, size_t topic_len)
+{
+    for (uint32_t off = 0; off < g_mqtt_q_used;)
+    {
+        uint32_t pos = (g_mqtt_q_head + off) % ESP01_MQTT_OFFLINE_QUEUE_SIZE;
+        uint8_t h[MQTT_Q_REC_HDR];
+        _mqtt_q_read(pos, h, sizeof(h));
+        off += (uint16_t)((h[0] << 8) | h[1]);
+        if ((h[2] & MQTT_Q_FLAG_DEAD) || (size_t)((h[3] << 8) | h[4]) != topic_len)
+        {
+            continue;
+        }
+        uint32_t i = 0;
+        while (i < topic_len && g_mqtt_q_buf[(pos + MQTT_Q_REC_HDR + i) % ESP01_MQTT_OFFLINE_QUEUE_SIZE] == (uint8_t)topic[i])
+        {
+            i++;
+        }
+        if (i < topic_len)
+        {
+            continue;
+        }
+        g_mqtt_q_buf[(pos + 2) % ESP01_MQTT_OFFLINE_QUEUE_SIZE] |= MQTT_Q_FLAG_DEAD;
+        _mqtt_q_depth_add(-1);
+        g_mqtt_stats.queue_coalesced++;
+    }
+}
+
+/**
+ * @brief  Met un message en file hors ligne selon la politique.
+ * @param  header    Premier octet du PUBLISH (QoS, retain).
+ * @param  topic     Topic.
+ * @param  topic_len Longueur du topic.
+ * @param  payload   Contenu.
+ * @param  len       Taille du contenu.
+ * @return ESP01_OK, ou ESP01_BUFFER_OVERFLOW (message plus grand que la file, ou refusé en DROP_NEWEST).
+ * @note   L'enregistrement est écrit en trois parties (en-tête, topic, payload), sans copie intermédiaire.
+ */
+static ESP01_Status_t _mqtt_queue_push(uint8_t header, const char *topic, size_t topic_len, const void *payload, size_t len)
+{
+    size_t rec_size = MQTT_Q_REC_HDR + topic_len + len;
+    VALIDATE_PARAM(rec_size <= (g_mqtt_q_backend ? 0xFFFF : ESP01_MQTT_OFFLINE_QUEUE_SIZE), ESP01_BUFFER_OVERFLOW); // Longueur codée sur 2 octets, ou file en RAM
+    VALIDATE_PARAM(!(header & 0x06) || topic_len + len <= ESP01_MQTT_INFLIGHT_POOL_SIZE, ESP01_BUFFER_OVERFLOW);     // Republié par la fenêtre
+    const esp01_mqtt_queue_backend_t *store = _mqtt_q_store();
+
+    uint16_t rec_len = (uint16_t)rec_size;
+    uint8_t hdr[MQTT_Q_REC_HDR] = {
+        rec_len >> 8,              // Longueur MSB
+        rec_len & 0xFF,            // Longueur LSB
+        header & 0x07,             // QoS et retain
+        (topic_len >> 8) & 0xFF,   // Taille topic MSB
+        topic_len & 0xFF};         // Taille topic LSB
+
+    if (g_mqtt_q_policy == ESP01_MQTT_QUEUE_COALESCE && !g_mqtt_q_backend) // Dernière valeur du topic seulement
+    {
+        _mqtt_ram_coalesce(topic, topic_len);
+    }
+
+    while (!store->push(rec_len, 0, hdr, sizeof(hdr)))
+    {
+        if (g_mqtt_q_policy == ESP01_MQTT_QUEUE_DROP_NEWEST || g_mqtt_q_depth == 0)
+        {
+            g_mqtt_stats.queue_dropped++;
+            ESP01_LOG_WARN("MQTT", "File hors ligne pleine : message sur %s refusé", topic);
+            return ESP01_BUFFER_OVERFLOW;
+        }
+        store->pop(); // Écarte le plus ancien
+        _mqtt_q_depth_add(-1);
+        g_mqtt_stats.queue_dropped++;
+    }
+    store->push(rec_len, MQTT_Q_REC_HDR, topic, (uint16_t)topic_len); // Place réservée par l'en-tête
+    if (len > 0)                                                       // Parties non vides seulement
+    {
+        store->push(rec_len, (uint16_t)(MQTT_Q_REC_HDR + topic_len), payload, (uint16_t)len);
+    }
+    _mqtt_q_depth_add(1);
+    g_mqtt_stats.queued++;
+    ESP01_LOG_DEBUG("MQTT", "Message sur %s mis en file hors ligne (%lu en file)", topic, (unsigned long)g_mqtt_q_depth);
+    return ESP01_OK;
+}
+
+/**
+ * @brief  Règle la file hors ligne.
+ * @param  policy  Politique.
+ * @param  backend Stockage externe, ou NULL pour la file en RAM.
+ * @return ESP01_Status_t Code de retour (ESP01_FAIL si la file à remplacer n'est pas vide).
+ */
+ESP01_Status_t esp01_mqtt_set_offline_queue(esp01_mqtt_queue_policy_t policy, const esp01_mqtt_queue_backend_t *backend)
+{
+    VALIDATE_PARAM(policy <= ESP01_MQTT_QUEUE_COALESCE, ESP01_INVALID_PARAM);
+    VALIDATE_PARAM(!backend || (backend->push && backend->peek && backend->pop), ESP01_INVALID_PARAM);
+    VALIDATE_PARAM(backend == g_mqtt_q_backend || g_mqtt_q_depth == 0, ESP01_FAIL); // Messages en file conservés
+    g_mqtt_q_policy = policy;
+    if (backend && backend->count && backend != g_mqtt_q_backend) // Journal repris après redémarrage
+    {
+        g_mqtt_q_depth = backend->count();
+        g_mqtt_stats.queue_depth = g_mqtt_q_depth;
+        if (g_mqtt_q_depth > g_mqtt_stats.queue_peak)
+        {
+            g_mqtt_stats.queue_peak = g_mqtt_q_depth;
+        }
+    }
+    g_mqtt_q_backend = backend;
+    return ESP01_OK;
+}
+
+/**
+ * @brief  Nombre de messages dans la file hors ligne.
+ * @return Messages en attente de republication.
+ */
+uint32_t esp01_mqtt_queue_depth(void)
+{
+    return g_mqtt_q_depth;
+}
+
+/**
+ * @brief  Publication d'un payload binaire sur un topic.
+ * @param  topic   Sujet (topic) du message.
+ * @param  payload Contenu (émis directement depuis ce buffer en QoS 0).
+ * @param  len     Taille du contenu.
+ * @param  qos     Qualité de service (0, 1 ou 2).
+ * @param  retain  true pour conserver le message sur le broker, false sinon.
+ * @return ESP01_Status_t Code de retour.
+ * @note   En-tête, topic et payload sont émis en segments ; un paquet plus grand que
+ *         ESP01_MAX_SEND_LEN est découpé en plusieurs AT+CIPSEND. En QoS 1 et 2, le message
+ *         est copié dans la fenêtre et la fonction rend la main sans attendre le PUBACK
+ *         (ou l'échange PUBREC/PUBREL/PUBCOMP), traité par esp01_mqtt_poll(). Sans connexion,
+ *         le message est mis en file hors ligne (voir esp01_mqtt_set_offline_queue()).
+ */
+ESP01_Status_t esp01_mqtt_publish_raw(const char *topic, const void *payload, size_t len, uint8_t qos, bool retain)
+{
+    ESP01_LOG_DEBUG("MQTT", "Publication sur topic '%s', %u octets, QoS=%d, retain=%d", topic ? topic : "", (unsigned)len, qos, retain); // Log la publication
+    VALIDATE_PARAM(topic && topic[0] && (payload || len == 0) && qos <= 2, ESP01_INVALID_PARAM);                                    // Vérifie les paramètres
+
+    size_t topic_len = strlen(topic);                                           // Longueur du topic
+    VALIDATE_PARAM(topic_len <= 0xFFFF, ESP01_INVALID_PARAM);                   // Longueur codée sur 2 octets
+    VALIDATE_PARAM(2 + topic_len + 2 + len <= MQTT_MAX_REMAINING_LEN, ESP01_BUFFER_OVERFLOW); // Longueur restante codable
+
+    uint8_t header = MQTT_HEADER_PUBLISH | (qos << 1) | (retain ? 1 : 0); // Header PUBLISH
+    bool queue_on = g_mqtt_q_policy != ESP01_MQTT_QUEUE_OFF;
+    if (queue_on && (!g_mqtt_client.connected || g_mqtt_q_depth > 0)) // Hors ligne, ou file en cours de vidage : ordre conservé
+    {
+        return _mqtt_queue_push(header, topic, topic_len, payload, len);
+    }
+    VALIDATE_PARAM(g_mqtt_client.connected, ESP01_FAIL); // Vérifie la connexion
+
+    ESP01_Status_t status; // Statut de retour
+    if (qos > 0)
+    {
+        status = _mqtt_publish_window(header, topic, topic_len, payload, len); // Fenêtre : acquittements traités par esp01_mqtt_poll()
+    }
+    else
+    {
+        status = _mqtt_send_publish(header, topic, topic_len, 0, payload, len);
+    }
+    if (status == ESP01_MQTT_NOT_CONNECTED && queue_on) // Lien perdu pendant l'attente d'une place
+    {
+        return _mqtt_queue_push(header, topic, topic_len, payload, len);
+    }
+
+    if (status == ESP01_OK)
+    {
+        g_mqtt_stats.publishes++;
+        ESP01_LOG_DEBUG("MQTT", "Message publié sur %s (%u octets)", topic, (unsigned)len); // Log succès
+    }
+    else
+    {
+        ESP01_LOG_ERROR("MQTT", "Échec de la publication"); // Log échec
+    }
+
+    return status; // Retourne le statut
+}
+
+// ==================== SUBSCRIBE MQTT ====================
+/**
+ * @brief  Souscription à un topic.
+ * @param  topic Sujet (topic) à souscrire.
+ * @param  qos   Qualité de service souhaitée.
+ * @return ESP01_Status_t Code de retour.
+ */
+ESP01_Status_t esp01_mqtt_subscribe(const char *topic, uint8_t qos)
+{
+    ESP01_LOG_DEBUG("MQTT", "Souscription au topic '%s', QoS=%d", topic, qos); // Log la souscription
+    VALIDATE_PARAM(topic && qos <= 2 && strlen(topic) <= ESP01_MQTT_MAX_TOPIC_LEN, ESP01_INVALID_PARAM); // Vérifie les paramètres
+    VALIDATE_PARAM(g_mqtt_client.connected, ESP01_FAIL);                                                // Vérifie la connexion
+
+    char cmd[ESP01_MAX_CMD_BUF], resp[ESP01_MAX_RESP_BUF]; // Buffers pour commandes et réponses
+    ESP01_Status_t status;                                 // Statut de retour
+
+    uint8_t mqtt_subscribe[MQTT_FIXED_HEADER_MAX + 5 + ESP01_MQTT_MAX_TOPIC_LEN]; // Buffer pour le paquet MQTT SUBSCRIBE
+    uint16_t mqtt_len = MQTT_FIXED_HEADER_MAX;                                      // Corps après la place de l'en-tête fixe
+
+    // Packet ID
+    uint16_t packet_id = _mqtt_next_packet_id();  // Packet ID libre
+    mqtt_subscribe[mqtt_len++] = packet_id >> 8;   // Packet ID MSB
+    mqtt_subscribe[mqtt_len++] = packet_id & 0xFF; // Packet ID LSB
+
+    // Topic
+    uint16_t topic_len = strlen(topic);                  // Longueur du topic
+    mqtt_subscribe[mqtt_len++] = topic_len >> 8;         // Taille topic MSB
+    mqtt_subscribe[mqtt_len++] = topic_len & 0xFF;       // Taille topic LSB
+    memcpy(&mqtt_subscribe[mqtt_len], topic, topic_len); // Copie le topic
+    mqtt_len += topic_len;
+
+    mqtt_subscribe[mqtt_len++] = qos; // QoS
+
+    uint16_t start = _mqtt_prepend_header(mqtt_subscribe, MQTT_HEADER_SUBSCRIBE, mqtt_len); // Header SUBSCRIBE (0x82) + longueur restante
+    mqtt_len -= start;
+
+    snprintf(cmd, sizeof(cmd), "AT+CIPSEND=%u", mqtt_len);                                  // Prépare la commande AT+CIPSEND
+    status = esp01_send_raw_command_dma(cmd, resp, sizeof(resp), ">", ESP01_TIMEOUT_SHORT); // Envoie la commande
+    if (status != ESP01_OK)
+        return status; // Retourne en cas d'échec
+
+    esp01_uart_write(mqtt_subscribe + start, mqtt_len); // Envoie le paquet MQTT
+
+    status = esp01_wait_for_pattern("SEND OK", ESP01_TIMEOUT_SHORT); // Attend l'accusé d'envoi
+
+    if (status == ESP01_OK)
+    {
+        ESP01_LOG_DEBUG("MQTT", "Abonnement au topic %s réussi", topic); // Log succès
+    }
+    else
+    {
+        ESP01_LOG_ERROR("MQTT", "Échec de l'abonnement"); // Log échec
+    }
+
+    return status; // Retourne le statut
+}
+
+// ==================== PING MQTT ====================
+/**
+ * @brief  Envoie un ping MQTT (PINGREQ).
+ * @return ESP01_Status_t Code de retour.
+ */
+ESP01_Status_t esp01_mqtt_ping(void)
+{
+    ESP01_LOG_DEBUG("MQTT", "Envoi PINGREQ");            // Log l'envoi du ping
+    VALIDATE_PARAM(g_mqtt_client.connected, ESP01_FAIL); // Vérifie la connexion
+
+    char cmd[ESP01_MAX_CMD_BUF], resp[ESP01_MAX_RESP_BUF]; // Buffers pour commandes et réponses
+    ESP01_Status_t status;                                 // Statut de retour
+
+    ESP01_LOG_DEBUG("MQTT", "=== Envoi PINGREQ (keepalive) ==="); // Log la préparation
+
+    uint8_t mqtt_pingreq[2];
+    mqtt_pingreq[0] = MQTT_HEADER_PINGREQ; // Header PINGREQ (0xC0)
+    mqtt_pingreq[1] = 0x00;                // Longueur
+
+    snprintf(cmd, sizeof(cmd), "AT+CIPSEND=%u", 2);                                         // Prépare la commande AT+CIPSEND
+    status = esp01_send_raw_command_dma(cmd, resp, sizeof(resp), ">", ESP01_TIMEOUT_SHORT); // Envoie la commande
+    if (status != ESP01_OK)
+    {
+        ESP01_LOG_WARN("MQTT", ">>> Échec préparation envoi PINGREQ"); // Log échec
+        return status;
+    }
+
+    esp01_uart_write(mqtt_pingreq, 2); // Envoie le paquet PINGREQ
+
+    status = esp01_wait_for_pattern("SEND OK", ESP01_TIMEOUT_SHORT); // Attend l'accusé d'envoi
+
+    if (status == ESP01_OK)
+    {
+        ESP01_LOG_DEBUG("MQTT", "=== PINGREQ envoyé avec succès ==="); // Log succès
+
+        uint8_t rx_buf[ESP01_SMALL_BUF_SIZE];
+        bool found_pingresp = false;
+        uint32_t start = HAL_GetTick();
+
+        while ((HAL_GetTick() - start) < ESP01_MQTT_PUBLISH_TIMEOUT && !found_pingresp)
+        {
+            uint16_t rx_len = esp01_get_new_data(rx_buf, sizeof(rx_buf));
+            if (rx_len > 0)
+            {
+                for (uint16_t i = 0; i + 1 < rx_len; ++i)
+                {
+                    if (rx_buf[i] == MQTT_HEADER_PINGRESP && rx_buf[i + 1] == 0x00)
+                    {
+                        ESP01_LOG_DEBUG("MQTT", "PINGRESP reçu"); // Log succès PINGRESP
+                        found_pingresp = true;
+                        break;
+                    }
+                }
+            }
+            HAL_Delay(50);
+        }
+
+        if (!found_pingresp)
+        {
+            ESP01_LOG_ERROR("MQTT", "Pas de PINGRESP reçu"); // Log absence PINGRESP
+        }
+    }
+    else
+    {
+        ESP01_LOG_WARN("MQTT", ">>> Échec de l'envoi du PINGREQ"); // Log échec
+    }
+
+    return status; // Retourne le statut
+}
+
+// ==================== DECONNEXION MQTT ====================
+/**
+ * @brief  Déconnexion du broker MQTT.
+ * @return ESP01_Status_t Code de retour.
+ */
+ESP01_Status_t esp01_mqtt_disconnect(void)
+{
+    ESP01_LOG_DEBUG("MQTT", "Déconnexion du broker MQTT"); // Log la déconnexion
+    char resp[ESP01_MAX_RESP_BUF];                         // Buffer pour la réponse
+    if (esp01_send_raw_command_dma("AT+CIPCLOSE", resp, sizeof(resp), "OK", ESP01_AT_COMMAND_TIMEOUT) == ESP01_OK || strstr(resp, "CLOSED"))
+    {
+        g_mqtt_client.connected = false; // Marque comme déconnecté
+        return ESP01_OK;                 // Déconnexion réussie
+    }
+    return ESP01_TIMEOUT; // Timeout ou erreur
+}
+
+// ==================== CALLBACK MESSAGE MQTT ====================
+/**
+ * @brief  Définit le callback utilisateur pour la réception de messages MQTT.
+ * @param  cb Fonction callback à appeler lors de la réception d'un message.
+ */
+void esp01_mqtt_set_message_callback(mqtt_message_callback_t cb)
+{
+    ESP01_LOG_DEBUG("MQTT", "Callback message MQTT enregistré"); // Log l'enregistrement du callback
+    g_mqtt_cb = cb;                                              // Enregistre le callback utilisateur
+}
+
+// ==================== POLLING MQTT ====================
+/**
+ * @brief  Retire des octets de l'accumulateur MQTT.
+ * @param  pos   Position du premier octet.
+ * @param  count Nombre d'octets.
+ */
+static void _mqtt_acc_remove(uint16_t pos, uint16_t count)
+{
+    memmove(g_mqtt_accumulator + pos, g_mqtt_accumulator + pos + count, g_mqtt_acc_len - pos - count); // Décale la suite
+    g_mqtt_acc_len -= count;
+    g_mqtt_accumulator[g_mqtt_acc_len] = '\0';
+}
+
+/**
+ * @brief  Lit le flux RX dans l'accumulateur MQTT et traite les lignes AT.
+ * @note   Les trames +IPD complètes sont laissées pour esp01_mqtt_poll() ; les lignes
+ *         situées hors trames (">", "SEND OK", "busy"...) sont transmises au pipeline
+ *         d'émission puis retirées. Sert aussi de lecture RX à esp01_send_submit().
+ *         Seule la place libre est lue : le reste attend dans le buffer DMA, rien n'est
+ *         perdu quand l'accumulateur est plein.
+ */
+static void _mqtt_rx_pump(void)
+{
+    uint16_t room = MQTT_ACC_SIZE - g_mqtt_acc_len;
+    int len = room > 0 ? esp01_get_new_data(g_mqtt_accumulator + g_mqtt_acc_len, room) : 0; // Lu directement dans l'accumulateur
     if (len > 0)
     {
-        if (g_mqtt_acc_len + len < sizeof(g_mqtt_accumulator) - 1)
+        uint16_t skip = g_mqtt_acc_skip < (uint32_t)len ? (uint16_t)g_mqtt_acc_skip : (uint16_t)len; // Suite d'une trame ignorée
+        g_mqtt_acc_skip -= skip;
+        memmove(g_mqtt_accumulator + g_mqtt_acc_len, g_mqtt_accumulator + g_mqtt_acc_len + skip, len - skip);
+        g_mqtt_acc_len += len - skip;
+        g_mqtt_accumulator[g_mqtt_acc_len] = '\0';
+    }
+
+    uint16_t pos = 0; // Position courante dans l'accumulateur
+    while (pos < g_mqtt_acc_len)
+    {
+        char *p = (char *)g_mqtt_accumulator + pos;
+        uint16_t avail = g_mqtt_acc_len - pos;
+        if (avail >= 5 && memcmp(p, "+IPD,", 5) == 0) // Trame : conservée telle quelle
         {
-            memcpy(g_mqtt_accumulator + g_mqtt_acc_len, buffer, len); // Ajoute au buffer accumulateur
-            g_mqtt_acc_len += len;
-            g_mqtt_accumulator[g_mqtt_acc_len] = '\0';
+            char *colon = memchr(p, ':', avail);
+            int payload_len = 0;
+            if (!colon || sscanf(p + 5, "%d", &payload_len) != 1) // En-tête incomplet
+            {
+                break;
+            }
+            uint32_t frame_len = (uint32_t)(colon - p) + 1 + (uint32_t)payload_len;
+            if (payload_len < 0 || frame_len > MQTT_ACC_SIZE) // Ne tiendra jamais : ignorée, flux MQTT resynchronisé ensuite
+            {
+                ESP01_LOG_ERROR("MQTT", "Trame +IPD de %d octets ignorée (max %d)", payload_len, MQTT_IPD_PAYLOAD_MAX);
+                g_mqtt_stats.rx_dropped++;
+                g_mqtt_acc_skip = payload_len < 0 ? 0 : frame_len - avail;
+                g_mqtt_rx_pkt_len = 0; // Paquet en cours de reconstitution perdu
+                g_mqtt_rx_skip = 0;
+                g_mqtt_acc_len = pos;
+                g_mqtt_accumulator[g_mqtt_acc_len] = '\0';
+                break;
+            }
+            if (frame_len > avail) // Trame incomplète
+            {
+                break;
+            }
+            pos += frame_len;
+            continue;
         }
-        else
+        if (p[0] == '>') // Invite d'AT+CIPSEND (sans fin de ligne)
         {
-            g_mqtt_acc_len = 0;
-            g_mqtt_accumulator[0] = '\0';
-            ESP01_LOG_ERROR("MQTT", "Débordement de l'accumulateur MQTT"); // Log débordement
+            esp01_send_on_line(">", 1);
+            _mqtt_acc_remove(pos, 1);
+            continue;
+        }
+        char *nl = memchr(p, '\n', avail);
+        if (!nl) // Ligne incomplète
+        {
+            break;
+        }
+        uint16_t line_len = (uint16_t)(nl - p) + 1;
+        if (!esp01_send_on_line(p, line_len) && line_len >= 6 && memcmp(p, "CLOSED", 6) == 0) // Lien fermé par le broker ou le réseau
+        {
+            ESP01_LOG_WARN("MQTT", "Connexion au broker perdue");
+            g_mqtt_client.connected = false; // Messages non acquittés renvoyés à la reconnexion
+        }
+        _mqtt_acc_remove(pos, line_len);
+    }
+    if (pos == 0 && g_mqtt_acc_len == MQTT_ACC_SIZE) // Plein sans trame ni ligne complète : octets parasites
+    {
+        ESP01_LOG_ERROR("MQTT", "Débordement de l'accumulateur MQTT"); // Log débordement
+        g_mqtt_acc_len = 0;
+        g_mqtt_accumulator[0] = '\0';
+    }
+}
+
+/**
+ * @brief  PUBLISH QoS 2 reçu : enregistre son packet ID jusqu'au PUBREL.
+ * @param  packet_id Packet ID.
+ * @return 1 si nouveau (à remonter), 0 si doublon, -1 si la table est pleine.
+ */
+static int _mqtt_rx_qos2_register(uint16_t packet_id)
+{
+    int free_slot = -1;
+    for (int i = 0; i < ESP01_MQTT_QOS2_RX_SLOTS; i++)
+    {
+        if (g_mqtt_rx_qos2[i] == packet_id)
+        {
+            return 0; // Déjà remonté : PUBREL pas encore reçu
+        }
+        if (g_mqtt_rx_qos2[i] == 0 && free_slot < 0)
+        {
+            free_slot = i;
+        }
+    }
+    if (free_slot < 0)
+    {
+        return -1;
+    }
+    g_mqtt_rx_qos2[free_slot] = packet_id;
+    return 1;
+}
+
+/**
+ * @brief  PUBREL reçu : oublie le packet ID (un PUBLISH suivant avec cet ID est un nouveau message).
+ * @param  packet_id Packet ID.
+ */
+static void _mqtt_rx_qos2_release(uint16_t packet_id)
+{
+    for (int i = 0; i < ESP01_MQTT_QOS2_RX_SLOTS; i++)
+    {
+        if (g_mqtt_rx_qos2[i] == packet_id)
+        {
+            g_mqtt_rx_qos2[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief  Traite un paquet MQTT reçu (acquittements, PUBLISH : callback utilisateur).
+ * @param  type Premier octet (type et flags).
+ * @param  body Corps du paquet (après l'en-tête fixe).
+ * @param  len  Longueur restante.
+ * @note   Les réponses (PUBACK, PUBREC, PUBREL, PUBCOMP) sont mises en file et émises
+ *         après le traitement des trames. En QoS 2, le message est remonté à la première
+ *         réception ; les renvois reçus avant le PUBREL sont acquittés sans être remontés.
+ */
+static void _mqtt_handle_packet(uint8_t type, const uint8_t *body, uint32_t len)
+{
+    uint16_t ack_id = len >= 2 ? (uint16_t)((body[0] << 8) | body[1]) : 0; // Packet ID des acquittements
+    switch (type & 0xF0)
+    {
+    case MQTT_HEADER_PUBACK:  // QoS 1 : message de la fenêtre acquitté
+    case MQTT_HEADER_PUBCOMP: // QoS 2 : échange terminé
+        if (len >= 2)
+        {
+            _mqtt_inflight_ack(type & 0xF0, ack_id);
+        }
+        return;
+    case MQTT_HEADER_PUBREC: // QoS 2 : message reçu par le broker
+        if (len >= 2)
+        {
+            _mqtt_inflight_rec(ack_id);
+        }
+        return;
+    case (MQTT_HEADER_PUBREL & 0xF0): // QoS 2 : le broker libère un message reçu
+        if (len >= 2)
+        {
+            _mqtt_rx_qos2_release(ack_id);
+            _mqtt_ctrl_queue(MQTT_HEADER_PUBCOMP, ack_id);
+        }
+        return;
+    case MQTT_HEADER_PUBLISH:
+        break;
+    default:
+        return;
+    }
+
+    uint8_t qos = (type >> 1) & 0x03;
+    uint16_t topic_len = len >= 2 ? (uint16_t)((body[0] << 8) | body[1]) : 0;
+    uint32_t msg_off = 2u + topic_len + (qos > 0 ? 2u : 0u); // Message après le topic et le packet ID
+    if (len < 2 || msg_off > len || topic_len > ESP01_MQTT_MAX_TOPIC_LEN || qos > ESP01_MQTT_QOS2)
+    {
+        ESP01_LOG_WARN("MQTT", "Paquet PUBLISH mal formé ou topic trop long"); // Log erreur format
+        return;
+    }
+
+    uint16_t packet_id = qos > 0 ? (uint16_t)((body[2 + topic_len] << 8) | body[3 + topic_len]) : 0;
+    if (qos > 0 && packet_id == 0) // Packet ID 0 interdit en QoS 1/2
+    {
+        ESP01_LOG_WARN("MQTT", "Paquet PUBLISH QoS %u sans packet ID", qos);
+        return;
+    }
+    if (qos == ESP01_MQTT_QOS2)
+    {
+        int reg = _mqtt_rx_qos2_register(packet_id);
+        if (reg < 0) // Sans PUBREC, le broker renverra le message
+        {
+            ESP01_LOG_WARN("MQTT", "Table QoS 2 pleine : packet ID %u ignoré", packet_id);
+            return;
+        }
+        _mqtt_ctrl_queue(MQTT_HEADER_PUBREC, packet_id);
+        if (reg == 0)
+        {
+            g_mqtt_stats.rx_duplicates++;
+            ESP01_LOG_DEBUG("MQTT", "PUBLISH QoS 2 en double (packet ID %u) ignoré", packet_id);
+            return;
+        }
+    }
+    else if (qos == ESP01_MQTT_QOS1)
+    {
+        _mqtt_ctrl_queue(MQTT_HEADER_PUBACK, packet_id);
+    }
+    if (!g_mqtt_cb)
+    {
+        return;
+    }
+
+    char topic_buf[ESP01_MQTT_MAX_TOPIC_LEN + 1] = {0};
+    memcpy(topic_buf, &body[2], topic_len); // Copie le topic
+    topic_buf[topic_len] = '\0';
+    esp01_trim_string(topic_buf);
+
+    uint32_t msg_len = len - msg_off;
+    if (msg_len > (ESP01_MQTT_MAX_PAYLOAD_LEN - 1))
+    {
+        msg_len = ESP01_MQTT_MAX_PAYLOAD_LEN - 1;
+    }
+
+    char msg_buf[ESP01_MQTT_MAX_PAYLOAD_LEN] = {0};
+    memcpy(msg_buf, &body[msg_off], msg_len); // Copie le message
+    msg_buf[msg_len] = '\0';
+    esp01_trim_string(msg_buf);
+
+    g_mqtt_cb(topic_buf, msg_buf);                                                                   // Appelle le callback utilisateur
+    ESP01_LOG_DEBUG("MQTT", "Paquet PUBLISH reçu sur topic '%s', message='%s'", topic_buf, msg_buf); // Log réception
+}
+
+/**
+ * @brief  Complète le paquet reçu en cours de reconstitution.
+ * @param  data Octets de la trame.
+ * @param  len  Nombre d'octets.
+ * @return Octets consommés.
+ * @note   Le paquet est traité dès qu'il est complet. Un paquet plus grand que
+ *         ESP01_MQTT_RX_PACKET_MAX est ignoré jusqu'à sa fin (resynchronisation
+ *         sur le paquet suivant).
+ */
+static uint32_t _mqtt_rx_pkt_feed(const uint8_t *data, uint32_t len)
+{
+    uint32_t used = 0;
+    while (used < len)
+    {
+        uint32_t remaining = 0;
+        int hdr = g_mqtt_rx_pkt_len > 0 ? _mqtt_decode_header(g_mqtt_rx_pkt, g_mqtt_rx_pkt_len, &remaining) : 0;
+        if (hdr < 0) // Longueur invalide : flux désynchronisé, reste de la trame ignoré
+        {
+            ESP01_LOG_WARN("MQTT", "Longueur de paquet MQTT invalide (%lu octets ignorés)", (unsigned long)(len - used));
+            g_mqtt_stats.rx_dropped++;
+            g_mqtt_rx_pkt_len = 0;
+            return len;
+        }
+        if (hdr == 0) // En-tête fixe incomplet : un octet de plus
+        {
+            g_mqtt_rx_pkt[g_mqtt_rx_pkt_len++] = data[used++];
+            continue;
+        }
+        uint32_t total = (uint32_t)hdr + remaining; // Taille du paquet
+        if (total > sizeof(g_mqtt_rx_pkt))         // Trop grand pour être reconstitué
+        {
+            ESP01_LOG_WARN("MQTT", "Paquet MQTT de %lu octets ignoré (max %d)", (unsigned long)total, ESP01_MQTT_RX_PACKET_MAX);
+            g_mqtt_stats.rx_dropped++;
+            g_mqtt_rx_skip = total - g_mqtt_rx_pkt_len; // Suite ignorée, ici et dans les trames suivantes
+            g_mqtt_rx_pkt_len = 0;
+            uint32_t n = len - used < g_mqtt_rx_skip ? len - used : g_mqtt_rx_skip;
+            g_mqtt_rx_skip -= n;
+            return used + n;
+        }
+        uint32_t n = total - g_mqtt_rx_pkt_len; // Octets manquants
+        if (n > len - used)
+        {
+            n = len - used;
+        }
+        memcpy(g_mqtt_rx_pkt + g_mqtt_rx_pkt_len, data + used, n);
+        g_mqtt_rx_pkt_len += n;
+        used += n;
+        if (g_mqtt_rx_pkt_len == total) // Paquet complet
+        {
+            _mqtt_handle_packet(g_mqtt_rx_pkt[0], g_mqtt_rx_pkt + hdr, remaining);
+            g_mqtt_rx_pkt_len = 0;
+        }
+        return used;
+    }
+    return used;
+}
+
+/**
+ * @brief  Traite les paquets MQTT contenus dans le payload d'une trame +IPD.
+ * @param  data Payload de la trame.
+ * @param  len  Taille du payload.
+ * @note   Une trame peut contenir plusieurs paquets ; la longueur restante de chacun
+ *         est décodée sur 1 à 4 octets. Un paquet coupé en fin de trame est
+ *         reconstitué avec le début des trames suivantes.
+ */
+static void _mqtt_handle_frame(const uint8_t *data, uint32_t len)
+{
+    uint32_t off = 0;
+    while (off < len)
+    {
+        if (g_mqtt_rx_skip > 0) // Fin d'un paquet trop grand
+        {
+            uint32_t n = len - off < g_mqtt_rx_skip ? len - off : g_mqtt_rx_skip;
+            g_mqtt_rx_skip -= n;
+            off += n;
+            continue;
+        }
+        if (g_mqtt_rx_pkt_len > 0) // Suite d'un paquet commencé dans une trame précédente
+        {
+            off += _mqtt_rx_pkt_feed(data + off, len - off);
+            continue;
+        }
+        uint32_t remaining = 0;
+        int hdr = _mqtt_decode_header(data + off, len - off, &remaining);
+        if (hdr < 0) // Longueur invalide : resynchronisation sur la trame suivante
+        {
+            ESP01_LOG_WARN("MQTT", "Paquet MQTT invalide (%lu octets ignorés)", (unsigned long)(len - off));
+            g_mqtt_stats.rx_dropped++;
             return;
         }
+        if (hdr == 0 || remaining > len - off - (uint32_t)hdr) // Paquet coupé : suite dans la trame suivante
+        {
+            off += _mqtt_rx_pkt_feed(data + off, len - off);
+            continue;
+        }
+        _mqtt_handle_packet(data[off], data + off + hdr, remaining);
+        off += (uint32_t)hdr + remaining;
+    }
+}
+
+/**
+ * @brief  Traite les trames +IPD complètes de l'accumulateur MQTT.
+ * @note   Sans effet si un traitement est déjà en cours (publication QoS 1/2 depuis le
+ *         callback utilisateur) : les trames restent dans l'accumulateur.
+ */
+static void _mqtt_process_frames(void)
+{
+    static bool busy = false; // Traitement en cours (callback utilisateur)
+    if (busy)
+    {
+        return;
     }
+    busy = true;
 
     // Traitement des paquets MQTT dans l'accumulateur
     while (1)
@@ -596,36 +1719,7 @@ void esp01_mqtt_poll(void)
             break;
         }
 
-        uint8_t *payload = (uint8_t *)(colon_pos + 1);
-
-        // Décodage d'un paquet PUBLISH MQTT
-        if (payload_len > 4 && (payload[0] & 0xF0) == MQTT_HEADER_PUBLISH && g_mqtt_cb)
-        {
-            uint16_t topic_len = (payload[2] << 8) | payload[3];
-            if (topic_len + 4 < payload_len && topic_len < ESP01_MQTT_MAX_TOPIC_LEN)
-            {
-                char topic_buf[ESP01_MQTT_MAX_TOPIC_LEN + 1] = {0};
-                memcpy(topic_buf, &payload[4], topic_len); // Copie le topic
-                topic_buf[topic_len] = '\0';
-                esp01_trim_string(topic_buf);
-
-                int msg_len = payload_len - 4 - topic_len;
-                if (msg_len > (ESP01_MQTT_MAX_PAYLOAD_LEN - 1))
-                    msg_len = ESP01_MQTT_MAX_PAYLOAD_LEN - 1;
-
-                char msg_buf[ESP01_MQTT_MAX_PAYLOAD_LEN] = {0};
-                memcpy(msg_buf, &payload[4 + topic_len], msg_len); // Copie le message
-                msg_buf[msg_len] = '\0';
-                esp01_trim_string(msg_buf);
-
-                g_mqtt_cb(topic_buf, msg_buf);                                                                   // Appelle le callback utilisateur
-                ESP01_LOG_DEBUG("MQTT", "Paquet PUBLISH reçu sur topic '%s', message='%s'", topic_buf, msg_buf); // Log réception
-            }
-            else
-            {
-                ESP01_LOG_WARN("MQTT", "Paquet PUBLISH mal formé ou topic/message trop long"); // Log erreur format
-            }
-        }
+        _mqtt_handle_frame((const uint8_t *)(colon_pos + 1), (uint32_t)payload_len); // Paquets MQTT de la trame
 
         // Retire le paquet traité de l'accumulateur
         int total_to_remove = ipd_start_offset + ipd_total_len;
@@ -641,6 +1735,122 @@ void esp01_mqtt_poll(void)
             g_mqtt_accumulator[0] = '\0';
         }
     }
+    busy = false;
+}
+
+/**
+ * @brief  Émet en QoS 0 l'enregistrement le plus ancien, relu par parties de ESP01_MQTT_OFFLINE_CHUNK.
+ * @param  store     Stockage de la file.
+ * @param  header    Premier octet du PUBLISH.
+ * @param  rec_len   Longueur de l'enregistrement.
+ * @param  topic_len Longueur du topic.
+ * @return ESP01_Status_t Code de retour (ESP01_PARSE_ERROR : enregistrement tronqué).
+ * @note   Topic et payload se suivent dans l'enregistrement comme dans le paquet : chaque
+ *         partie relue part telle quelle, le paquet continuant d'un AT+CIPSEND à l'autre.
+ */
+static ESP01_Status_t _mqtt_queue_send(const esp01_mqtt_queue_backend_t *store, uint8_t header, uint16_t rec_len, uint16_t topic_len)
+{
+    uint8_t head[MQTT_FIXED_HEADER_MAX + 2]; // En-tête fixe + longueur du topic
+    uint8_t head_len = 0;
+    head[head_len++] = header;
+    head_len += _mqtt_encode_remaining((uint32_t)(2 + rec_len - MQTT_Q_REC_HDR), head + head_len); // Taille du topic, topic, payload
+    head[head_len++] = (topic_len >> 8) & 0xFF;
+    head[head_len++] = topic_len & 0xFF;
+
+    esp01_tx_part_t parts[2] = {{head, head_len}, {g_mqtt_q_out, 0}};
+    for (uint16_t off = MQTT_Q_REC_HDR; off < rec_len;)
+    {
+        uint16_t got = store->peek(off, g_mqtt_q_out, sizeof(g_mqtt_q_out));
+        if (got == 0) // Enregistrement tronqué (journal externe)
+        {
+            return ESP01_PARSE_ERROR;
+        }
+        parts[1].len = got;
+        ESP01_Status_t status = (off == MQTT_Q_REC_HDR) ? _mqtt_send_parts(parts, 2) : _mqtt_send_parts(&parts[1], 1);
+        if (status != ESP01_OK)
+        {
+            return status;
+        }
+        off += got;
+    }
+    return ESP01_OK;
+}
+
+/**
+ * @brief  Republie la file hors ligne par lots, dans l'ordre d'ajout.
+ * @note   S'arrête sans attendre si la fenêtre QoS 1/2 est pleine ou si le lien tombe :
+ *         le message reste en file et la suite est reprise au prochain appel. Les
+ *         enregistrements sont relus par parties : en QoS 1/2 directement dans le pool de
+ *         la fenêtre, en QoS 0 via g_mqtt_q_out.
+ */
+static void _mqtt_queue_drain(void)
+{
+    const esp01_mqtt_queue_backend_t *store = _mqtt_q_store();
+    for (uint8_t n = 0; n < ESP01_MQTT_OFFLINE_DRAIN_BATCH && g_mqtt_client.connected; n++)
+    {
+        uint8_t hdr[MQTT_Q_REC_HDR];
+        if (store->peek(0, hdr, sizeof(hdr)) < MQTT_Q_REC_HDR) // File vide
+        {
+            g_mqtt_q_depth = 0;
+            g_mqtt_stats.queue_depth = 0;
+            return;
+        }
+        uint16_t rec_len = (uint16_t)((hdr[0] << 8) | hdr[1]);
+        uint8_t header = MQTT_HEADER_PUBLISH | (hdr[2] & 0x07); // QoS et retain
+        uint16_t topic_len = (uint16_t)((hdr[3] << 8) | hdr[4]);
+        size_t body = (size_t)rec_len - MQTT_Q_REC_HDR; // Topic + payload
+        bool valid = topic_len != 0 && MQTT_Q_REC_HDR + topic_len <= rec_len && (!(header & 0x06) || body <= ESP01_MQTT_INFLIGHT_POOL_SIZE);
+
+        if (valid && (header & 0x06)) // QoS 1/2 : relu dans la fenêtre, renvoyé par elle en cas d'échec
+        {
+            int off = _mqtt_window_alloc(body);
+            if (off < 0)
+            {
+                return;
+            }
+            valid = store->peek(MQTT_Q_REC_HDR, g_mqtt_pool + off, (uint16_t)body) == body;
+            if (valid)
+            {
+                _mqtt_window_add(off, header, topic_len, body - topic_len); // Renvoyé par la fenêtre si l'émission échoue
+            }
+        }
+        else if (valid)
+        {
+            ESP01_Status_t status = _mqtt_queue_send(store, header, rec_len, topic_len);
+            if (status == ESP01_PARSE_ERROR)
+            {
+                valid = false;
+            }
+            else if (status != ESP01_OK)
+            {
+                return;
+            }
+        }
+        if (!valid) // Enregistrement corrompu (journal externe)
+        {
+            ESP01_LOG_WARN("MQTT", "Enregistrement de file hors ligne invalide écarté");
+            store->pop();
+            _mqtt_q_depth_add(-1);
+            g_mqtt_stats.queue_dropped++;
+            continue;
+        }
+        store->pop();
+        _mqtt_q_depth_add(-1);
+        g_mqtt_stats.queue_drained++;
+        g_mqtt_stats.publishes++;
+    }
+}
+
+/**
+ * @brief  Fonction de polling MQTT à appeler régulièrement pour traiter les messages entrants.
+ */
+void esp01_mqtt_poll(void)
+{
+    _mqtt_rx_pump();              // Lit le flux RX et traite les lignes AT
+    _mqtt_process_frames();       // Acquittements et messages reçus
+    _mqtt_ctrl_flush();           // Réponses PUBACK, PUBREC, PUBREL, PUBCOMP
+    _mqtt_inflight_resend(false); // Messages non acquittés depuis trop longtemps
+    _mqtt_queue_drain();          // File hors ligne, après reconnexion
 }
 
 // ==================== VÉRIFICATION CONNEXION MQTT ====================
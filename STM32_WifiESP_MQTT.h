@@ -32,13 +32,21 @@
 /* =========================== DEFINES ========================== */
 // ----------- CONSTANTES MQTT -----------
 #define ESP01_MQTT_MAX_TOPIC_LEN 128    // Taille max d'un topic MQTT
-#define ESP01_MQTT_MAX_PAYLOAD_LEN 256  // Taille max d'un message MQTT
+#define ESP01_MQTT_MAX_PAYLOAD_LEN 256  // Taille max d'un message MQTT reçu (publication : sans limite)
 #define ESP01_MQTT_MAX_CLIENT_ID_LEN 32 // Taille max d'un client ID MQTT
 #define ESP01_MQTT_KEEPALIVE_DEFAULT 60 // Keepalive par défaut (secondes)
 #define ESP01_MQTT_QOS0 0               // QoS 0
 #define ESP01_MQTT_QOS1 1               // QoS 1
 #define ESP01_MQTT_QOS2 2               // QoS 2
 #define ESP01_MQTT_DEFAULT_PORT 1883    // Port MQTT par défaut
+#define ESP01_MQTT_MAX_INFLIGHT 8             // Messages QoS 1/2 en attente de PUBACK/PUBCOMP (fenêtre max)
+#define ESP01_MQTT_INFLIGHT_POOL_SIZE 4096    // Octets de topics + payloads conservés pour renvoi
+#define ESP01_MQTT_RETRY_MS 5000              // Renvoi (DUP ou PUBREL) d'un message non acquitté
+#define ESP01_MQTT_QOS2_RX_SLOTS 8            // PUBLISH QoS 2 reçus en attente de PUBREL (doublons filtrés)
+#define ESP01_MQTT_OFFLINE_QUEUE_SIZE 4096    // Octets de la file hors ligne en RAM (en-têtes + topics + payloads)
+#define ESP01_MQTT_OFFLINE_CHUNK 512          // Octets relus du stockage par étape lors de la republication
+#define ESP01_MQTT_OFFLINE_DRAIN_BATCH 8      // Messages republiés par appel à esp01_mqtt_poll()
+#define ESP01_MQTT_RX_PACKET_MAX 512          // Paquet reçu max reconstitué sur plusieurs trames +IPD (au-delà : ignoré)
 
 /* =========================== TYPES & STRUCTURES ======================= */
 /**
@@ -52,8 +60,55 @@ typedef struct
     char client_id[ESP01_MQTT_MAX_CLIENT_ID_LEN + 1]; // Identifiant client MQTT
     uint16_t keep_alive;                              // Intervalle keep-alive (s)
     uint16_t packet_id;                               // Dernier packet ID utilisé
+    bool persistent_session;                          // Session conservée par le broker (clean session à 0)
 } mqtt_client_t;
 
+/**
+ * @brief Politique de la file hors ligne (publications faites sans connexion au broker).
+ */
+typedef enum
+{
+    ESP01_MQTT_QUEUE_OFF = 0,     // Pas de file : la publication échoue (ESP01_FAIL)
+    ESP01_MQTT_QUEUE_DROP_OLDEST, // File pleine : les messages les plus anciens sont écartés
+    ESP01_MQTT_QUEUE_DROP_NEWEST, // File pleine : le nouveau message est refusé (ESP01_BUFFER_OVERFLOW)
+    ESP01_MQTT_QUEUE_COALESCE     // Un message remplace celui du même topic encore en file, puis DROP_OLDEST
+} esp01_mqtt_queue_policy_t;
+
+/**
+ * @brief Stockage externe de la file hors ligne (journal en flash, fichier...).
+ * @note  Enregistrements opaques, rendus dans l'ordre d'ajout ; remplace la file en RAM.
+ *        Un enregistrement est écrit et relu par parties (offset croissant) : sa taille
+ *        n'est limitée que par le stockage. push() avec off à 0 réserve rec_len octets ;
+ *        l'enregistrement est complet quand off + len atteint rec_len (parties non vides).
+ */
+typedef struct
+{
+    bool (*push)(uint16_t rec_len, uint16_t off, const void *data, uint16_t len); // Écrit une partie du nouvel enregistrement (false : plein)
+    uint16_t (*peek)(uint16_t off, void *data, uint16_t max);                     // Copie une partie du plus ancien (0 : journal vide)
+    void (*pop)(void);                                                            // Retire l'enregistrement le plus ancien
+    uint32_t (*count)(void);                                                      // Enregistrements en journal, relu au réglage (NULL : 0)
+} esp01_mqtt_queue_backend_t;
+
+/**
+ * @brief Statistiques de publication MQTT.
+ */
+typedef struct
+{
+    uint32_t publishes;       // Messages publiés (QoS 0, 1 et 2)
+    uint32_t acks;            // Messages de la fenêtre acquittés (PUBACK en QoS 1, PUBCOMP en QoS 2)
+    uint32_t retransmits;     // Messages renvoyés avec le flag DUP
+    uint32_t window_full;     // Publications ayant attendu une place dans la fenêtre
+    uint32_t inflight_peak;   // Messages non acquittés simultanés (maximum)
+    uint32_t rx_duplicates;   // PUBLISH QoS 2 reçus en double (non remontés au callback)
+    uint32_t rx_dropped;      // Paquets reçus ignorés (plus grands que ESP01_MQTT_RX_PACKET_MAX ou mal formés)
+    uint32_t queued;          // Messages mis en file hors ligne
+    uint32_t queue_depth;     // Messages actuellement en file
+    uint32_t queue_peak;      // Profondeur max de la file
+    uint32_t queue_dropped;   // Messages écartés, file pleine (DROP_OLDEST ou DROP_NEWEST)
+    uint32_t queue_coalesced; // Messages remplacés par un plus récent du même topic
+    uint32_t queue_drained;   // Messages republiés après reconnexion
+} esp01_mqtt_stats_t;
+
 /**
  * @brief Prototype de callback pour la réception de messages MQTT.
  * @param topic   Sujet du message reçu.
@@ -62,7 +117,8 @@ typedef struct
 typedef void (*mqtt_message_callback_t)(const char *topic, const char *message);
 
 /* ========================= VARIABLES GLOBALES ========================= */
-extern mqtt_client_t g_mqtt_client; // Instance globale du client MQTT
+extern mqtt_client_t g_mqtt_client;     // Instance globale du client MQTT
+extern esp01_mqtt_stats_t g_mqtt_stats; // Statistiques de publication
 
 /**
  * @defgroup ESP01_MQTT_AT_WRAPPERS Wrappers AT et helpers associés (par commande AT)
@@ -72,6 +128,7 @@ extern mqtt_client_t g_mqtt_client; // Instance globale du client MQTT
  * |---------------------|----------------------------------|---------------------------------|-------------------------------------|
  * | AT+MQTTCONN         | esp01_mqtt_connect               | INUTILE                         | Connexion au broker MQTT            |
  * | AT+MQTTPUB          | esp01_mqtt_publish               | INUTILE                         | Publication d'un message            |
+ * | AT+MQTTPUB          | esp01_mqtt_publish_raw           | INUTILE                         | Publication d'un payload binaire    |
  * | AT+MQTTSUB          | esp01_mqtt_subscribe             | INUTILE                         | Souscription à un topic             |
  * | AT+MQTTPING         | esp01_mqtt_ping                  | INUTILE                         | Ping MQTT                           |
  * | AT+MQTTDISC         | esp01_mqtt_disconnect            | INUTILE                         | Déconnexion du broker               |
@@ -102,6 +159,65 @@ ESP01_Status_t esp01_mqtt_connect(const char *broker_ip, uint16_t port,
 ESP01_Status_t esp01_mqtt_publish(const char *topic, const char *message,
                                   uint8_t qos, bool retain);
 
+/**
+ * @brief  Publication d'un payload binaire sur un topic (JSON de télémétrie, etc.)
+ * @param  topic   Sujet (topic) du message.
+ * @param  payload Contenu, émis directement depuis ce buffer en QoS 0 (copié dans la fenêtre en QoS 1 et 2).
+ * @param  len     Taille du contenu (au-delà de ESP01_MAX_SEND_LEN : plusieurs AT+CIPSEND).
+ * @param  qos     Qualité de service (0, 1 ou 2).
+ * @param  retain  true pour conserver le message sur le broker, false sinon.
+ * @return ESP01_Status_t Code de retour. En QoS 1 et 2, ESP01_OK signifie que le message est
+ *         dans la fenêtre : si son émission échoue, il est renvoyé sans nouvel appel.
+ */
+ESP01_Status_t esp01_mqtt_publish_raw(const char *topic, const void *payload, size_t len,
+                                      uint8_t qos, bool retain);
+
+/**
+ * @brief  Règle la fenêtre de publication QoS 1 et QoS 2.
+ * @param  window   Messages non acquittés max (1..ESP01_MQTT_MAX_INFLIGHT) : les publications
+ *                  suivantes attendent une place au lieu d'un aller-retour par message.
+ * @param  retry_ms Délai avant renvoi (PUBLISH DUP, ou PUBREL après PUBREC) d'un message
+ *                  non acquitté (0 : à la reconnexion seulement).
+ * @return ESP01_Status_t Code de retour.
+ * @note   Les messages non acquittés sont aussi renvoyés après esp01_mqtt_connect().
+ */
+ESP01_Status_t esp01_mqtt_set_inflight_window(uint8_t window, uint32_t retry_ms);
+
+/**
+ * @brief  Nombre de messages QoS 1/2 en attente de PUBACK ou PUBCOMP.
+ * @return Messages non acquittés.
+ */
+uint8_t esp01_mqtt_inflight_count(void);
+
+/**
+ * @brief  Demande au broker de conserver la session (clean session à 0) aux prochaines connexions.
+ * @param  persistent true pour une session persistante, false pour une session propre (défaut).
+ * @note   Nécessaire à l'exactly-once QoS 2 à travers une reconnexion : l'état des échanges
+ *         PUBLISH/PUBREC/PUBREL/PUBCOMP est conservé des deux côtés. En session propre, les
+ *         messages non acquittés sont renvoyés (au moins une fois) et les packet IDs QoS 2
+ *         reçus sont oubliés.
+ */
+void esp01_mqtt_set_persistent_session(bool persistent);
+
+/**
+ * @brief  Règle la file hors ligne (store-and-forward).
+ * @param  policy  Politique (ESP01_MQTT_QUEUE_DROP_OLDEST par défaut).
+ * @param  backend Stockage externe, ou NULL pour la file en RAM (ESP01_MQTT_OFFLINE_QUEUE_SIZE).
+ * @return ESP01_Status_t Code de retour.
+ * @note   Sans connexion (ou tant que la file n'est pas vide, pour garder l'ordre), une
+ *         publication est mise en file et rend ESP01_OK ; esp01_mqtt_poll() republie la file
+ *         par lots de ESP01_MQTT_OFFLINE_DRAIN_BATCH après la reconnexion. Avec un stockage
+ *         externe, ESP01_MQTT_QUEUE_COALESCE se comporte comme DROP_OLDEST ; la profondeur
+ *         de la file est reprise de backend->count(), pour un journal conservé au redémarrage.
+ */
+ESP01_Status_t esp01_mqtt_set_offline_queue(esp01_mqtt_queue_policy_t policy, const esp01_mqtt_queue_backend_t *backend);
+
+/**
+ * @brief  Nombre de messages dans la file hors ligne.
+ * @return Messages en attente de republication.
+ */
+uint32_t esp01_mqtt_queue_depth(void);
+
 /**
  * @brief  Souscription à un topic (AT+MQTTSUB)
  * @param  topic Sujet (topic) à souscrire.
@@ -42,7 +42,7 @@
 #define ESP01_MAX_PASSWORD_LEN 64                           // Longueur max d'un mot de passe WiFi
 #define ESP01_MAX_PASSWORD_BUF (ESP01_MAX_PASSWORD_LEN + 1) // Taille buffer mot de passe (avec \0)
 #define ESP01_MAX_ENCRYPTION_LEN 8                          // Longueur max pour le type d'encryptage
-#define ESP01_MAX_IP_LEN 32                                 // Longueur max pour une adresse IP
+#define ESP01_MAX_IP_LEN 46                                 // Longueur max pour une adresse IP (IPv6 comprise)
 #define ESP01_MAX_HOSTNAME_LEN 64                           // Longueur max pour un hostname
 #define ESP01_MAX_MAC_LEN 18                                // Longueur max pour une adresse MAC
 #define ESP01_MAX_SCAN_NETWORKS 10                          // Nombre max de réseaux détectés lors d'un scan
@@ -16,6 +16,9 @@
  *   - Page Test GET (/testget) : démonstration de traitement des paramètres GET
  *   - Page Statut (/status) : statistiques et informations de connexion
  *   - Page Device (/device) : informations système et réseau
+ *   - API JSON (/api/status) : statut du serveur en JSON
+ *   - WebSocket (/ws) : état de la LED poussé aux clients, commande "on"/"off"
+ *   - Server-Sent Events (/events) : évènement "led" à chaque changement d'état
  * - Génération dynamique de contenu HTML/CSS responsive
  * - Traitement des requêtes HTTP entrantes
  * - Affichage des statistiques de connexion
@@ -128,6 +131,66 @@ static const char PAGE_CSS[] =
 	".card{background:linear-gradient(135deg,#c8f7c5 0%,#fff9c4 50%,#ffd6d6 100%);margin:3em auto 0 auto;padding:2.5em 2em 2em 2em;border-radius:18px;box-shadow:0 4px 24px #0004;max-width:420px;display:flex;flex-direction:column;align-items:center;}"
 	"h1{color:#2d3a1a;margin-top:0;margin-bottom:1.5em;}";
 
+// --- Templates ---
+// Les pages sont décrites par des tableaux d'opérations constants (en flash) :
+// les littéraux sont envoyés tels quels et seules les valeurs dynamiques sont
+// formatées au moment de l'envoi, directement dans le flux de réponse.
+enum
+{
+	TPL_VAR_LED_COLOR = 1, // Couleur de l'état de la LED
+	TPL_VAR_LED_TEXT,	   // Texte de l'état de la LED
+	TPL_VAR_IP,			   // Adresse IP du serveur
+	TPL_VAR_PORT,		   // Port du serveur
+	TPL_VAR_ACTIVE_COUNT,  // Nombre de connexions actives
+	TPL_VAR_CONN_ID,	   // ID de la connexion (boucle)
+	TPL_VAR_CONN_IDLE,	   // Dernière activité de la connexion (boucle)
+	TPL_VAR_CONN_IP,	   // IP client de la connexion (boucle)
+	TPL_VAR_CONN_PORT,	   // Port client de la connexion (boucle)
+	TPL_VAR_NO_CONN,	   // Message si aucune connexion active
+	TPL_VAR_STAT_REQUESTS, // Requêtes reçues
+	TPL_VAR_STAT_RESPONSES, // Réponses envoyées
+	TPL_VAR_STAT_SUCCESS,  // Réponses réussies
+	TPL_VAR_STAT_FAILED,   // Réponses en échec
+	TPL_VAR_STAT_AVG_MS,   // Temps de réponse moyen
+	TPL_VAR_AT_VERSION,	   // Version du firmware AT
+	TPL_VAR_STM32_TYPE,	   // Type de carte STM32
+	TPL_VAR_WIFI_MODE,	   // Mode WiFi
+	TPL_VAR_WIFI_SSID,	   // SSID configuré
+	TPL_VAR_MULTI_CONN,	   // Multi-connexion activée
+	TPL_LOOP_CONNECTIONS   // Boucle sur les connexions actives
+};
+
+// Pied de page commun : bouton retour accueil et fin du document
+static const char HTML_BUTTON_HOME[] = "<a class='button green' href='/'>Accueil</a>";
+static const esp01_tpl_op_t TPL_FOOTER_HOME[] = {
+	ESP01_TPL_LIT(HTML_BUTTON_HOME),
+	ESP01_TPL_LIT(HTML_CARD_END_BODY_END),
+	ESP01_TPL_END()};
+
+// Structure pour les informations système
+typedef struct
+{
+	char at_version[64];	// Version du firmware AT du module ESP01
+	char stm32_type[32];	// Type de carte STM32 (L1, L4, F1, F4, F7, H7)
+	char wifi_mode[8];		// Mode WiFi (STA ou AP)
+	const char *wifi_ssid;	// SSID du réseau WiFi configuré
+	uint16_t server_port;	// Port du serveur web embarqué
+	const char *multi_conn; // Indique si les connexions multiples sont activées (Oui/Non)
+} system_info_t;			// Structure pour stocker les informations système
+
+// Contexte de rendu partagé par les pages
+typedef struct
+{
+	const char *ip;			   // Adresse IP du serveur
+	GPIO_PinState led;		   // État de la LED
+	const system_info_t *sys;  // Informations système (page device)
+	int conn_slot;			   // Connexion courante dans la boucle
+} page_ctx_t;
+
+static void page_var_cb(esp01_http_stream_t *out, uint8_t var_id, uint16_t index, void *ctx);
+static bool page_loop_cb(uint8_t loop_id, uint16_t index, void *ctx);
+static void push_led_state(void);
+
 // --- Page Accueil ("/") ---
 // Cette fonction gère la page d'accueil du serveur web embarqué.
 // Elle affiche un menu principal avec des liens vers les différentes fonctionnalités (LED, test GET, statut, device).
@@ -152,25 +215,20 @@ static void page_root(int conn_id, const http_parsed_request_t *req)
 		"<a class='button red' href='/status'>Statut</a>"
 		"<a class='button red' href='/device'>Device</a>";
 
-	char html[2048];					 // Tampon pour générer la page HTML
-	html[0] = '\0';						 // Initialise le tampon à vide
-	char *ptr = html;					 // Pointeur pour écrire dans le tampon HTML
-	char *end_ptr = html + sizeof(html); // Pointeur de fin pour éviter les débordements
-
-	if (esp01_check_buffer_size(strlen(ptr) + 256, end_ptr - ptr) != ESP01_OK) // Vérifie si le tampon est assez grand
-		return;
-
-	// Génération du contenu HTML
-	// Utilise snprintf pour écrire dans le tampon HTML de manière sécurisée
-	ptr += snprintf(ptr, end_ptr - ptr, "%s%s%s%s", HTML_DOC_START, HTML_TITLE_START, PAGE_ROOT_TITLE, HTML_TITLE_END_STYLE_START); // Début du document HTML, titre et début du style
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", PAGE_CSS);																			// Ajoute le CSS commun
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", CSS_PAGE_ROOT_SPECIFIC);																// Ajoute le CSS spécifique à la page d'accueil
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", HTML_STYLE_END_HEAD_BODY_CARD_START);													// Fin du style, début du body et de la card
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", BODY_PAGE_ROOT);																		// Ajoute le corps de la page d'accueil
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", HTML_CARD_END_BODY_END);																// Fin de la card, du body et du document HTML
-
-	printf("[TEST][INFO] Sortie de page_root, réponse envoyée sur conn_id=%d, taille=%d\r\n", conn_id, (int)strlen(html)); // Affiche la taille de la réponse
-	esp01_send_http_response(conn_id, 200, "text/html; charset=UTF-8", html, strlen(html));								   // Envoie la page
+	static const esp01_tpl_op_t TPL_PAGE_ROOT[] = {
+		ESP01_TPL_LIT(HTML_DOC_START),
+		ESP01_TPL_LIT(HTML_TITLE_START),
+		ESP01_TPL_LIT(PAGE_ROOT_TITLE),
+		ESP01_TPL_LIT(HTML_TITLE_END_STYLE_START),
+		ESP01_TPL_LIT(PAGE_CSS),
+		ESP01_TPL_LIT(CSS_PAGE_ROOT_SPECIFIC),
+		ESP01_TPL_LIT(HTML_STYLE_END_HEAD_BODY_CARD_START),
+		ESP01_TPL_LIT(BODY_PAGE_ROOT),
+		ESP01_TPL_LIT(HTML_CARD_END_BODY_END),
+		ESP01_TPL_END()}; // Page entièrement statique : aucun formatage à l'envoi
+
+	ESP01_Status_t st = esp01_http_send_template(conn_id, 200, "text/html; charset=UTF-8", TPL_PAGE_ROOT, NULL, NULL, NULL); // Envoie la page
+	printf("[TEST][INFO] Sortie de page_root, réponse envoyée sur conn_id=%d, statut=%s\r\n", conn_id, esp01_get_error_string(st)); // Affiche le statut de l'envoi
 }
 
 // --- Page LED ("/led") ---
@@ -184,8 +242,8 @@ static void page_led(int conn_id, const http_parsed_request_t *req)
 		return;
 	printf("[TEST][INFO] Entrée dans page_led (conn_id=%d)\r\n", conn_id);
 
-	const char PAGE_LED_TITLE[] = "LED STM32";
-	const char CSS_PAGE_LED_SPECIFIC[] =
+	static const char PAGE_LED_TITLE[] = "LED STM32";
+	static const char CSS_PAGE_LED_SPECIFIC[] =
 		"form{margin:1em 0;}"
 		"button{display:inline-block;padding:1em 2em;margin:1em 0.5em;background:#388e3c;color:#fff;text-decoration:none;border-radius:8px;font-size:1.1em;transition:background 0.2s,border 0.2s;box-shadow:0 2px 8px #e0f5d8;border:2px solid #388e3c;}"
 		"button.green{background:#28a745;border-color:#28a745;color:#fff;}"
@@ -193,46 +251,93 @@ static void page_led(int conn_id, const http_parsed_request_t *req)
 		"button:hover{filter:brightness(1.15);}"
 		"a.button{display:inline-block;padding:1em 2em;margin:1em 0.5em;background:#fbc02d;color:#fff;text-decoration:none;border-radius:8px;font-size:1.1em;transition:background 0.2s,border 0.2s;box-shadow:0 2px 8px #e0f5d8;border:2px solid #fbc02d;}"
 		"a.button.yellow{background:#fbc02d;border-color:#fbc02d;color:#fff;}";
-	static const char BODY_PAGE_LED[] =
-		"<h1>Contrôle de la LED</h1>"
-		"<p>État actuel : <b style='color:%s'>%s</b></p>"
-		"<form method='get' action='/led'>"
-		"<button class='green' name='state' value='on'>Allumer</button>"
-		"<button class='red' name='state' value='off'>Éteindre</button>"
-		"</form>"
-		"<p><a class='button yellow' href='/'>Retour accueil</a></p>";
+	static const esp01_tpl_op_t TPL_PAGE_LED[] = {
+		ESP01_TPL_LIT(HTML_DOC_START),
+		ESP01_TPL_LIT(HTML_TITLE_START),
+		ESP01_TPL_LIT(PAGE_LED_TITLE),
+		ESP01_TPL_LIT(HTML_TITLE_END_STYLE_START),
+		ESP01_TPL_LIT(PAGE_CSS),
+		ESP01_TPL_LIT(CSS_PAGE_LED_SPECIFIC),
+		ESP01_TPL_LIT(HTML_STYLE_END_HEAD_BODY_CARD_START),
+		ESP01_TPL_LIT("<h1>Contrôle de la LED</h1><p>État actuel : <b style='color:"),
+		ESP01_TPL_VAR(TPL_VAR_LED_COLOR),
+		ESP01_TPL_LIT("'>"),
+		ESP01_TPL_VAR(TPL_VAR_LED_TEXT),
+		ESP01_TPL_LIT("</b></p>"
+					  "<form method='get' action='/led'>"
+					  "<button class='green' name='state' value='on'>Allumer</button>"
+					  "<button class='red' name='state' value='off'>Éteindre</button>"
+					  "</form>"
+					  "<p><a class='button yellow' href='/'>Retour accueil</a></p>"),
+		ESP01_TPL_LIT(HTML_CARD_END_BODY_END),
+		ESP01_TPL_END()};
 
 	// Traitement des paramètres GET pour contrôler la LED
-	if (req && req->query_string[0]) // Vérifie si des paramètres GET sont présents dans la requête
+	esp01_http_kv_t state;													 // Paramètre "state" (vue dans la requête)
+	if (req && esp01_http_kv_find(req->query_string, req->query_len, "state", &state)) // Vérifie si le paramètre GET "state" est présent
 	{
-		if (strstr(req->query_string, "state=on"))							// Si le paramètre "state=on" est trouvé dans la requête
+		if (esp01_http_kv_equals(state.value, state.value_len, "on"))		// Si "state=on"
+		{
 			HAL_GPIO_WritePin(LED_GPIO_PORT, LED_GPIO_PIN, GPIO_PIN_SET);	// Allume la LED
-		else if (strstr(req->query_string, "state=off"))					// Si le paramètre "state=off" est trouvé dans la requête
+		}
+		else if (esp01_http_kv_equals(state.value, state.value_len, "off")) // Si "state=off"
+		{
 			HAL_GPIO_WritePin(LED_GPIO_PORT, LED_GPIO_PIN, GPIO_PIN_RESET); // Éteint la LED
+		}
+		esp01_http_cache_invalidate("/status");								// La page de statut affiche l'état de la LED
+		push_led_state();														// Clients WebSocket prévenus
 	}
-	GPIO_PinState led = HAL_GPIO_ReadPin(LED_GPIO_PORT, LED_GPIO_PIN); // Lit l'état actuel de la LED
+	page_ctx_t ctx = {0};										   // Contexte de rendu
+	ctx.led = HAL_GPIO_ReadPin(LED_GPIO_PORT, LED_GPIO_PIN); // Lit l'état actuel de la LED
 
-	char html[2048];					 // Tampon pour générer la page HTML
-	char *ptr = html;					 // Pointeur pour écrire dans le tampon HTML
-	char *end_ptr = html + sizeof(html); // Pointeur de fin pour éviter les débordements
-
-	if (esp01_check_buffer_size(strlen(ptr) + 256, end_ptr - ptr) != ESP01_OK) // Vérifie si le tampon est assez grand
-		return;																   // Si non, on sort de la fonction
-
-	ptr += snprintf(ptr, end_ptr - ptr, "%s%s%s%s", HTML_DOC_START, HTML_TITLE_START, PAGE_LED_TITLE, HTML_TITLE_END_STYLE_START);
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", PAGE_CSS);
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", CSS_PAGE_LED_SPECIFIC);
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", HTML_STYLE_END_HEAD_BODY_CARD_START);
-
-	ptr += snprintf(ptr, end_ptr - ptr,
-					BODY_PAGE_LED,
-					(led == GPIO_PIN_SET) ? "#28a745" : "#dc3545",
-					(led == GPIO_PIN_SET) ? "allumée" : "éteinte");
-
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", HTML_CARD_END_BODY_END);
+	ESP01_Status_t st = esp01_http_send_template(conn_id, 200, "text/html; charset=UTF-8", TPL_PAGE_LED, page_var_cb, NULL, &ctx); // Envoie la page
+	printf("[TEST][INFO] Sortie de page_led, réponse envoyée sur conn_id=%d, statut=%s\r\n", conn_id, esp01_get_error_string(st));
+}
 
-	printf("[TEST][INFO] Sortie de page_led, réponse envoyée sur conn_id=%d, taille=%d\r\n", conn_id, (int)strlen(html));
-	esp01_send_http_response(conn_id, 200, "text/html; charset=UTF-8", html, strlen(html));
+// Échappe les caractères spéciaux HTML (< > & " ') d'une chaîne reçue du client
+// La copie s'arrête avant une entité qui ne tiendrait pas : le résultat reste toujours sûr
+static void html_escape(const char *src, char *dst, size_t dst_size)
+{
+	size_t n = 0; // Octets écrits dans dst
+	for (; *src; ++src)
+	{
+		const char *ent = NULL; // Entité de remplacement
+		switch (*src)
+		{
+		case '<':
+			ent = "&lt;";
+			break;
+		case '>':
+			ent = "&gt;";
+			break;
+		case '&':
+			ent = "&amp;";
+			break;
+		case '"':
+			ent = "&quot;";
+			break;
+		case '\'':
+			ent = "&#39;";
+			break;
+		default:
+			break;
+		}
+		size_t len = ent ? strlen(ent) : 1;
+		if (n + len >= dst_size) // Plus de place (terminateur compris)
+		{
+			break;
+		}
+		if (ent)
+		{
+			memcpy(dst + n, ent, len);
+		}
+		else
+		{
+			dst[n] = *src;
+		}
+		n += len;
+	}
+	dst[n] = '\0';
 }
 
 // --- Page Test GET ("/testget") ---
@@ -280,28 +385,22 @@ static void page_testget(int conn_id, const http_parsed_request_t *req)
 	int nb_lignes = 0, max_lignes = 8;
 
 	// Affiche les paramètres GET reçus dans la requête
-	if (req && req->query_string[0])
+	if (req && req->query_len > 0)
 	{
-		char query_copy[256];
-		strncpy(query_copy, req->query_string, sizeof(query_copy) - 1);
-		query_copy[sizeof(query_copy) - 1] = '\0';
+		esp01_http_kv_iter_t it;										  // Itérateur sur la query string (sans copie)
+		esp01_http_kv_t kv;												  // Paire clé/valeur courante
+		esp01_http_kv_iter_init(&it, req->query_string, req->query_len); // Démarre au premier paramètre
 
-		char *token = strtok(query_copy, "&");
-		while (token && nb_lignes < max_lignes)
+		while (nb_lignes < max_lignes && esp01_http_kv_next(&it, &kv))
 		{
-			char *eq = strchr(token, '=');
-			char row[128];
-			if (eq)
-			{
-				*eq = '\0';
-				const char *key = token;
-				const char *val = eq + 1;
-				snprintf(row, sizeof(row), "<div class='param'><span class='paramname'>%s :</span> <span class='paramval'>%s</span></div>", key, val);
-			}
-			else
-			{
-				snprintf(row, sizeof(row), "<div class='param'><span class='paramname'>%s :</span> <span class='paramval'></span></div>", token);
-			}
+			char key[32], val[48];
+			esp01_http_kv_decode(kv.key, kv.key_len, key, sizeof(key));		// Décode la clé (%XX, '+')
+			esp01_http_kv_decode(kv.value, kv.value_len, val, sizeof(val)); // Décode la valeur
+			char key_html[96], val_html[160];
+			html_escape(key, key_html, sizeof(key_html)); // Clé et valeur fournies par le client : échappées avant insertion
+			html_escape(val, val_html, sizeof(val_html));
+			char row[352];
+			snprintf(row, sizeof(row), "<div class='param'><span class='paramname'>%s :</span> <span class='paramval'>%s</span></div>", key_html, val_html);
 			// Concaténation sécurisée avec vérification d'espace restant
 			size_t current_len = strlen(params_html);				   // Longueur actuelle du HTML des paramètres
 			size_t space_left = sizeof(params_html) - current_len - 1; // -1 pour \0
@@ -313,8 +412,7 @@ static void page_testget(int conn_id, const http_parsed_request_t *req)
 			{
 				break; // Arrêter si plus d'espace
 			}
-			nb_lignes++;			   // Incrémente le compteur de lignes
-			token = strtok(NULL, "&"); // Passe au paramètre suivant
+			nb_lignes++; // Incrémente le compteur de lignes
 		}
 	}
 	else // Si aucun paramètre GET n'est reçu
@@ -360,103 +458,176 @@ static void page_status(int conn_id, const http_parsed_request_t *req)
 		return;																  // Si non, on sort de la fonction
 	printf("[TEST][INFO] Entrée dans page_status (conn_id=%d)\r\n", conn_id); // Affiche l'entrée dans la page de statut
 
-	const char PAGE_STATUS_TITLE[] = "Statut Serveur STM32"; // Titre de la page de statut
-	const char CSS_PAGE_STATUS_SPECIFIC[] =					 // CSS spécifique à la page de statut
+	static const char PAGE_STATUS_TITLE[] = "Statut Serveur STM32"; // Titre de la page de statut
+	static const char CSS_PAGE_STATUS_SPECIFIC[] =					// CSS spécifique à la page de statut
 		"table{margin:2em auto 1em auto;border-collapse:collapse;box-shadow:0 2px 8px #e0f5d8;background:#fff;}"
 		"th,td{padding:0.4em 1em;border:1px solid #e0f5d8;font-size:1em;}"
 		"th{background:#ffe066;color:#3a5d23;}"
 		"a.button{display:inline-block;padding:1em 2em;margin:1em 0.5em;background:#388e3c;color:#fff;text-decoration:none;border-radius:8px;font-size:1.1em;transition:background 0.2s,border 0.2s;box-shadow:0 2px 8px #e0f5d8;border:2px solid #388e3c;}"
 		"a.button.green{background:#28a745;border-color:#28a745;color:#fff;";
-
-	char html[2048];					 // Tampon pour générer la page HTML
-	char *ptr = html;					 // Pointeur pour écrire dans le tampon HTML
-	char *end_ptr = html + sizeof(html); // Pointeur de fin pour éviter les débordements
+	static const esp01_tpl_op_t TPL_PAGE_STATUS[] = {
+		ESP01_TPL_LIT(HTML_DOC_START),
+		ESP01_TPL_LIT(HTML_TITLE_START),
+		ESP01_TPL_LIT(PAGE_STATUS_TITLE),
+		ESP01_TPL_LIT(HTML_TITLE_END_STYLE_START),
+		ESP01_TPL_LIT(PAGE_CSS),
+		ESP01_TPL_LIT(CSS_PAGE_STATUS_SPECIFIC),
+		ESP01_TPL_LIT(HTML_STYLE_END_HEAD_BODY_CARD_START),
+		ESP01_TPL_LIT("<h1>Serveur STM32</h1><table><tr><th>IP serveur</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_IP),
+		ESP01_TPL_LIT("</td></tr><tr><th>Port serveur</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_PORT),
+		ESP01_TPL_LIT("</td></tr><tr><th>LED</th><td style='color:"),
+		ESP01_TPL_VAR(TPL_VAR_LED_COLOR),
+		ESP01_TPL_LIT("'>"),
+		ESP01_TPL_VAR(TPL_VAR_LED_TEXT),
+		ESP01_TPL_LIT("</td></tr><tr><th>Connexions actives</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_ACTIVE_COUNT),
+		ESP01_TPL_LIT("</td></tr></table>"
+					  "<h2>Connexions TCP</h2>"
+					  "<table><tr><th>ID</th><th>Dernière activité (ms)</th><th>IP client</th><th>Port client</th></tr>"),
+		ESP01_TPL_LOOP(TPL_LOOP_CONNECTIONS), // Une ligne par connexion active
+		ESP01_TPL_LIT("<tr><td>"),
+		ESP01_TPL_VAR(TPL_VAR_CONN_ID),
+		ESP01_TPL_LIT("</td><td>"),
+		ESP01_TPL_VAR(TPL_VAR_CONN_IDLE),
+		ESP01_TPL_LIT("</td><td>"),
+		ESP01_TPL_VAR(TPL_VAR_CONN_IP),
+		ESP01_TPL_LIT("</td><td>"),
+		ESP01_TPL_VAR(TPL_VAR_CONN_PORT),
+		ESP01_TPL_LIT("</td></tr>"),
+		ESP01_TPL_ENDLOOP(),
+		ESP01_TPL_VAR(TPL_VAR_NO_CONN),
+		ESP01_TPL_LIT("</table>"
+					  "<h2>Statistiques HTTP</h2>"
+					  "<table><tr><th>Requêtes reçues</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_STAT_REQUESTS),
+		ESP01_TPL_LIT("</td></tr><tr><th>Réponses envoyées</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_STAT_RESPONSES),
+		ESP01_TPL_LIT("</td></tr><tr><th>Succès</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_STAT_SUCCESS),
+		ESP01_TPL_LIT("</td></tr><tr><th>Échecs</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_STAT_FAILED),
+		ESP01_TPL_LIT("</td></tr><tr><th>Temps moyen (ms)</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_STAT_AVG_MS),
+		ESP01_TPL_LIT("</td></tr></table>"),
+		ESP01_TPL_INCLUDE(TPL_FOOTER_HOME),
+		ESP01_TPL_END()};
 
 	char ip[32] = "N/A";								  // Tampon pour l'adresse IP du serveur
 	if (esp01_get_current_ip(ip, sizeof(ip)) != ESP01_OK) // Récupère l'adresse IP actuelle du module ESP01
 		strncpy(ip, "Erreur", sizeof(ip) - 1);			  // Si échec, met "Erreur" dans le tampon
 
-	GPIO_PinState led = HAL_GPIO_ReadPin(LED_GPIO_PORT, LED_GPIO_PIN); // Lit l'état de la LED embarquée
-
-	const esp01_stats_t *stats = &g_stats;									   // Récupère les statistiques du serveur
-	if (esp01_check_buffer_size(strlen(ptr) + 256, end_ptr - ptr) != ESP01_OK) // Vérifie si le tampon est assez grand
-		return;																   // Si non, on sort de la fonction
-
-	ptr += snprintf(ptr, end_ptr - ptr, "%s%s%s%s", HTML_DOC_START, HTML_TITLE_START, PAGE_STATUS_TITLE, HTML_TITLE_END_STYLE_START); // Début du document HTML, titre et début du style
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", PAGE_CSS);																			  // Ajoute le CSS commun
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", CSS_PAGE_STATUS_SPECIFIC);															  // Ajoute le CSS spécifique à la page de statut
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", HTML_STYLE_END_HEAD_BODY_CARD_START);													  // Fin du style, début du body et de la card
-	// Génération du contenu de la page de statut
-	ptr += snprintf(ptr, end_ptr - ptr,
-					"<h1>Serveur STM32</h1>"
-					"<table>"
-					"<tr><th>IP serveur</th><td>%s</td></tr>"
-					"<tr><th>Port serveur</th><td>%u</td></tr>"
-					"<tr><th>LED</th><td style='color:%s'>%s</td></tr>"
-					"<tr><th>Connexions actives</th><td>%d</td></tr>"
-					"</table>",
-					ip,
-					g_server_port,
-					(led == GPIO_PIN_SET) ? "#28a745" : "#dc3545",
-					(led == GPIO_PIN_SET) ? "allumée" : "éteinte",
-					esp01_get_active_connection_count());
-	// Affiche les informations de connexion TCP
-	ptr += snprintf(ptr, end_ptr - ptr,
-					"<h2>Connexions TCP</h2>"
-					"<table><tr><th>ID</th><th>Dernière activité (ms)</th><th>IP client</th><th>Port client</th></tr>");
-	int nb_affichees = 0;						 // Compteur de connexions affichées
-	for (int i = 0; i < g_connection_count; ++i) // Parcourt toutes les connexions actives
+	page_ctx_t ctx = {0};										   // Contexte de rendu
+	ctx.ip = ip;												   // Adresse IP du serveur
+	ctx.led = HAL_GPIO_ReadPin(LED_GPIO_PORT, LED_GPIO_PIN); // Lit l'état de la LED embarquée
+
+	ESP01_Status_t st = esp01_http_send_template(conn_id, 200, "text/html; charset=UTF-8", TPL_PAGE_STATUS, page_var_cb, page_loop_cb, &ctx); // Envoie la page
+	printf("[TEST][INFO] Sortie de page_status, réponse envoyée sur conn_id=%d, statut=%s\r\n", conn_id, esp01_get_error_string(st));	   // Affiche le statut de l'envoi
+}
+
+// --- WebSocket ("/ws") et Server-Sent Events ("/events") ---
+// Pousse l'état de la LED à tous les clients connectés (sans rechargement de page).
+static void push_led_state(void)
+{
+	const char *state = HAL_GPIO_ReadPin(LED_GPIO_PORT, LED_GPIO_PIN) == GPIO_PIN_SET ? "{\"led\":true}" : "{\"led\":false}";
+	esp01_ws_broadcast_text(state);
+	esp01_sse_broadcast("led", state);
+}
+
+// Ouverture d'un flux SSE : état courant envoyé aussitôt (y compris après une reconnexion).
+static void sse_led_event(int conn_id, esp01_sse_event_t event, uint32_t last_event_id)
+{
+	if (event == ESP01_SSE_EVT_OPEN)
 	{
-		if (esp01_is_connection_active(i)) // Vérifie si la connexion est active
+		printf("[TEST][INFO] Flux SSE ouvert sur conn_id=%d (Last-Event-ID=%lu)\r\n", conn_id, (unsigned long)last_event_id);
+		esp01_sse_send(conn_id, "led", HAL_GPIO_ReadPin(LED_GPIO_PORT, LED_GPIO_PIN) == GPIO_PIN_SET ? "{\"led\":true}" : "{\"led\":false}");
+	}
+}
+
+// Évènements d'un client WebSocket : état initial à l'ouverture, commande "on"/"off" en texte.
+static void ws_led_event(int conn_id, esp01_ws_event_t event, const uint8_t *data, size_t len)
+{
+	if (event == ESP01_WS_EVT_OPEN)
+	{
+		printf("[TEST][INFO] WebSocket ouvert sur conn_id=%d\r\n", conn_id);
+		esp01_ws_send_text(conn_id, HAL_GPIO_ReadPin(LED_GPIO_PORT, LED_GPIO_PIN) == GPIO_PIN_SET ? "{\"led\":true}" : "{\"led\":false}");
+	}
+	else if (event == ESP01_WS_EVT_TEXT)
+	{
+		if (esp01_http_kv_equals((const char *)data, len, "on"))
+		{
+			HAL_GPIO_WritePin(LED_GPIO_PORT, LED_GPIO_PIN, GPIO_PIN_SET);
+		}
+		else if (esp01_http_kv_equals((const char *)data, len, "off"))
 		{
-			const connection_info_t *c = &g_connections[i]; // Récupère les informations de la connexion
-			ptr += snprintf(ptr, end_ptr - ptr,
-							"<tr><td>%d</td><td>%lu</td><td>%s</td><td>%u</td></tr>",
-							c->conn_id,
-							(unsigned long)(HAL_GetTick() - c->last_activity),
-							c->client_ip[0] ? c->client_ip : "N/A",
-							c->client_port); // Affiche les informations de la connexion
-			nb_affichees++;					 // Incrémente le compteur de connexions affichées
+			HAL_GPIO_WritePin(LED_GPIO_PORT, LED_GPIO_PIN, GPIO_PIN_RESET);
 		}
+		else
+		{
+			return;
+		}
+		esp01_http_cache_invalidate("/status");
+		push_led_state();
 	}
-	if (nb_affichees == 0) // Si aucune connexion active n'a été trouvée
+	else if (event == ESP01_WS_EVT_CLOSE)
 	{
-		ptr += snprintf(ptr, end_ptr - ptr, "<tr><td colspan='4'><i>Aucune connexion active</i></td></tr>"); // Affiche un message indiquant qu'il n'y a pas de connexions actives
+		printf("[TEST][INFO] WebSocket fermé sur conn_id=%d\r\n", conn_id);
 	}
-	ptr += snprintf(ptr, end_ptr - ptr, "</table>"); // Termine la table des connexions TCP
-
-	ptr += snprintf(ptr, end_ptr - ptr,
-					"<h2>Statistiques HTTP</h2>"
-					"<table>"
-					"<tr><th>Requêtes reçues</th><td>%lu</td></tr>"
-					"<tr><th>Réponses envoyées</th><td>%lu</td></tr>"
-					"<tr><th>Succès</th><td>%lu</td></tr>"
-					"<tr><th>Échecs</th><td>%lu</td></tr>"
-					"<tr><th>Temps moyen (ms)</th><td>%lu</td></tr>"
-					"</table>",
-					(unsigned long)stats->total_requests,
-					(unsigned long)stats->response_count,
-					(unsigned long)stats->successful_responses,
-					(unsigned long)stats->failed_responses,
-					(unsigned long)stats->avg_response_time_ms); // Affiche les statistiques HTTP
-
-	ptr += snprintf(ptr, end_ptr - ptr, "<a class='button green' href='/'>Accueil</a>"); // Bouton pour revenir à la page d'accueil
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", HTML_CARD_END_BODY_END);					 // Termine la card et le body du document HTML
-
-	printf("[TEST][INFO] Sortie de page_status, réponse envoyée sur conn_id=%d, taille=%d\r\n", conn_id, (int)strlen(html)); // Affiche la taille de la réponse
-	esp01_send_http_response(conn_id, 200, "text/html; charset=UTF-8", html, strlen(html));									 // Envoie la page générée au client
 }
 
-// Structure pour les informations système
-typedef struct
+// --- API JSON ("/api/status") ---
+// Même contenu que la page de statut, écrit champ par champ dans la réponse (écrivain JSON en flux, sans snprintf préalable).
+static void page_api_status(int conn_id, const http_parsed_request_t *req)
 {
-	char at_version[64];	// Version du firmware AT du module ESP01
-	char stm32_type[32];	// Type de carte STM32 (L1, L4, F1, F4, F7, H7)
-	char wifi_mode[8];		// Mode WiFi (STA ou AP)
-	const char *wifi_ssid;	// SSID du réseau WiFi configuré
-	uint16_t server_port;	// Port du serveur web embarqué
-	const char *multi_conn; // Indique si les connexions multiples sont activées (Oui/Non)
-} system_info_t;			// Structure pour stocker les informations système
+	(void)req;
+	char ip[32] = "N/A";								  // Tampon pour l'adresse IP du serveur
+	if (esp01_get_current_ip(ip, sizeof(ip)) != ESP01_OK) // Récupère l'adresse IP actuelle du module ESP01
+	{
+		esp01_safe_strcpy(ip, sizeof(ip), "Erreur");
+	}
+
+	esp01_http_stream_t out;		// Réponse en flux (chunked)
+	esp01_json_writer_t json;		// Écrivain JSON sur le flux
+	if (esp01_http_stream_begin(&out, conn_id, 200, "application/json") != ESP01_OK)
+	{
+		return;
+	}
+	esp01_http_json_init(&json, &out);
+
+	esp01_json_object_begin(&json, NULL);
+	esp01_json_string(&json, "ip", ip);
+	esp01_json_uint(&json, "port", g_server_port);
+	esp01_json_bool(&json, "led", HAL_GPIO_ReadPin(LED_GPIO_PORT, LED_GPIO_PIN) == GPIO_PIN_SET);
+	esp01_json_float(&json, "uptime_s", HAL_GetTick() / 1000.0f, 1);
+	esp01_json_array_begin(&json, "connections");
+	for (int i = 0; i < ESP01_MAX_CONNECTIONS; i++)
+	{
+		if (!g_connections[i].is_active)
+		{
+			continue;
+		}
+		esp01_json_object_begin(&json, NULL);
+		esp01_json_int(&json, "id", g_connections[i].conn_id);
+		esp01_json_string(&json, "ip", g_connections[i].client_ip[0] ? g_connections[i].client_ip : NULL);
+		esp01_json_uint(&json, "port", g_connections[i].client_port);
+		esp01_json_uint(&json, "idle_ms", HAL_GetTick() - g_connections[i].last_activity);
+		esp01_json_object_end(&json);
+	}
+	esp01_json_array_end(&json);
+	esp01_json_object_begin(&json, "stats");
+	esp01_json_uint(&json, "requests", g_stats.total_requests);
+	esp01_json_uint(&json, "responses", g_stats.response_count);
+	esp01_json_uint(&json, "success", g_stats.successful_responses);
+	esp01_json_uint(&json, "failed", g_stats.failed_responses);
+	esp01_json_uint(&json, "avg_ms", g_stats.avg_response_time_ms);
+	esp01_json_object_end(&json);
+	esp01_json_object_end(&json);
+
+	ESP01_Status_t st = esp01_json_finish(&json);
+	esp01_http_stream_end(&out);
+	printf("[TEST][INFO] /api/status envoyé sur conn_id=%d, %u octets JSON, statut=%s\r\n", conn_id, (unsigned)json.len, esp01_get_error_string(st));
+}
 
 // Fonction pour collecter les informations système
 static void collect_system_info(system_info_t *info)
@@ -516,34 +687,102 @@ static void collect_system_info(system_info_t *info)
 	info->multi_conn = (ESP01_MULTI_CONNECTION) ? "Oui" : "Non"; // Indique si les connexions multiples sont activées (Oui/Non)
 }
 
-// Fonction pour rendre une section HTML avec table
-static int render_html_section(char *buffer, size_t buffer_size, const char *title,
-							   const char **labels, const char **values, int row_count)
+// Callback des boucles de template : sélectionne la index-ième connexion active
+static bool page_loop_cb(uint8_t loop_id, uint16_t index, void *ctx)
 {
-	char *ptr = buffer;					  // Pointeur pour écrire dans le tampon
-	char *end_ptr = buffer + buffer_size; // Pointeur de fin pour éviter les débordements
-	int written = 0;					  // Compteur de caractères écrits
-
-	// Titre de la section
-	written = snprintf(ptr, end_ptr - ptr, "<h%d>%s</h%d><table>",
-					   (title[0] == 'I') ? 1 : 2, title, (title[0] == 'I') ? 1 : 2); // Écrit le titre de la section et ouvre la table
-	ptr += written;																	 // Avance le pointeur de tampon
+	page_ctx_t *page = (page_ctx_t *)ctx;
+	if (loop_id != TPL_LOOP_CONNECTIONS || !page) // Seule boucle connue
+	{
+		return false;
+	}
 
-	// Lignes de la table
-	for (int i = 0; i < row_count; i++) // Parcourt les étiquettes et valeurs
+	for (int i = 0; i < g_connection_count; ++i) // Parcourt toutes les connexions
 	{
-		int row_len = snprintf(ptr, end_ptr - ptr,
-							   "<tr><th>%s</th><td>%s</td></tr>",
-							   labels[i], values[i]); // Écrit une ligne de la table avec l'étiquette et la valeur
-		ptr += row_len;								  // Avance le pointeur de tampon
-		written += row_len;							  // Incrémente le compteur de caractères écrits
+		if (esp01_is_connection_active(i) && index-- == 0) // index-ième connexion active
+		{
+			page->conn_slot = i; // Mémorise la connexion pour les variables de la boucle
+			return true;
+		}
 	}
+	return false; // Fin de la boucle
+}
 
-	// Fermeture de la table
-	int end_len = snprintf(ptr, end_ptr - ptr, "</table>"); // Écrit la fermeture de la table
-	written += end_len;										// Incrémente le compteur de caractères écrits
+// Callback des variables de template : écrit chaque valeur directement dans la réponse
+static void page_var_cb(esp01_http_stream_t *out, uint8_t var_id, uint16_t index, void *ctx)
+{
+	(void)index;
+	const page_ctx_t *page = (const page_ctx_t *)ctx;
+	const connection_info_t *c = &g_connections[page->conn_slot]; // Connexion courante (boucle)
+	bool led_on = (page->led == GPIO_PIN_SET);
 
-	return written; // Retourne le nombre total de caractères écrits dans le tampon
+	switch (var_id)
+	{
+	case TPL_VAR_LED_COLOR:
+		esp01_http_stream_printf(out, "%s", led_on ? "#28a745" : "#dc3545");
+		break;
+	case TPL_VAR_LED_TEXT:
+		esp01_http_stream_printf(out, "%s", led_on ? "allumée" : "éteinte");
+		break;
+	case TPL_VAR_IP:
+		esp01_http_stream_printf(out, "%s", page->ip ? page->ip : "N/A");
+		break;
+	case TPL_VAR_PORT:
+		esp01_http_stream_printf(out, "%u", page->sys ? page->sys->server_port : g_server_port);
+		break;
+	case TPL_VAR_ACTIVE_COUNT:
+		esp01_http_stream_printf(out, "%d", esp01_get_active_connection_count());
+		break;
+	case TPL_VAR_CONN_ID:
+		esp01_http_stream_printf(out, "%d", c->conn_id);
+		break;
+	case TPL_VAR_CONN_IDLE:
+		esp01_http_stream_printf(out, "%lu", (unsigned long)(HAL_GetTick() - c->last_activity));
+		break;
+	case TPL_VAR_CONN_IP:
+		esp01_http_stream_printf(out, "%s", c->client_ip[0] ? c->client_ip : "N/A");
+		break;
+	case TPL_VAR_CONN_PORT:
+		esp01_http_stream_printf(out, "%u", c->client_port);
+		break;
+	case TPL_VAR_NO_CONN:
+		if (esp01_get_active_connection_count() == 0) // Message seulement si la boucle est vide
+		{
+			esp01_http_stream_printf(out, "%s", "<tr><td colspan='4'><i>Aucune connexion active</i></td></tr>");
+		}
+		break;
+	case TPL_VAR_STAT_REQUESTS:
+		esp01_http_stream_printf(out, "%lu", (unsigned long)g_stats.total_requests);
+		break;
+	case TPL_VAR_STAT_RESPONSES:
+		esp01_http_stream_printf(out, "%lu", (unsigned long)g_stats.response_count);
+		break;
+	case TPL_VAR_STAT_SUCCESS:
+		esp01_http_stream_printf(out, "%lu", (unsigned long)g_stats.successful_responses);
+		break;
+	case TPL_VAR_STAT_FAILED:
+		esp01_http_stream_printf(out, "%lu", (unsigned long)g_stats.failed_responses);
+		break;
+	case TPL_VAR_STAT_AVG_MS:
+		esp01_http_stream_printf(out, "%lu", (unsigned long)g_stats.avg_response_time_ms);
+		break;
+	case TPL_VAR_AT_VERSION:
+		esp01_http_stream_printf(out, "%s", page->sys->at_version);
+		break;
+	case TPL_VAR_STM32_TYPE:
+		esp01_http_stream_printf(out, "%s", page->sys->stm32_type);
+		break;
+	case TPL_VAR_WIFI_MODE:
+		esp01_http_stream_printf(out, "%s", page->sys->wifi_mode);
+		break;
+	case TPL_VAR_WIFI_SSID:
+		esp01_http_stream_printf(out, "%s", page->sys->wifi_ssid);
+		break;
+	case TPL_VAR_MULTI_CONN:
+		esp01_http_stream_printf(out, "%s", page->sys->multi_conn);
+		break;
+	default:
+		break; // Variable inconnue : rien n'est écrit
+	}
 }
 
 // --- Page Infos Système & Réseau ("/device") ---
@@ -556,55 +795,45 @@ static void page_device(int conn_id, const http_parsed_request_t *req)
 		return;																  // Si non, on sort de la fonction
 	printf("[TEST][INFO] Entrée dans page_device (conn_id=%d)\r\n", conn_id); // Affiche l'entrée dans la page d'informations système
 
-	const char PAGE_DEVICE_TITLE[] = "Infos Système & Réseau"; // Titre de la page d'informations système
-	const char CSS_PAGE_DEVICE_SPECIFIC[] =					   // CSS spécifique à la page d'informations système
+	static const char PAGE_DEVICE_TITLE[] = "Infos Système & Réseau"; // Titre de la page d'informations système
+	static const char CSS_PAGE_DEVICE_SPECIFIC[] =					  // CSS spécifique à la page d'informations système
 		"table{margin:2em auto 1em auto;border-collapse:collapse;box-shadow:0 2px 8px #e0f5d8;background:#fff;}"
 		"th,td{padding:0.4em 1em;border:1px solid #e0f5d8;font-size:1em;}"
 		"th{background:#ffe066;color:#3a5d23;}"
 		"a.button{display:inline-block;padding:1em 2em;margin:1em 0.5em;background:#388e3c;color:#fff;text-decoration:none;border-radius:8px;font-size:1.1em;transition:background 0.2s,border 0.2s;box-shadow:0 2px 8px #e0f5d8;border:2px solid #388e3c;}"
 		"a.button.green{background:#28a745;border-color:#28a745;color:#fff;";
+	static const esp01_tpl_op_t TPL_PAGE_DEVICE[] = {
+		ESP01_TPL_LIT(HTML_DOC_START),
+		ESP01_TPL_LIT(HTML_TITLE_START),
+		ESP01_TPL_LIT(PAGE_DEVICE_TITLE),
+		ESP01_TPL_LIT(HTML_TITLE_END_STYLE_START),
+		ESP01_TPL_LIT(PAGE_CSS),
+		ESP01_TPL_LIT(CSS_PAGE_DEVICE_SPECIFIC),
+		ESP01_TPL_LIT(HTML_STYLE_END_HEAD_BODY_CARD_START),
+		ESP01_TPL_LIT("<h1>Informations Système</h1><table><tr><th>Firmware ESP01</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_AT_VERSION),
+		ESP01_TPL_LIT("</td></tr><tr><th>Carte STM32</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_STM32_TYPE),
+		ESP01_TPL_LIT("</td></tr></table><h2>Configuration WiFi</h2><table><tr><th>Mode</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_WIFI_MODE),
+		ESP01_TPL_LIT("</td></tr><tr><th>SSID</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_WIFI_SSID),
+		ESP01_TPL_LIT("</td></tr></table><h2>Configuration Serveur</h2><table><tr><th>Port</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_PORT),
+		ESP01_TPL_LIT("</td></tr><tr><th>Multi-connexion</th><td>"),
+		ESP01_TPL_VAR(TPL_VAR_MULTI_CONN),
+		ESP01_TPL_LIT("</td></tr></table>"),
+		ESP01_TPL_INCLUDE(TPL_FOOTER_HOME),
+		ESP01_TPL_END()};
 
 	system_info_t sys_info;			// Structure pour stocker les informations système
 	collect_system_info(&sys_info); // Collecte les informations système
 
-	char html[2048];					 // Tampon pour générer la page HTML
-	html[0] = '\0';						 // Initialise le tampon à vide
-	char *ptr = html;					 // Pointeur pour écrire dans le tampon HTML
-	char *end_ptr = html + sizeof(html); // Pointeur de fin pour éviter les débordements
-
-	if (esp01_check_buffer_size(strlen(ptr) + 256, end_ptr - ptr) != ESP01_OK) // Vérifie si le tampon est assez grand
-		return;																   // Si non, on sort de la fonction
-
-	ptr += snprintf(ptr, end_ptr - ptr, "%s%s%s%s",
-					HTML_DOC_START, HTML_TITLE_START,
-					PAGE_DEVICE_TITLE, HTML_TITLE_END_STYLE_START);					// Début du document HTML, titre et début du style
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", PAGE_CSS);							// Ajoute le CSS commun
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", CSS_PAGE_DEVICE_SPECIFIC);			// Ajoute le CSS spécifique à la page d'informations système
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", HTML_STYLE_END_HEAD_BODY_CARD_START); // Fin du style, début du body et de la card
-
-	const char *sys_labels[] = {"Firmware ESP01", "Carte STM32"};		   // Étiquettes pour les informations système
-	const char *sys_values[] = {sys_info.at_version, sys_info.stm32_type}; // Valeurs pour les informations système
-	ptr += render_html_section(ptr, end_ptr - ptr, "Informations Système",
-							   sys_labels, sys_values, 2); // Rendu de la section Informations Système
-
-	const char *wifi_labels[] = {"Mode", "SSID"};						  // Étiquettes pour les informations WiFi
-	const char *wifi_values[] = {sys_info.wifi_mode, sys_info.wifi_ssid}; // Valeurs pour les informations WiFi
-	ptr += render_html_section(ptr, end_ptr - ptr, "Configuration WiFi",
-							   wifi_labels, wifi_values, 2); // Rendu de la section Configuration WiFi
-
-	char port_str[8];												  // Tampon pour le port du serveur
-	snprintf(port_str, sizeof(port_str), "%u", sys_info.server_port); // Convertit le port en chaîne de caractères
-
-	const char *server_labels[] = {"Port", "Multi-connexion"};	   // Étiquettes pour les informations du serveur
-	const char *server_values[] = {port_str, sys_info.multi_conn}; // Valeurs pour les informations du serveur
-	ptr += render_html_section(ptr, end_ptr - ptr, "Configuration Serveur",
-							   server_labels, server_values, 2); // Rendu de la section Configuration Serveur
-
-	ptr += snprintf(ptr, end_ptr - ptr, "<a class='button green' href='/'>Accueil</a>"); // Bouton pour revenir à la page d'accueil
-	ptr += snprintf(ptr, end_ptr - ptr, "%s", HTML_CARD_END_BODY_END);					 // Termine la card et le body du document HTML
+	page_ctx_t ctx = {0}; // Contexte de rendu
+	ctx.sys = &sys_info;  // Informations système
 
-	printf("[TEST][INFO] Sortie de page_device, réponse envoyée sur conn_id=%d, taille=%d\r\n", conn_id, (int)strlen(html)); // Affiche la taille de la réponse
-	esp01_send_http_response(conn_id, 200, "text/html; charset=UTF-8", html, strlen(html));									 // Envoie la page générée au client
+	ESP01_Status_t st = esp01_http_send_template(conn_id, 200, "text/html; charset=UTF-8", TPL_PAGE_DEVICE, page_var_cb, NULL, &ctx); // Envoie la page
+	printf("[TEST][INFO] Sortie de page_device, réponse envoyée sur conn_id=%d, statut=%s\r\n", conn_id, esp01_get_error_string(st));  // Affiche le statut de l'envoi
 }
 /* USER CODE END 0 */
 
@@ -717,6 +946,17 @@ int main(void)
 	esp01_add_route("/testget", page_testget);
 	printf("[TEST][INFO] Ajout route /device\r\n");
 	esp01_add_route("/device", page_device);
+	printf("[TEST][INFO] Ajout route /api/status\r\n");
+	esp01_add_route("/api/status", page_api_status);
+	printf("[TEST][INFO] Ajout route WebSocket /ws\r\n");
+	esp01_add_route_ws("/ws", ws_led_event);
+	printf("[TEST][INFO] Ajout route SSE /events\r\n");
+	esp01_add_route_sse("/events", sse_led_event);
+	esp01_http_route_set_cache("/status", 1000); // Rafraîchissements rapprochés servis sans requêtes AT
+	esp01_http_route_set_cache("/device", 2000);
+	esp01_http_enable_metrics(NULL); // Métriques Prometheus sur /metrics
+	esp01_http_set_rate_limit(5, 10, 20, 20, ESP01_HTTP_RL_REPLY); // 5 req/s par client (rafale 10), 20 req/s au total
+	esp01_http_set_link_policy(30000, 5000, 1); // Keep-alive 5 s, un lien gardé libre pour les nouveaux clients
 	HAL_Delay(500);
 
 	// 8. Vérification serveur ESP01